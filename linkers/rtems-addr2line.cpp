@@ -223,10 +223,16 @@ main (int argc, char* argv[])
       debug.load_types ();
       debug.load_functions ();
 
+      /*
+       * Look up the source of all the addresses at once.
+       */
+      std::vector < rld::dwarf::dwarf_address > locations;
+      std::vector < unsigned int >              addresses;
+      rld::strings                              paths;
+      std::vector < int >                       lines;
+
       for (int arg = 0; arg < argc; ++arg)
       {
-        rld::dwarf::dwarf_address location;
-
         if (rld::verbose ())
           std::cout << "address: " << argv[arg] << std::endl;
 
@@ -234,12 +240,17 @@ main (int argc, char* argv[])
          * Use the C routine as C++ does not have a way to automatically handle
          * different bases on the input.
          */
-        location = ::strtoul (argv[arg], 0, 0);
+        locations.push_back (::strtoul (argv[arg], 0, 0));
+        addresses.push_back (locations.back ());
+      }
 
-        std::string path;
-        int         line;
+      debug.get_sources (addresses, paths, lines);
 
-        debug.get_source (location, path, line);
+      for (size_t l = 0; l < locations.size (); ++l)
+      {
+        rld::dwarf::dwarf_address location = locations[l];
+        const std::string&        path = paths[l];
+        int                       line = lines[l];
 
         if (show_addresses)
         {
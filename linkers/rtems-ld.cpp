@@ -76,6 +76,7 @@ static struct option rld_opts[] = {
   { "one-file",    no_argument,            NULL,           's' },
   { "rtems",       required_argument,      NULL,           'r' },
   { "rtems-bsp",   required_argument,      NULL,           'B' },
+  { "jobs",        required_argument,      NULL,           'j' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -122,6 +123,7 @@ usage (int exit_code)
             << " -Wl,opts  : link compatible flags, ignored" << std::endl
             << " -r path   : RTEMS path (also --rtems)" << std::endl
             << " -B bsp    : RTEMS arch/bsp (also --rtems-bsp)" << std::endl
+            << " -j jobs   : number of jobs loading the files, default 1 (also --jobs)" << std::endl
             << "Output Formats:" << std::endl
             << " rap     - RTEMS application (LZ77, single image)" << std::endl
             << " elf     - ELF application (script, ELF files)" << std::endl
@@ -197,6 +199,7 @@ main (int argc, char* argv[])
     bool                 map = false;
     bool                 warnings = false;
     bool                 one_file = false;
+    unsigned int         jobs = 1;
 
     rld::set_cmdline (argc, argv);
 
@@ -204,7 +207,7 @@ main (int argc, char* argv[])
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hvwVMnsSb:E:o:O:L:l:c:e:d:u:C:W:R:P:r:B:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hvwVMnsSb:E:o:O:L:l:c:e:d:u:C:W:R:P:r:B:j:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -322,6 +325,15 @@ main (int argc, char* argv[])
           rtems_arch_bsp = optarg;
           break;
 
+        case 'j':
+          {
+            char* end;
+            jobs = ::strtoul (optarg, &end, 10);
+            if (*end != '\0' || jobs == 0)
+              throw rld::error ("invalid number of jobs", "options");
+          }
+          break;
+
         case '?':
           usage (3);
           break;
@@ -403,6 +415,8 @@ main (int argc, char* argv[])
     /*
      * Add the object files to the cache.
      */
+    cache.set_jobs (jobs);
+    base.set_jobs (jobs);
     cache.add (objects);
 
     /*
@@ -468,9 +482,13 @@ main (int argc, char* argv[])
       cache.archives_begin ();
 
       /*
-       * Load the symbol table.
+       * Load the symbol table. A map lists all the symbols so load them all
+       * else only load the archive object files the resolver needs.
        */
-      cache.load_symbols (symbols);
+      if (map)
+        cache.load_symbols (symbols);
+      else
+        cache.load_symbols_lazy (symbols);
 
       /*
        * Map ?
@@ -488,9 +506,19 @@ main (int argc, char* argv[])
          * This structure allows us to add different operations with the same
          * structure.
          */
-        rld::files::object_list dependents;
+        rld::files::object_list    dependents;
+        rld::resolver::dependences graph;
         rld::resolver::resolve (dependents, cache,
-                                base_symbols, symbols, undefined);
+                                base_symbols, symbols, undefined, graph);
+
+        /*
+         * The map lists why each archive object file is linked.
+         */
+        if (map)
+        {
+          std::cout << "Dependences:" << std::endl;
+          rld::resolver::output (std::cout, graph);
+        }
 
         /**
          * Output the file.
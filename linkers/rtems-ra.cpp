@@ -70,6 +70,7 @@ static struct option rld_opts[] = {
   { "add-rap",     required_argument,      NULL,           'A' },
   { "replace-rap", required_argument,      NULL,           'r' },
   { "delete-rap",  required_argument,      NULL,           'd' },
+  { "jobs",        required_argument,      NULL,           'j' },
   { NULL,          0,                      NULL,            0 }
 };
 
@@ -106,6 +107,7 @@ usage (int exit_code)
             << " -A        : Add rap files (also --Add-rap)" << std::endl
             << " -r        : replace rap files (also --replace-rap)" << std::endl
             << " -d        : delete rap files (also --delete-rap)" << std::endl
+            << " -j jobs   : number of jobs loading the files, default 1 (also --jobs)" << std::endl
             << " -Wl,opts  : link compatible flags, ignored" << std::endl
             << "Output Formats:" << std::endl
             << " ra      - RTEMS archive container of rap files" << std::endl;
@@ -169,6 +171,7 @@ main (int argc, char* argv[])
     std::string             output = "a.ra";
     bool                    standard_libs = true;
     bool                    convert = true;
+    unsigned int            jobs = 1;
     rld::files::object_list dependents;
 
     libpaths.push_back (".");
@@ -176,7 +179,7 @@ main (int argc, char* argv[])
 
     while (true)
     {
-      int opt = ::getopt_long (argc, argv, "hVvnSa:p:L:l:o:C:E:c:R:W:A:r:d:", rld_opts, NULL);
+      int opt = ::getopt_long (argc, argv, "hVvnSa:p:L:l:o:C:E:c:R:W:A:r:d:j:", rld_opts, NULL);
       if (opt < 0)
         break;
 
@@ -270,6 +273,15 @@ main (int argc, char* argv[])
           /* ignore linker compatiable flags */
           break;
 
+        case 'j':
+          {
+            char* end;
+            jobs = ::strtoul (optarg, &end, 10);
+            if (*end != '\0' || jobs == 0)
+              throw rld::error ("invalid number of jobs", "options");
+          }
+          break;
+
         case '?':
           usage (3);
           break;
@@ -334,6 +346,7 @@ main (int argc, char* argv[])
         /*
         * Open the cache.
         */
+        cache->set_jobs (jobs);
         cache->open ();
 
         /*
@@ -448,6 +461,7 @@ main (int argc, char* argv[])
         /*
         * Open the cache.
         */
+        cache->set_jobs (jobs);
         cache->open ();
 
         /*
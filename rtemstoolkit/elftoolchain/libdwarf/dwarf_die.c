@@ -79,6 +79,8 @@ dwarf_siblingof_b(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die *ret_die,
 
 	ds = is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
 	cu = is_info ? dbg->dbg_cu_current : dbg->dbg_tu_current;
+	if (die != NULL)
+		cu = die->die_cu;
 
 	if (cu == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_DIE_NO_CU_CONTEXT);
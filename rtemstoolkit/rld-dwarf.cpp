@@ -1887,23 +1887,76 @@ namespace rld
     {
       if (!addr_lines_.empty () && inside (addr))
       {
-        address last_loc;
-        for (auto& loc : addr_lines_)
+        /*
+         * The lines are sorted so search for the first line at or after the
+         * address. If the line is not at the address the address is part of
+         * the line before it.
+         */
+        auto loc = std::lower_bound (addr_lines_.begin (),
+                                     addr_lines_.end (),
+                                     addr,
+                                     [] (const address& line,
+                                         const dwarf_address addr) {
+                                       return line.location () < addr;
+                                     });
+        if (loc != addr_lines_.end ())
         {
-          if (addr <= loc.location ())
-          {
-            if (addr == loc.location ())
-              addr_line = loc;
-            else
-              addr_line = last_loc;
-            return addr_line.valid ();
-          }
-          last_loc = loc;
+          if (addr == loc->location ())
+            addr_line = *loc;
+          else if (loc == addr_lines_.begin ())
+            addr_line = address ();
+          else
+            addr_line = *(loc - 1);
+          return addr_line.valid ();
         }
       }
       return false;
     }
 
+    void
+    compilation_unit::get_sources (const std::vector < dwarf_address >& addrs,
+                                   addresses&                          addr_lines)
+    {
+      addr_lines.clear ();
+      addr_lines.resize (addrs.size ());
+
+      auto loc = addr_lines_.begin ();
+
+      for (size_t a = 0; a < addrs.size (); ++a)
+      {
+        dwarf_address addr = addrs[a];
+
+        if (!inside (addr))
+          continue;
+
+        /*
+         * The addresses are sorted so the search continues from the line
+         * found for the last address.
+         */
+        loc = std::lower_bound (loc,
+                                addr_lines_.end (),
+                                addr,
+                                [] (const address& line,
+                                    const dwarf_address addr) {
+                                  return line.location () < addr;
+                                });
+        if (loc == addr_lines_.end ())
+          break;
+
+        if (addr == loc->location ())
+          addr_lines[a] = *loc;
+        else if (loc != addr_lines_.begin ())
+          addr_lines[a] = *(loc - 1);
+      }
+    }
+
+    void
+    compilation_unit::pc_range (dwarf_unsigned& low, dwarf_unsigned& high) const
+    {
+      low = pc_low_;
+      high = pc_high_;
+    }
+
     const addresses& compilation_unit::get_addresses () const
     {
       return addr_lines_;
@@ -2053,6 +2106,7 @@ namespace rld
           std::cout << "dwarf::end: " << name () << std::endl;
 
         cus.clear ();
+        build_cu_index ();
 
         ::dwarf_finish (debug, 0);
         if (elf_)
@@ -2138,6 +2192,8 @@ namespace rld
 
         cu_offset = cu_next_offset;
       }
+
+      build_cu_index ();
     }
 
     void
@@ -2177,10 +2233,13 @@ namespace rld
 
       address match;
 
-      for (auto& cu : cus)
+      std::vector < compilation_unit* > found;
+      find_cus (addr, found);
+
+      for (auto cu : found)
       {
         address line;
-        r = cu.get_source (addr, line);
+        r = cu->get_source (addr, line);
         if (r)
         {
           if (!match.valid ())
@@ -2204,6 +2263,74 @@ namespace rld
       return r;
     }
 
+    void
+    file::get_sources (const std::vector < unsigned int >& addrs,
+                       rld::strings&                       source_files,
+                       std::vector < int >&                source_lines)
+    {
+      std::vector < size_t > order (addrs.size ());
+      for (size_t a = 0; a < addrs.size (); ++a)
+        order[a] = a;
+      std::stable_sort (order.begin (),
+                        order.end (),
+                        [&addrs] (size_t lhs, size_t rhs) {
+                          return addrs[lhs] < addrs[rhs];
+                        });
+
+      std::vector < dwarf_address > sorted (addrs.size ());
+      for (size_t a = 0; a < addrs.size (); ++a)
+        sorted[a] = addrs[order[a]];
+
+      /*
+       * Each CU looks up the addresses it is inside. The CUs are searched in
+       * the order they are loaded so the match is the one get_source finds.
+       */
+      addresses                     matches (sorted.size ());
+      std::vector < dwarf_address > cu_addrs;
+      addresses                     lines;
+
+      for (auto& cu : cus)
+      {
+        dwarf_unsigned low;
+        dwarf_unsigned high;
+        cu.pc_range (low, high);
+
+        auto first = std::lower_bound (sorted.begin (), sorted.end (), low);
+        auto last = std::lower_bound (first, sorted.end (), high);
+        if (first == last)
+          continue;
+
+        cu_addrs.assign (first, last);
+        cu.get_sources (cu_addrs, lines);
+
+        size_t offset = first - sorted.begin ();
+        for (size_t l = 0; l < lines.size (); ++l)
+        {
+          address& match = matches[offset + l];
+          address& line = lines[l];
+          if (line.valid ())
+          {
+            if (!match.valid ())
+              match = line;
+            else if (match.is_an_end_sequence () || !line.is_an_end_sequence ())
+              match = line;
+          }
+        }
+      }
+
+      source_files.assign (addrs.size (), "unknown");
+      source_lines.assign (addrs.size (), -1);
+
+      for (size_t a = 0; a < matches.size (); ++a)
+      {
+        if (matches[a].valid ())
+        {
+          source_files[order[a]] = matches[a].path ();
+          source_lines[order[a]] = matches[a].line ();
+        }
+      }
+    }
+
     bool
     file::get_function (const unsigned int addr,
                         std::string&       name)
@@ -2270,6 +2397,75 @@ namespace rld
       return debug;
     }
 
+    void
+    file::build_cu_index ()
+    {
+      cu_table.clear ();
+      for (auto& cu : cus)
+        cu_table.push_back (&cu);
+
+      cu_order.resize (cu_table.size ());
+      for (size_t c = 0; c < cu_table.size (); ++c)
+        cu_order[c] = c;
+
+      std::vector < dwarf_unsigned > highs (cu_table.size ());
+      std::vector < dwarf_unsigned > lows (cu_table.size ());
+      for (size_t c = 0; c < cu_table.size (); ++c)
+        cu_table[c]->pc_range (lows[c], highs[c]);
+
+      std::stable_sort (cu_order.begin (),
+                        cu_order.end (),
+                        [&lows] (size_t lhs, size_t rhs) {
+                          return lows[lhs] < lows[rhs];
+                        });
+
+      cu_lows.resize (cu_order.size ());
+      cu_highs.resize (cu_order.size ());
+      for (size_t c = 0; c < cu_order.size (); ++c)
+      {
+        cu_lows[c] = lows[cu_order[c]];
+        cu_highs[c] = highs[cu_order[c]];
+        if (c > 0 && cu_highs[c - 1] > cu_highs[c])
+          cu_highs[c] = cu_highs[c - 1];
+      }
+    }
+
+    void
+    file::find_cus (const dwarf_address                addr,
+                    std::vector < compilation_unit* >& found)
+    {
+      found.clear ();
+
+      /*
+       * A CU loaded after the index was built is not indexed so search all
+       * of them.
+       */
+      if (cu_table.size () != cus.size ())
+      {
+        for (auto& cu : cus)
+          found.push_back (&cu);
+        return;
+      }
+
+      /*
+       * Walk back from the last CU starting at or before the address while a
+       * CU before it can still end after the address.
+       */
+      std::vector < size_t > indices;
+      size_t c = std::upper_bound (cu_lows.begin (), cu_lows.end (), addr) -
+        cu_lows.begin ();
+      while (c > 0 && cu_highs[c - 1] > addr)
+      {
+        --c;
+        if (cu_table[cu_order[c]]->inside (addr))
+          indices.push_back (cu_order[c]);
+      }
+
+      std::sort (indices.begin (), indices.end ());
+      for (auto i : indices)
+        found.push_back (cu_table[i]);
+    }
+
     compilation_units&
     file::get_cus ()
     {
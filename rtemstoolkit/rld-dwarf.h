@@ -720,6 +720,20 @@ namespace rld
       bool get_source (const dwarf_address addr,
                        address&            addr_line);
 
+      /**
+       * Get the source and line for each address in a list sorted from low to
+       * high. The lines are found in a single pass over the CU's lines. An
+       * address that does not match has an invalid line.
+       */
+      void get_sources (const std::vector < dwarf_address >& addrs,
+                        addresses&                          addr_lines);
+
+      /**
+       * The range of addresses the CU is inside, the high address is not
+       * inside the CU.
+       */
+      void pc_range (dwarf_unsigned& low, dwarf_unsigned& high) const;
+
       /**
        * Get the functions.
        */
@@ -861,6 +875,16 @@ namespace rld
                        std::string&       source_file,
                        int&               source_line);
 
+      /**
+       * Get the source locations of a list of addresses. The addresses do not
+       * need to be sorted. The location of each address is the one
+       * get_source finds and each CU's lines are searched once for all the
+       * addresses.
+       */
+      void get_sources (const std::vector < unsigned int >& addresses,
+                        rld::strings&                       source_files,
+                        std::vector < int >&                source_lines);
+
       /**
        * Get the producer sources from the compilation units.
        */
@@ -923,11 +947,33 @@ namespace rld
        */
       void check (const char* where) const;
 
+      /**
+       * Index the compilation units by the range of addresses they are
+       * inside.
+       */
+      void build_cu_index ();
+
+      /**
+       * Find the compilation units an address is inside. The compilation
+       * units are in the order they are loaded.
+       */
+      void find_cus (const dwarf_address                addr,
+                     std::vector < compilation_unit* >& found);
+
       dwarf           debug;   ///< The libdwarf debug data
       rld::elf::file* elf_;    ///< The libelf reference used to access the
                                ///  DWARF data.
 
       compilation_units cus;   ///< Image's compilation units
+
+      std::vector < compilation_unit* > cu_table; ///< The CUs in load order.
+      std::vector < size_t >            cu_order; ///< The CU table sorted by
+                                                  ///  PC low.
+      std::vector < dwarf_unsigned >    cu_lows;  ///< The PC low of the CUs
+                                                  ///  in PC low order.
+      std::vector < dwarf_unsigned >    cu_highs; ///< The highest PC high of
+                                                  ///  the CUs up to each CU
+                                                  ///  in PC low order.
     };
 
   }
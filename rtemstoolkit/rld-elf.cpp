@@ -24,6 +24,8 @@
 
 #include <string.h>
 
+#include <mutex>
+
 #include <rld.h>
 
 namespace rld
@@ -48,6 +50,14 @@ namespace rld
     static unsigned int elf_object_machinetype = EM_NONE;
     static unsigned int elf_object_datatype = ELFDATANONE;
 
+    /**
+     * The objects in an archive share the archive's libelf descriptor and
+     * libelf's begin and end calls are not thread safe. Serialise the calls
+     * that touch shared libelf state so different objects can be worked on
+     * different threads.
+     */
+    static std::mutex libelf_lock;
+
     /**
      * A single place to initialise the libelf library. This must be called
      * before any libelf API calls are made.
@@ -182,7 +192,17 @@ namespace rld
       if (shdr.sh_type != SHT_NULL)
       {
         name_ = file_.get_string (shdr.sh_name);
-        data_ = ::elf_getdata (scn, 0);
+
+        /*
+         * The bytes of a program section in a file being read need no
+         * translation so view them in the file's image rather than have libelf
+         * copy them.
+         */
+        if (!file_.is_writable () &&
+            ((shdr.sh_type == SHT_PROGBITS) || (shdr.sh_type == SHT_NOBITS)))
+          data_ = ::elf_rawdata (scn, 0);
+        else
+          data_ = ::elf_getdata (scn, 0);
         if (!data_)
         {
           data_ = ::elf_rawdata (scn, 0);
@@ -457,7 +477,7 @@ namespace rld
     void
     file::begin (const std::string& name__, int fd__, const bool writable_)
     {
-      begin (name__, fd__, writable_, 0, 0);
+      begin (name__, fd__, writable_, 0, 0, 0, 0);
     }
 
     void
@@ -468,7 +488,16 @@ namespace rld
       if (archive_.writable)
         throw rld::error ("archive is writable", "elf:file:begin");
 
-      begin (name__, archive_.fd_, false, &archive_, offset);
+      begin (name__, archive_.fd_, false, &archive_, offset, 0, 0);
+    }
+
+    void
+    file::begin (const std::string& name__,
+                 int                fd__,
+                 const void*        image,
+                 size_t             size)
+    {
+      begin (name__, fd__, false, 0, 0, image, size);
     }
 
     #define rld_archive_fhdr_size (60)
@@ -478,7 +507,9 @@ namespace rld
                  int                fd__,
                  const bool         writable_,
                  file*              archive_,
-                 off_t              offset_)
+                 off_t              offset_,
+                 const void*        image,
+                 size_t             size)
     {
       if (fd__ < 0)
         throw rld::error ("No file descriptor", "elf:file:begin");
@@ -496,26 +527,36 @@ namespace rld
         throw rld::error ("Cannot write into archives directly",
                           "elf:file:begin");
 
-      libelf_initialise ();
+      elf* elf__;
 
-      /*
-       * Is this image part of an archive ?
-       */
-      if (archive_)
       {
-        ssize_t offset = offset_ - rld_archive_fhdr_size;
-        if (::elf_rand (archive_->elf_, offset) != offset)
-          libelf_error ("rand: " + archive_->name_);
-      }
+        std::lock_guard < std::mutex > guard (libelf_lock);
 
-      /*
-       * Note, the elf passed is either the archive or NULL.
-       */
-      elf* elf__ = ::elf_begin (fd__,
-                                writable_ ? ELF_C_WRITE : ELF_C_READ,
-                                archive_ ? archive_->elf_ : 0);
-      if (!elf__)
-        libelf_error ("begin: " + name__);
+        libelf_initialise ();
+
+        /*
+         * Is this image part of an archive ?
+         */
+        if (archive_)
+        {
+          ssize_t offset = offset_ - rld_archive_fhdr_size;
+          if (::elf_rand (archive_->elf_, offset) != offset)
+            libelf_error ("rand: " + archive_->name_);
+        }
+
+        /*
+         * An image in memory is used in place. Note, the elf passed is either
+         * the archive or NULL.
+         */
+        if (image)
+          elf__ = ::elf_memory ((char*) image, size);
+        else
+          elf__ = ::elf_begin (fd__,
+                               writable_ ? ELF_C_WRITE : ELF_C_READ,
+                               archive_ ? archive_->elf_ : 0);
+        if (!elf__)
+          libelf_error ("begin: " + name__);
+      }
 
       if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
         std::cout << "elf::begin: " << elf__ << ' ' << name__ << std::endl;
@@ -600,6 +641,7 @@ namespace rld
           if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
             std::cout << "libelf::end: " << elf_
                       << ' ' << name_ << std::endl;
+          std::lock_guard < std::mutex > guard (libelf_lock);
           ::elf_end (elf_);
           elf_ = 0;
         }
@@ -805,6 +847,13 @@ namespace rld
 
         get_sections (symbol_secs, SHT_SYMTAB);
 
+        size_t total = 0;
+        for (sections::iterator si = symbol_secs.begin ();
+             si != symbol_secs.end ();
+             ++si)
+          total += (*si)->entries ();
+        symbols.reserve (total);
+
         for (sections::iterator si = symbol_secs.begin ();
              si != symbol_secs.end ();
              ++si)
@@ -1228,6 +1277,8 @@ namespace rld
     void
     check_file(const file& file)
     {
+      std::lock_guard < std::mutex > guard (libelf_lock);
+
       if (elf_object_machinetype == EM_NONE)
         elf_object_machinetype = file.machinetype ();
       else if (file.machinetype () != elf_object_machinetype)
@@ -438,6 +438,21 @@ namespace rld
        */
       void begin (const std::string& name, file& archive, off_t offset);
 
+      /**
+       * Begin using an ELF file image held in memory, for example a mapped
+       * file or a member of a mapped archive. The image is not copied and
+       * must remain valid until the file is ended.
+       *
+       * @param name The full name of the file.
+       * @param fd The file descriptor of the file holding the image.
+       * @param image The ELF file's image.
+       * @param size The size of the image.
+       */
+      void begin (const std::string& name,
+                  int                fd,
+                  const void*        image,
+                  size_t             size);
+
       /**
        * End using the ELF file.
        */
@@ -670,12 +685,16 @@ namespace rld
        * @param writable The file is writeable. It cannot be part of an archive.
        * @param archive The archive's ELF handle or 0 if not an archive.
        * @param offset The offset of the ELF file in the archive if elf is non-zero.
+       * @param image The ELF file's image in memory or 0 to read the file.
+       * @param size The size of the image in memory.
        */
       void begin (const std::string& name,
                   int                fd,
                   const bool         writable,
                   file*              archive,
-                  off_t              offset);
+                  off_t              offset,
+                  const void*        image,
+                  size_t             size);
 
       /**
        * Check if the file is usable. Throw an exception if not.
@@ -19,6 +19,7 @@
 #endif
 
 #include <algorithm>
+#include <mutex>
 
 #include <errno.h>
 #include <fcntl.h>
@@ -28,11 +29,13 @@
 #include <unistd.h>
 
 #include <rld.h>
+#include <rld-threads.h>
 
 #if __WIN32__
 #define CREATE_MODE (S_IRUSR | S_IWUSR)
 #define OPEN_FLAGS  (O_BINARY)
 #else
+#include <sys/mman.h>
 #define CREATE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH)
 #define OPEN_FLAGS  (0)
 #endif
@@ -230,7 +233,10 @@ namespace rld
         fd_ (-1),
         symbol_refs (0),
         writable (false),
-        remove (false)
+        remove (false),
+        mapped (0),
+        mapped_size (0),
+        position (0)
     {
     }
 
@@ -240,7 +246,10 @@ namespace rld
         fd_ (-1),
         symbol_refs (0),
         writable (false),
-        remove (false)
+        remove (false),
+        mapped (0),
+        mapped_size (0),
+        position (0)
     {
     }
 
@@ -249,7 +258,10 @@ namespace rld
         fd_ (-1),
         symbol_refs (0),
         writable (false),
-        remove (false)
+        remove (false),
+        mapped (0),
+        mapped_size (0),
+        position (0)
     {
     }
 
@@ -286,6 +298,8 @@ namespace rld
         std::cerr << "error: rld::files::image:::~image: unhandled exception"
                   << std::endl;
       }
+
+      unmap ();
     }
 
     void
@@ -341,6 +355,7 @@ namespace rld
         --references_;
         if (references_ == 0)
         {
+          unmap ();
           ::close (fd_);
           fd_ = -1;
           if (writable && remove)
@@ -358,6 +373,24 @@ namespace rld
     ssize_t
     image::read (void* buffer_, size_t size)
     {
+      if (!writable)
+      {
+        /*
+         * Read only images are read from the mapping.
+         */
+        size_t         length;
+        const uint8_t* base = map (length);
+        size_t         at = name_.offset () + position;
+        if (at > length)
+          at = length;
+        if (size > (length - at))
+          size = length - at;
+        if (size)
+          ::memcpy (buffer_, base + at, size);
+        position += size;
+        return size;
+      }
+
       uint8_t* buffer = static_cast <uint8_t*> (buffer_);
       size_t   have_read = 0;
       size_t   to_read = size;
@@ -396,7 +429,9 @@ namespace rld
     void
     image::seek (off_t offset)
     {
-      if (::lseek (fd (), name_.offset () + offset, SEEK_SET) < 0)
+      if (!writable)
+        position = offset;
+      else if (::lseek (fd (), name_.offset () + offset, SEEK_SET) < 0)
         throw rld::error (strerror (errno), "lseek:" + name ().path ());
     }
 
@@ -414,6 +449,80 @@ namespace rld
       return size == (size_t) write (buffer, size);
     }
 
+    const uint8_t*
+    image::map (size_t& size)
+    {
+      if (!mapped)
+      {
+        if (writable)
+          throw rld::error ("Cannot map a writable image", "map:" + name ().path ());
+        if (fd_ < 0)
+          throw rld::error ("Not open", "map:" + name ().path ());
+
+        struct stat sb;
+        if (::fstat (fd_, &sb) < 0)
+          throw rld::error (::strerror (errno), "map:" + name ().path ());
+
+        if (sb.st_size > 0)
+        {
+#if __WIN32__
+          /*
+           * No mmap so read the image into memory.
+           */
+          mapped = new uint8_t[sb.st_size];
+          if ((::lseek (fd_, 0, SEEK_SET) < 0) ||
+              (::read (fd_, mapped, sb.st_size) != sb.st_size))
+          {
+            delete [] mapped;
+            mapped = 0;
+            throw rld::error (::strerror (errno), "map:" + name ().path ());
+          }
+#else
+          void* m = ::mmap (0, sb.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+          if (m == MAP_FAILED)
+            throw rld::error (::strerror (errno), "map:" + name ().path ());
+          mapped = static_cast <uint8_t*> (m);
+#endif
+          mapped_size = sb.st_size;
+
+          if (rld::verbose () >= RLD_VERBOSE_TRACE_FILE)
+            std::cout << "image::map: " << name ().full ()
+                      << " size:" << mapped_size << std::endl;
+        }
+      }
+
+      size = mapped_size;
+      return mapped;
+    }
+
+    const uint8_t*
+    image::view (off_t offset, size_t size)
+    {
+      size_t         length;
+      const uint8_t* base = map (length);
+      size_t         at = name_.offset () + offset;
+      if ((offset < 0) || (at > length) || (size > (length - at)))
+        throw rld::error ("View past the end of the image",
+                          "view:" + name ().path ());
+      return base + at;
+    }
+
+    void
+    image::unmap ()
+    {
+      if (mapped)
+      {
+#if __WIN32__
+        delete [] mapped;
+#else
+        ::munmap (mapped, mapped_size);
+#endif
+        mapped = 0;
+        mapped_size = 0;
+      }
+      position = 0;
+    }
+
     const file&
     image::name () const
     {
@@ -488,10 +597,7 @@ namespace rld
            */
 
           size_t l = size < COPY_FILE_BUFFER_SIZE ? size : COPY_FILE_BUFFER_SIZE;
-          ssize_t r = ::read (in.fd (), buffer, l);
-
-          if (r < 0)
-            throw rld::error (::strerror (errno), "reading: " + in.name ().full ());
+          ssize_t r = in.read (buffer, l);
 
           if (r == 0)
           {
@@ -578,7 +684,9 @@ namespace rld
     {
       if (references () == 1)
       {
-        elf ().begin (name ().full (), fd ());
+        size_t         size;
+        const uint8_t* data = map (size);
+        elf ().begin (name ().full (), fd (), data, size);
 
         /*
          * Make sure it is an archive.
@@ -646,8 +754,16 @@ namespace rld
           {
             case ' ':
               /*
-               * Symbols table. Ignore the table.
+               * Symbols table. Index the symbols.
                */
+              read_symbol_index (offset + rld_archive_fhdr_size, size, 4);
+              break;
+            case 'S':
+              /*
+               * The symbols table of a 64bit archive.
+               */
+              if (::memcmp (header, "/SYM64/", 7) == 0)
+                read_symbol_index (offset + rld_archive_fhdr_size, size, 8);
               break;
             case '/':
               /*
@@ -728,6 +844,24 @@ namespace rld
       }
     }
 
+    bool
+    archive::has_symbol_index () const
+    {
+      return !symbol_index.empty ();
+    }
+
+    object*
+    archive::find_object (const std::string& name) const
+    {
+      symbol_offsets::const_iterator si = symbol_index.find (name);
+      if (si == symbol_index.end ())
+        return 0;
+      member_objects::const_iterator mi = members.find ((*si).second);
+      if (mi == members.end ())
+        return 0;
+      return (*mi).second;
+    }
+
     bool
     archive::operator< (const archive& rhs) const
     {
@@ -748,6 +882,55 @@ namespace rld
       return true;
     }
 
+    void
+    archive::read_symbol_index (off_t offset, size_t size, size_t word_size)
+    {
+      if (size < word_size)
+        throw rld::error ("Invalid symbol table", "symbol-index:" + name ().path ());
+
+      const uint8_t* table = view (offset, size);
+
+      /*
+       * The count and offsets are big endian.
+       */
+      auto word = [&] (size_t at) -> uint64_t {
+        uint64_t value = 0;
+        for (size_t b = 0; b < word_size; ++b)
+          value = (value << 8) | table[at + b];
+        return value;
+      };
+
+      uint64_t count = word (0);
+
+      if (count > ((size / word_size) - 1))
+        throw rld::error ("Invalid symbol table count", "symbol-index:" + name ().path ());
+
+      size_t names = (count + 1) * word_size;
+
+      symbol_index.clear ();
+
+      for (uint64_t s = 0; s < count; ++s)
+      {
+        size_t end = names;
+        while ((end < size) && (table[end] != '\0'))
+          ++end;
+        if (end == size)
+          throw rld::error ("Invalid symbol table name", "symbol-index:" + name ().path ());
+
+        /*
+         * Keep the first member if more than one defines the symbol.
+         */
+        std::string symbol ((const char*) &table[names], end - names);
+        symbol_index.insert (symbol_offsets::value_type (symbol,
+                                                         word ((s + 1) * word_size)));
+        names = end + 1;
+      }
+
+      if (rld::verbose () >= RLD_VERBOSE_DETAILS)
+        std::cout << "archive::symbol-index: " << name ().path ()
+                  << ": symbols: " << symbol_index.size () << std::endl;
+    }
+
     void
     archive::add_object (objects& objs, const char* path, off_t offset, size_t size)
     {
@@ -761,8 +944,10 @@ namespace rld
       if (rld::verbose () >= RLD_VERBOSE_FULL_DEBUG)
         std::cout << "archive::add-object: " << str << std::endl;
 
-      file n (name ().path (), str, offset, size);
-      objs[n.full()] = new object (*this, n);
+      file    n (name ().path (), str, offset, size);
+      object* obj = new object (*this, n);
+      objs[n.full()] = obj;
+      members[offset - rld_archive_fhdr_size] = obj;
     }
 
     void
@@ -1050,9 +1235,16 @@ namespace rld
                   << ((char*) (archive_ ? "yes" : "no")) << std::endl;
 
       if (archive_)
-        elf ().begin (name ().full (), archive_->elf(), name ().offset ());
+        elf ().begin (name ().full (), fd (),
+                      view (0, name ().size ()), name ().size ());
+      else if (is_writable ())
+        elf ().begin (name ().full (), fd (), true);
       else
-        elf ().begin (name ().full (), fd (), is_writable ());
+      {
+        size_t         size;
+        const uint8_t* data = map (size);
+        elf ().begin (name ().full (), fd (), data, size);
+      }
 
       /*
        * Cannot be an archive.
@@ -1247,6 +1439,14 @@ namespace rld
       return image::fd ();
     }
 
+    const uint8_t*
+    object::map (size_t& size)
+    {
+      if (archive_)
+        return archive_->map (size);
+      return image::map (size);
+    }
+
     void
     object::symbol_referenced ()
     {
@@ -1358,7 +1558,8 @@ namespace rld
     }
 
     cache::cache ()
-      : opened (false)
+      : opened (false),
+        jobs_ (1)
     {
     }
 
@@ -1404,10 +1605,18 @@ namespace rld
           delete (*oi).second;
         for (archives::iterator ai = archives_.begin (); ai != archives_.end (); ++ai)
           delete (*ai).second;
+        order_.clear ();
+        loaded_.clear ();
         opened = false;
       }
     }
 
+    void
+    cache::set_jobs (unsigned int jobs)
+    {
+      jobs_ = jobs == 0 ? 1 : jobs;
+    }
+
     void
     cache::add (const std::string& path)
     {
@@ -1427,10 +1636,14 @@ namespace rld
     void
     cache::add_libraries (path::paths& paths__)
     {
-      for (path::paths::iterator pi = paths__.begin();
-           pi != paths__.end();
-           ++pi)
-        input (*pi);
+      if (opened)
+      {
+        collect_object_files (paths__);
+        for (path::paths::iterator pi = paths__.begin();
+             pi != paths__.end();
+             ++pi)
+          archive_begin (*pi);
+      }
     }
 
     void
@@ -1484,53 +1697,98 @@ namespace rld
     void
     cache::collect_object_files ()
     {
-      for (path::paths::iterator ni = paths_.begin (); ni != paths_.end (); ++ni)
-        collect_object_files (*ni);
+      collect_object_files (paths_);
     }
 
     void
     cache::collect_object_files (const std::string& path)
     {
-      archive* ar = new archive (path);
+      path::paths paths;
+      paths.push_back (path);
+      collect_object_files (paths);
+    }
 
-      if (ar->is_valid ())
+    void
+    cache::collect_object_files (const path::paths& paths)
+    {
+      /*
+       * Each path is checked and an archive's object files collected on a job
+       * of its own. The results are added to the cache in the order of the
+       * paths so the cache is the same for any number of jobs.
+       */
+      struct collected
       {
-        try
+        archive* ar;
+        objects  objs;
+
+        collected ()
+          : ar (0)
+        {
+        }
+      };
+
+      std::vector < collected > found (paths.size ());
+
+      auto collect = [&] (size_t p) {
+        const std::string& path = paths[p];
+        archive*           ar = new archive (path);
+
+        if (ar->is_valid ())
         {
+          found[p].ar = ar;
           ar->open ();
-          ar->load_objects (objects_);
+          ar->load_objects (found[p].objs);
           ar->close ();
-          archives_[path] = ar;
         }
-        catch (...)
+        else
         {
           delete ar;
-          throw;
-        }
-      }
-      else
-      {
-        delete ar;
-        object* obj = new object (path);
-        if (!obj->name ().exists ())
-        {
-          delete obj;
-          throw rld::error ("'" + path + "', Not found or a regular file.",
-                            "file-check");
-        }
-        try
-        {
+          object* obj = new object (path);
+          if (!obj->name ().exists ())
+          {
+            delete obj;
+            throw rld::error ("'" + path + "', Not found or a regular file.",
+                              "file-check");
+          }
+          found[p].objs[path] = obj;
           obj->open ();
           obj->begin ();
           obj->end ();
           obj->close ();
-          objects_[path] = obj;
         }
-        catch (...)
+      };
+
+      auto add = [&] (size_t p) {
+        collected& c = found[p];
+        for (objects::iterator oi = c.objs.begin (); oi != c.objs.end (); ++oi)
+          objects_[(*oi).first] = (*oi).second;
+        c.objs.clear ();
+        if (c.ar)
         {
-          delete obj;
-          throw;
+          archives_[paths[p]] = c.ar;
+          order_.push_back (paths[p]);
+          c.ar = 0;
         }
+      };
+
+      try
+      {
+        rld::threads::parallel_for (paths.size (), jobs_, collect, add);
+      }
+      catch (...)
+      {
+        /*
+         * Delete what has not been added. The objects first as they could
+         * depend on the archive.
+         */
+        for (size_t p = 0; p < found.size (); ++p)
+        {
+          collected& c = found[p];
+          for (objects::iterator oi = c.objs.begin (); oi != c.objs.end (); ++oi)
+            delete (*oi).second;
+          delete c.ar;
+        }
+        throw;
       }
     }
 
@@ -1541,23 +1799,114 @@ namespace rld
         std::cout << "cache:load-sym: object files: " << objects_.size ()
                   << std::endl;
 
+      object_list objs;
+      for (objects::iterator oi = objects_.begin ();
+           oi != objects_.end ();
+           ++oi)
+        objs.push_back ((*oi).second);
+
+      load_symbols (objs, symbols, local);
+
+      if (rld::verbose () >= RLD_VERBOSE_INFO)
+        std::cout << "cache:load-sym: symbols: " << symbols.size ()
+                  << std::endl;
+    }
+
+    void
+    cache::load_symbols_lazy (rld::symbols::table& symbols)
+    {
+      object_list objs;
+
       for (objects::iterator oi = objects_.begin ();
            oi != objects_.end ();
            ++oi)
       {
-        object* obj = (*oi).second;
-        obj->open ();
-        obj->begin ();
-        obj->load_symbols (symbols, local);
-        obj->end ();
-        obj->close ();
+        object*  obj = (*oi).second;
+        archive* ar = obj->get_archive ();
+        if (!ar || !ar->has_symbol_index ())
+          objs.push_back (obj);
       }
 
+      load_symbols (objs, symbols, false);
+
       if (rld::verbose () >= RLD_VERBOSE_INFO)
-        std::cout << "cache:load-sym: symbols: " << symbols.size ()
+        std::cout << "cache:load-sym: lazy: object files: " << objs.size ()
+                  << " of " << objects_.size ()
+                  << ", symbols: " << symbols.size ()
                   << std::endl;
     }
 
+    bool
+    cache::load_symbol (rld::symbols::table& symbols, const std::string& name)
+    {
+      for (path::paths::iterator pi = order_.begin ();
+           pi != order_.end ();
+           ++pi)
+      {
+        archive* ar = archives_[*pi];
+        object*  obj = ar->find_object (name);
+        if (obj)
+        {
+          if (loaded_.find (obj) != loaded_.end ())
+            return false;
+          if (rld::verbose () >= RLD_VERBOSE_INFO)
+            std::cout << "cache:load-sym: " << name
+                      << " ==> " << obj->name ().full () << std::endl;
+          object_list objs;
+          objs.push_back (obj);
+          load_symbols (objs, symbols, false);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void
+    cache::load_symbols (const object_list&   objs,
+                         rld::symbols::table& symbols,
+                         bool                 local)
+    {
+      std::vector < object* > pending;
+
+      for (object_list::const_iterator oi = objs.begin ();
+           oi != objs.end ();
+           ++oi)
+        if (loaded_.find (*oi) == loaded_.end ())
+          pending.push_back (*oi);
+
+      /*
+       * The jobs read each object file's ELF symbols into the object's own
+       * symbol list. The symbols are added to the table in the order of the
+       * list so the table is the same for any number of jobs. Opening and
+       * closing an object file in an archive references the archive and its
+       * mapping and is serialised.
+       */
+      std::mutex lock;
+
+      auto read = [&] (size_t o) {
+        object& obj = *pending[o];
+        {
+          std::lock_guard < std::mutex > guard (lock);
+          size_t size;
+          obj.open ();
+          obj.map (size);
+        }
+        obj.begin ();
+        obj.elf ().load_symbols ();
+      };
+
+      auto add = [&] (size_t o) {
+        object& obj = *pending[o];
+        obj.load_symbols (symbols, local);
+        obj.end ();
+        std::lock_guard < std::mutex > guard (lock);
+        obj.close ();
+        loaded_.insert (&obj);
+      };
+
+      rld::threads::parallel_for (pending.size (), jobs_, read, add);
+    }
+
     void
     cache::output_unresolved_symbols (std::ostream& out)
     {
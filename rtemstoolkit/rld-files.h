@@ -34,6 +34,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -307,6 +308,27 @@ namespace rld
        */
       virtual bool seek_write (off_t offset, const void* buffer, size_t size);
 
+      /**
+       * Map the image into memory. A read only image is mapped the first time
+       * it is read or viewed and the mapping is held until the image is
+       * closed. Reading a mapped image copies from the mapping rather than
+       * reading the file.
+       *
+       * @param size The size of the mapping.
+       * @return const uint8_t* The base of the mapping.
+       */
+      virtual const uint8_t* map (size_t& size);
+
+      /**
+       * View the image's data in place. The view is valid while the image is
+       * open. Writable images cannot be viewed.
+       *
+       * @param offset The offset in the image of the view.
+       * @param size The size of the view.
+       * @return const uint8_t* The image's data at the offset.
+       */
+      const uint8_t* view (off_t offset, size_t size);
+
       /**
        * The name of the image.
        *
@@ -398,6 +420,11 @@ namespace rld
 
     private:
 
+      /**
+       * Release the mapping of the image.
+       */
+      void unmap ();
+
       file      name_;       //< The name of the file.
       int       references_; //< The number of handles open.
       int       fd_;         //< The file descriptor of the archive.
@@ -405,6 +432,9 @@ namespace rld
       int       symbol_refs; //< The number of symbols references made.
       bool      writable;    //< The image is writable.
       bool      remove;      //< Remove the image on close if writable.
+      uint8_t*  mapped;      //< The image mapped into memory.
+      size_t    mapped_size; //< The size of the mapping.
+      off_t     position;    //< The read position in a mapped image.
     };
 
     /**
@@ -474,6 +504,26 @@ namespace rld
        */
       void load_objects (objects& objs);
 
+      /**
+       * Does the archive have a symbol index? The index is the GNU/SysV
+       * archive symbol table, the '/' or '/SYM64/' member, and is read by
+       * @ref load_objects.
+       *
+       * @retval true The archive has a symbol index.
+       * @retval false The archive has no symbol index.
+       */
+      bool has_symbol_index () const;
+
+      /**
+       * Find the object file that defines a symbol using the archive's
+       * symbol index. If more than one object defines the symbol the first
+       * in the index is returned.
+       *
+       * @param name The name of the symbol.
+       * @return object* The object file or 0 if not found.
+       */
+      object* find_object (const std::string& name) const;
+
       /**
        * Get the name.
        *
@@ -513,6 +563,18 @@ namespace rld
        */
       bool read_header (off_t offset, uint8_t* header);
 
+      /**
+       * Read the archive symbol table into the symbol index. The table is a
+       * count, the offset of the header of the member defining each symbol
+       * and then the symbol names. The count and offsets are big endian
+       * words of 4 bytes or, for the '/SYM64/' table, 8 bytes.
+       *
+       * @param offset The offset in the file of the table.
+       * @param size The size of the table.
+       * @param word_size The size of the count and offsets in bytes.
+       */
+      void read_symbol_index (off_t offset, size_t size, size_t word_size);
+
       /**
        * Add the object file from the archive to the object's container.
        *
@@ -552,6 +614,12 @@ namespace rld
        * Cannot assign using the assignment operator.
        */
       archive& operator= (const archive& rhs);
+
+      typedef std::map < const std::string, off_t > symbol_offsets;
+      typedef std::map < off_t, object* > member_objects;
+
+      symbol_offsets symbol_index; //< Symbol name to member header offset.
+      member_objects members;      //< Member header offset to object file.
     };
 
     /**
@@ -732,6 +800,12 @@ namespace rld
        */
       virtual int fd () const;
 
+      /**
+       * Map the image. An object file in an archive is a slice of the
+       * archive's mapping.
+       */
+      virtual const uint8_t* map (size_t& size);
+
       /**
        * A symbol in the image has been referenced.
        */
@@ -861,6 +935,13 @@ namespace rld
        */
       void close ();
 
+      /**
+       * Set the number of jobs used to collect the object files and to load
+       * their symbols. The default is one. The cache's contents and the
+       * symbol tables loaded do not depend on the number of jobs.
+       */
+      void set_jobs (unsigned int jobs);
+
       /**
        * Add a file path to the cache.
        */
@@ -907,6 +988,12 @@ namespace rld
        */
       void collect_object_files (const std::string& path);
 
+      /**
+       * Collect the object file names of the paths using the cache's jobs.
+       * The results are added to the cache in the order of the paths.
+       */
+      void collect_object_files (const path::paths& paths);
+
       /**
        * Load the symbols into the symbol table.
        *
@@ -915,6 +1002,29 @@ namespace rld
        */
       void load_symbols (symbols::table& symbols, bool locals = false);
 
+      /**
+       * Load the symbols of the object files that are not in an archive and
+       * of the object files in archives without a symbol index into the
+       * symbol table. The other object files in archives are loaded by @ref
+       * load_symbol when a symbol they define is needed.
+       *
+       * @param symbols The symbol table to load.
+       */
+      void load_symbols_lazy (symbols::table& symbols);
+
+      /**
+       * Load the symbols of the object file in an archive that defines a
+       * symbol into the symbol table. The archives are searched in the order
+       * they were added using their symbol index. Nothing is loaded if the
+       * object file's symbols are already loaded.
+       *
+       * @param symbols The symbol table to load.
+       * @param name The name of the symbol to find.
+       * @retval true An object file was loaded.
+       * @retval false No object file was loaded.
+       */
+      bool load_symbol (symbols::table& symbols, const std::string& name);
+
       /**
        * Output the unresolved symbol table to the output stream.
        */
@@ -983,10 +1093,25 @@ namespace rld
       virtual void input (const std::string& path);
 
     private:
-      path::paths paths_;    //< The names of the files to process.
-      archives    archives_; //< The archive files.
-      objects     objects_;  //< The object files.
-      bool        opened;    //< The cache is open.
+
+      /**
+       * Load the symbols of the object files not already loaded into the
+       * symbol table. The object files are read using the cache's jobs and
+       * their symbols are added to the table in the order of the list.
+       */
+      void load_symbols (const object_list& objs,
+                         symbols::table&    symbols,
+                         bool               local);
+
+      typedef std::set < object* > object_set;
+
+      path::paths  paths_;    //< The names of the files to process.
+      archives     archives_; //< The archive files.
+      path::paths  order_;    //< The archive files in the order added.
+      objects      objects_;  //< The object files.
+      object_set   loaded_;   //< The object files with symbols loaded.
+      bool         opened;    //< The cache is open.
+      unsigned int jobs_;     //< The number of jobs.
     };
 
     /**
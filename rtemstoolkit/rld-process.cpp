@@ -95,6 +95,7 @@ namespace rld
     const std::string
     temporary_files::get (const std::string& suffix, bool keep)
     {
+      std::lock_guard < std::mutex > guard (lock);
       char* temp = ::make_temp_file (suffix.c_str ());
 
       if (!temp)
@@ -121,6 +122,7 @@ namespace rld
     void
     temporary_files::erase (const std::string& name)
     {
+      std::lock_guard < std::mutex > guard (lock);
       for (tempfile_container::iterator tfi = tempfiles.begin ();
            tfi != tempfiles.end ();
            ++tfi)
@@ -137,6 +139,7 @@ namespace rld
     void
     temporary_files::keep (const std::string& name)
     {
+      std::lock_guard < std::mutex > guard (lock);
       for (tempfile_container::iterator tfi = tempfiles.begin ();
            tfi != tempfiles.end ();
            ++tfi)
@@ -152,6 +155,7 @@ namespace rld
     void
     temporary_files::clean_up ()
     {
+      std::lock_guard < std::mutex > guard (lock);
       for (tempfile_container::iterator tfi = tempfiles.begin ();
            tfi != tempfiles.end ();
            ++tfi)
@@ -407,6 +411,44 @@ namespace rld
       }
     }
 
+    /*
+     * Convert the status returned by libiberty to a status.
+     */
+    static status
+    exit_status (const std::string& pname, int s)
+    {
+      status _status;
+
+      if (rld::verbose (RLD_VERBOSE_TRACE))
+        std::cout << "execute: status: ";
+
+      if (WIFEXITED (s))
+      {
+        _status.type = status::normal;
+        _status.code = WEXITSTATUS (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << _status.code << std::endl;
+      }
+      else if (WIFSIGNALED (s))
+      {
+        _status.type = status::signal;
+        _status.code = WTERMSIG (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << "signal: " << _status.code << std::endl;
+      }
+      else if (WIFSTOPPED (s))
+      {
+        _status.type = status::stopped;
+        _status.code = WSTOPSIG (s);
+        if (rld::verbose (RLD_VERBOSE_TRACE))
+          std::cout << "stopped: " << _status.code << std::endl;
+      }
+      else
+        throw rld::error ("execute: " + pname, "unknown status returned");
+
+      return _status;
+    }
+
     status
     execute (const std::string& pname,
              const std::string& command,
@@ -457,36 +499,120 @@ namespace rld
       else if (err)
         throw rld::error ("execute: " + args[0], ::strerror (err));
 
-      status _status;
+      return exit_status (args[0], s);
+    }
 
-      if (rld::verbose (RLD_VERBOSE_TRACE))
-        std::cout << "execute: status: ";
+    stream::stream ()
+      : pex (0),
+        out (0),
+        copy (0)
+    {
+    }
 
-      if (WIFEXITED (s))
+    stream::~stream ()
+    {
+      if (pex)
+        ::pex_free (pex);
+    }
+
+    void
+    stream::open (const arg_container& args, const std::string& errname)
+    {
+      if (pex)
+        throw rld::error ("Already open", "stream open: " + name);
+
+      if (rld::verbose (RLD_VERBOSE_TRACE))
       {
-        _status.type = status::normal;
-        _status.code = WEXITSTATUS (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << _status.code << std::endl;
+        std::cout << "execute: ";
+        for (size_t a = 0; a < args.size (); ++a)
+          std::cout << args[a] << ' ';
+        std::cout << std::endl;
       }
-      else if (WIFSIGNALED (s))
+
+      name = args[0];
+
+      std::vector < const char* > cargs;
+
+      for (size_t a = 0; a < args.size (); ++a)
+        cargs.push_back (args[a].c_str ());
+      cargs.push_back (0);
+
+      int err = 0;
+
+      pex = ::pex_init (PEX_USE_PIPES, name.c_str (), 0);
+
+      const char* serr = ::pex_run (pex,
+                                    PEX_SEARCH,
+                                    name.c_str (),
+                                    (char* const*) &cargs[0],
+                                    0,
+                                    errname.c_str (),
+                                    &err);
+
+      if (serr)
+        throw rld::error ("execute: " + name, serr);
+      else if (err)
+        throw rld::error ("execute: " + name, ::strerror (err));
+
+      out = ::pex_read_output (pex, 0);
+      if (!out)
+        throw rld::error ("execute: " + name, "no output pipe");
+    }
+
+    void
+    stream::tee (tempfile& file)
+    {
+      file.open (true);
+      copy = &file;
+    }
+
+    void
+    stream::read_line (std::string& line)
+    {
+      line.clear ();
+      if (out)
       {
-        _status.type = status::signal;
-        _status.code = WTERMSIG (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << "signal: " << _status.code << std::endl;
+        while (::fgets (buf, sizeof (buf), out))
+        {
+          line.append (buf);
+          if (line[line.size () - 1] == '\n')
+            break;
+        }
+        if (::ferror (out))
+          throw rld::error (::strerror (errno), "stream read: " + name);
+        if (copy && !line.empty ())
+          copy->write (line);
       }
-      else if (WIFSTOPPED (s))
+    }
+
+    status
+    stream::wait ()
+    {
+      if (!pex)
+        throw rld::error ("Not open", "stream wait: " + name);
+
+      std::string line;
+      do
       {
-        _status.type = status::stopped;
-        _status.code = WSTOPSIG (s);
-        if (rld::verbose (RLD_VERBOSE_TRACE))
-          std::cout << "stopped: " << _status.code << std::endl;
+        read_line (line);
+      } while (!line.empty ());
+
+      int s = 0;
+
+      if (!::pex_get_status (pex, 1, &s))
+        throw rld::error ("execute: " + name, "pex_get_status failed");
+
+      ::pex_free (pex);
+      pex = 0;
+      out = 0;
+
+      if (copy)
+      {
+        copy->close ();
+        copy = 0;
       }
-      else
-        throw rld::error ("execute: " + args[0], "unknown status returned");
 
-      return _status;
+      return exit_status (name, s);
     }
 
     /*
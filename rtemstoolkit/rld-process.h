@@ -25,11 +25,18 @@
 #if !defined (_RLD_PEX_H_)
 #define _RLD_PEX_H_
 
+#include <cstdio>
 #include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "rld.h"
 
+/*
+ * Forward decl of the libiberty process object.
+ */
+struct pex_obj;
+
 namespace rld
 {
   namespace process
@@ -50,7 +57,8 @@ namespace rld
 
     /**
      * Manage temporary files. We keep these so we can delete them when
-     * we exit.
+     * we exit. The container is locked so temporary files can be created
+     * and removed from more than one thread.
      */
     class temporary_files
     {
@@ -99,6 +107,7 @@ namespace rld
       void unlink (const tempfile_ref& ref);
 
       tempfile_container tempfiles; //< The temporary files.
+      std::mutex         lock;      //< Protect the temporary files.
 
     };
 
@@ -251,6 +260,53 @@ namespace rld
                     const std::string& outname,
                     const std::string& errname);
 
+    /**
+     * Execute a process and read its stdout through a pipe while it runs.
+     * The process's stderr is captured in a file. The output does not touch
+     * the disk unless it is copied to a file with tee.
+     */
+    class stream
+    {
+    public:
+      /**
+       * Construct a stream with no process.
+       */
+      stream ();
+
+      /**
+       * Close the stream. A process that has not been waited for is killed.
+       */
+      ~stream ();
+
+      /**
+       * Start the process. The first element is the program name to run.
+       */
+      void open (const arg_container& args, const std::string& errname);
+
+      /**
+       * Copy each line read to the temporary file. The file is opened for
+       * writing.
+       */
+      void tee (tempfile& file);
+
+      /**
+       * Read a line at a time. The line is empty at the end of the output.
+       */
+      void read_line (std::string& line);
+
+      /**
+       * Read any remaining output and wait for the process to finish.
+       */
+      status wait ();
+
+    private:
+      ::pex_obj*  pex;       //< The libiberty process.
+      FILE*       out;       //< The process's stdout.
+      tempfile*   copy;      //< The tee file if not null.
+      std::string name;      //< The name of the program.
+      char        buf[4096]; //< The read buffer.
+    };
+
     /**
      * Parse a command line into arguments. It support quoting.
      */
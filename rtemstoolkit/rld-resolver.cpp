@@ -26,13 +26,16 @@
 #include "config.h"
 #endif
 
+#include <deque>
 #include <iomanip>
 #include <iostream>
+#include <set>
+#include <unordered_map>
 
 #include <sys/stat.h>
 
 #include <rld.h>
-#include <rld.h>
+#include <rld-resolver.h>
 
 namespace rld
 {
@@ -49,27 +52,130 @@ namespace rld
       return (*oi).second;
     }
 
-    static void
-    resolve_symbols (files::object_list& dependents,
-                     files::cache&       cache,
-                     symbols::table&     base_symbols,
-                     symbols::table&     symbols,
-                     symbols::symtab&    unresolved,
-                     const std::string&  fullname)
+    /**
+     * A resolution. The object files are resolved depth first using a
+     * worklist of the object files referenced by each object file being
+     * resolved rather than by recursion. The object files and symbols are
+     * visited in the same order as a recursive walk so the dependents are
+     * the same.
+     */
+    class resolution
     {
-      const std::string name = path::basename (fullname);
+    public:
+
+      resolution (files::object_list& dependents,
+                  files::cache&       cache,
+                  symbols::table&     base_symbols,
+                  symbols::table&     symbols,
+                  dependences&        graph);
+
+      /**
+       * Resolve the unresolved symbols of an object file and the object
+       * files they depend on.
+       */
+      void resolve (symbols::symtab& unresolved, const std::string& fullname);
+
+    private:
+
+      /**
+       * The result of looking up a symbol.
+       */
+      struct lookup
+      {
+        symbols::symbol* es;   //< The exported symbol.
+        bool             base; //< The symbol is in the base image.
+      };
+
+      /**
+       * An object file being resolved and the object files it references
+       * still to be resolved.
+       */
+      struct work
+      {
+        std::string                  name;
+        files::object_list           objects;
+        files::object_list::iterator next;
+      };
+
+      typedef std::unordered_map < const symbols::interned*, lookup > lookups;
+
+      /**
+       * Resolve an object file's unresolved symbols adding the work to the
+       * worklist.
+       */
+      void enter (symbols::symtab& unresolved, const std::string& fullname);
+
+      /**
+       * Find the symbol once, later references use the cached result.
+       */
+      const lookup& find (symbols::symbol& urs, const std::string& name);
+
+      files::object_list& dependents;
+      files::cache&       cache;
+      symbols::table&     base_symbols;
+      symbols::table&     symbols;
+      dependences&        graph;
+      lookups             found;
+      std::deque < work > worklist;
+    };
+
+    resolution::resolution (files::object_list& dependents,
+                            files::cache&       cache,
+                            symbols::table&     base_symbols,
+                            symbols::table&     symbols,
+                            dependences&        graph)
+      : dependents (dependents),
+        cache (cache),
+        base_symbols (base_symbols),
+        symbols (symbols),
+        graph (graph)
+    {
+    }
+
+    void
+    resolution::resolve (symbols::symtab&   unresolved,
+                         const std::string& fullname)
+    {
+      enter (unresolved, fullname);
 
-      static int nesting = 0;
+      while (!worklist.empty ())
+      {
+        work& w = worklist.back ();
+
+        if (w.next != w.objects.end ())
+        {
+          files::object& obj = *(*w.next);
+          ++w.next;
+          if (rld::verbose () >= RLD_VERBOSE_INFO)
+            std::cout << "resolver:resolving: "
+                      << std::setw (worklist.size ()) << ' '
+                      << "] " << w.name << " ==> "
+                      << obj.name ().basename () << std::endl;
+          enter (obj.unresolved_symbols (), obj.name ().full ());
+        }
+        else
+        {
+          dependents.merge (w.objects);
+          dependents.unique ();
+          worklist.pop_back ();
+        }
+      }
+    }
 
-      ++nesting;
+    void
+    resolution::enter (symbols::symtab&   unresolved,
+                       const std::string& fullname)
+    {
+      const std::string name = path::basename (fullname);
+      const int         nesting = worklist.size () + 1;
 
       /*
        * Find each unresolved symbol in the symbol table pointing the
        * unresolved symbol's object file to the file that resolves the
        * symbol. Record each object file that is found and when all unresolved
-       * symbols in this object file have been found iterate over the found
-       * object files resolving them. The 'urs' is the unresolved symbol and
-       * 'es' is the exported symbol.
+       * symbols in this object file have been found add the object file to
+       * the worklist to resolve the found object files. The 'urs' is the
+       * unresolved symbol and 'es' is the exported symbol.
        */
 
       files::object* object = get_object (cache, fullname);
@@ -97,7 +203,11 @@ namespace rld
                   << unresolved.size ()
                   << std::endl;
 
-      files::object_list objects;
+      worklist.push_back (work ());
+
+      work& w = worklist.back ();
+
+      w.name = name;
 
       for (symbols::symtab::iterator ursi = unresolved.begin ();
            ursi != unresolved.end ();
@@ -108,9 +218,6 @@ namespace rld
         if ((urs.binding () != STB_WEAK) && urs.object ())
           continue;
 
-        symbols::symbol* es = base_symbols.find_global (urs.name ());
-        bool             base = true;
-
         if (rld::verbose () >= RLD_VERBOSE_INFO)
         {
           std::cout << "resolver:resolve  : "
@@ -118,19 +225,8 @@ namespace rld
                     << " |- " << urs.name () << std::endl;
         }
 
-        if (!es)
-        {
-          es = symbols.find_global (urs.name ());
-          if (!es)
-          {
-            es = symbols.find_weak (urs.name ());
-            if (!es)
-              throw rld::error ("symbol not found: " + urs.name (), name);
-          }
-          base = false;
-        }
-
-        symbols::symbol& esym = *es;
+        const lookup&    lu = find (urs, name);
+        symbols::symbol& esym = *lu.es;
 
         if (rld::verbose () >= RLD_VERBOSE_INFO)
         {
@@ -144,25 +240,27 @@ namespace rld
               std::cout << " (resolving)";
             else if (esym.object()->resolved ())
               std::cout << " (resolved)";
-            else if (base)
+            else if (lu.base)
               std::cout << " (base)";
             else
-              std::cout << " (unresolved: " << objects.size () + 1 << ')';
+              std::cout << " (unresolved: " << w.objects.size () + 1 << ')';
           }
           else
             std::cout << "null";
           std::cout << std::endl;
         }
 
-        if (!base)
+        if (!lu.base)
         {
           files::object& eobj = *esym.object ();
           urs.set_object (eobj);
           if (!eobj.resolved () && !eobj.resolving ())
           {
-            objects.push_back (&eobj);
-            objects.unique ();
+            w.objects.push_back (&eobj);
+            w.objects.unique ();
           }
+          dependence dep = { object, &urs, &eobj };
+          graph.push_back (dep);
         }
 
         esym.referenced ();
@@ -174,35 +272,51 @@ namespace rld
         object->resolved_set ();
       }
 
-      /*
-       * Recurse into any references object files.
-       */
+      w.next = w.objects.begin ();
 
       if (rld::verbose () >= RLD_VERBOSE_INFO)
         std::cout << "resolver:resolved : "
                   << std::setw (nesting + 1) << ' '
-                  << " +-- referenced objects: " << objects.size ()
+                  << " +-- referenced objects: " << w.objects.size ()
                   << std::endl;
+    }
+
+    const resolution::lookup&
+    resolution::find (symbols::symbol& urs, const std::string& name)
+    {
+      const symbols::interned& key = urs.key ();
 
-      for (files::object_list::iterator oli = objects.begin ();
-           oli != objects.end ();
-           ++oli)
+      lookups::iterator li = found.find (&key);
+      if (li != found.end ())
+        return (*li).second;
+
+      lookup lu;
+
+      lu.es = base_symbols.find_global (key);
+      lu.base = true;
+
+      if (!lu.es)
       {
-        files::object& obj = *(*oli);
-        if (rld::verbose () >= RLD_VERBOSE_INFO)
-          std::cout << "resolver:resolving: "
-                    << std::setw (nesting) << ' '
-                    << "] " << name << " ==> "
-                    << obj.name ().basename () << std::endl;
-        resolve_symbols (dependents, cache, base_symbols, symbols,
-                         obj.unresolved_symbols (),
-                         obj.name ().full ());
+        lu.es = symbols.find_global (key);
+        if (!lu.es)
+        {
+          /*
+           * Load the archive object file that defines the symbol if the
+           * cache loads them lazily.
+           */
+          if (cache.load_symbol (symbols, urs.name ()))
+            lu.es = symbols.find_global (key);
+          if (!lu.es)
+          {
+            lu.es = symbols.find_weak (key);
+            if (!lu.es)
+              throw rld::error ("symbol not found: " + urs.name (), name);
+          }
+        }
+        lu.base = false;
       }
 
-      --nesting;
-
-      dependents.merge (objects);
-      dependents.unique ();
+      return found[&key] = lu;
     }
 
     void
@@ -211,16 +325,29 @@ namespace rld
              symbols::table&     base_symbols,
              symbols::table&     symbols,
              symbols::symtab&    undefined)
+    {
+      dependences graph;
+      resolve (dependents, cache, base_symbols, symbols, undefined, graph);
+    }
+
+    void
+    resolve (files::object_list& dependents,
+             files::cache&       cache,
+             symbols::table&     base_symbols,
+             symbols::table&     symbols,
+             symbols::symtab&    undefined,
+             dependences&        graph)
     {
       files::object_list objects;
       cache.get_objects (objects);
 
+      resolution res (dependents, cache, base_symbols, symbols, graph);
+
       /*
        * First resolve any undefined symbols that are forced by the linker or
        * the user.
        */
-      resolver::resolve_symbols (dependents, cache, base_symbols, symbols,
-                                 undefined, "undefines");
+      res.resolve (undefined, "undefines");
 
       /*
        * Resolve the symbols in the object files.
@@ -233,9 +360,7 @@ namespace rld
         if (rld::verbose () >= RLD_VERBOSE_INFO)
           std::cout << "resolver:resolving: top: "
                     << object.name ().basename () << std::endl;
-        resolver::resolve_symbols (dependents, cache, base_symbols, symbols,
-                                   object.unresolved_symbols (),
-                                   object.name ().full ());
+        res.resolve (object.unresolved_symbols (), object.name ().full ());
       }
 
       if (rld::verbose () >= RLD_VERBOSE_INFO)
@@ -253,6 +378,31 @@ namespace rld
         }
       }
     }
+
+    void
+    output (std::ostream& out, const dependences& graph)
+    {
+      std::set < files::object* > reported;
+
+      for (dependences::const_iterator di = graph.begin ();
+           di != graph.end ();
+           ++di)
+      {
+        const dependence& dep = *di;
+        if (dep.dependent->get_archive () &&
+            reported.find (dep.dependent) == reported.end ())
+        {
+          reported.insert (dep.dependent);
+          out << ' ' << dep.dependent->name ().full () << std::endl
+              << "   ";
+          if (dep.object)
+            out << dep.object->name ().full ();
+          else
+            out << "undefines";
+          out << " (" << dep.symbol->name () << ')' << std::endl;
+        }
+      }
+    }
   }
 
 }
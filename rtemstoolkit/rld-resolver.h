@@ -25,6 +25,9 @@
 #if !defined (_RLD_RESOLVER_H_)
 #define _RLD_RESOLVER_H_
 
+#include <iostream>
+#include <vector>
+
 #include <rld-files.h>
 #include <rld-symbols.h>
 
@@ -32,6 +35,23 @@ namespace rld
 {
   namespace resolver
   {
+    /**
+     * A dependence of an object file on another object file. The object file
+     * references the symbol and the dependent object file defines it.
+     */
+    struct dependence
+    {
+      files::object*         object;    //< The referencing object file, 0
+                                        //  for the undefined symbols.
+      const symbols::symbol* symbol;    //< The referenced symbol.
+      files::object*         dependent; //< The object file defining the symbol.
+    };
+
+    /**
+     * The dependence graph as a list of edges in the order they are found.
+     */
+    typedef std::vector < dependence > dependences;
+
     /**
      * Resolve the dependences between object files.
      *
@@ -48,6 +68,35 @@ namespace rld
                   symbols::table&     base_symbols,
                   symbols::table&     symbols,
                   symbols::symtab&    undefined);
+
+    /**
+     * Resolve the dependences between object files and record the
+     * dependence graph. The edges found are appended to the graph.
+     *
+     * @param dependents The object modules dependent on the object files we
+     *                   are linking.
+     * @param cache The file cache.
+     * @param base_symbols The base image symbol table
+     * @param symbols The object file and library symbols
+     * @param undefined Extra undefined symbols dependent object files are
+     *                  added for.
+     * @param graph The dependence graph.
+     */
+    void resolve (files::object_list& dependents,
+                  files::cache&       cache,
+                  symbols::table&     base_symbols,
+                  symbols::table&     symbols,
+                  symbols::symtab&    undefined,
+                  dependences&        graph);
+
+    /**
+     * Output the reason each archive object file is linked. The reason is
+     * the first reference found to a symbol the object file defines.
+     *
+     * @param out The output stream.
+     * @param graph The dependence graph.
+     */
+    void output (std::ostream& out, const dependences& graph);
   }
 }
 
@@ -24,7 +24,9 @@
 
 #include <string.h>
 
+#include <deque>
 #include <iomanip>
+#include <mutex>
 
 #include <rld.h>
 
@@ -69,8 +71,115 @@ namespace rld
       return symbols::demangle_name (name, demangled);
     }
 
+    uint32_t
+    hash_name (const std::string& name)
+    {
+      /*
+       * FNV-1a.
+       */
+      uint32_t hash = 2166136261U;
+      for (size_t c = 0; c < name.length (); ++c)
+      {
+        hash ^= static_cast < uint8_t > (name[c]);
+        hash *= 16777619U;
+      }
+      return hash;
+    }
+
+    /**
+     * The pool of interned names. The names are held in a deque so their
+     * addresses do not change and are found through an open addressed hash
+     * table of pointers to the names. Names are never released.
+     */
+    struct name_pool
+    {
+      std::mutex               lock;
+      std::deque < interned >  names;
+      std::vector < interned* > slots;
+
+      interned* find (const std::string& name, uint32_t hash)
+      {
+        if (!slots.empty ())
+        {
+          size_t mask = slots.size () - 1;
+          for (size_t slot = hash & mask;
+               slots[slot] != 0;
+               slot = (slot + 1) & mask)
+          {
+            interned* in = slots[slot];
+            if (in->hash == hash && in->name == name)
+              return in;
+          }
+        }
+        return 0;
+      }
+
+      void insert (interned* in)
+      {
+        size_t mask = slots.size () - 1;
+        size_t slot = in->hash & mask;
+        while (slots[slot] != 0)
+          slot = (slot + 1) & mask;
+        slots[slot] = in;
+      }
+
+      void grow ()
+      {
+        std::vector < interned* > old;
+        old.swap (slots);
+        slots.resize (old.empty () ? 1024 : old.size () * 2, 0);
+        for (auto in : old)
+          if (in)
+            insert (in);
+      }
+    };
+
+    static name_pool&
+    get_name_pool ()
+    {
+      static name_pool pool;
+      return pool;
+    }
+
+    const interned&
+    intern (const std::string& name)
+    {
+      name_pool& pool = get_name_pool ();
+      uint32_t   hash = hash_name (name);
+
+      {
+        std::lock_guard < std::mutex > guard (pool.lock);
+        interned* in = pool.find (name, hash);
+        if (in)
+          return *in;
+      }
+
+      /*
+       * Demangle outside the lock, it is the expensive part.
+       */
+      interned entry;
+      entry.name = name;
+      entry.hash = hash;
+      entry.cplusplus = demangle_name (name, entry.demangled);
+      if (!entry.cplusplus)
+        entry.demangled = name;
+
+      std::lock_guard < std::mutex > guard (pool.lock);
+      interned* in = pool.find (name, hash);
+      if (!in)
+      {
+        if (((pool.names.size () + 1) * 4) > (pool.slots.size () * 3))
+          pool.grow ();
+        pool.names.push_back (std::move (entry));
+        in = &pool.names.back ();
+        pool.insert (in);
+      }
+      return *in;
+    }
+
     symbol::symbol ()
       : index_ (-1),
+        name_ (&intern ("")),
         object_ (0),
         references_ (0)
     {
@@ -82,34 +191,30 @@ namespace rld
                     files::object&      object,
                     const elf::elf_sym& esym)
       : index_ (index),
-        name_ (name),
+        name_ (&intern (name)),
         object_ (&object),
         esym_ (esym),
         references_ (0)
     {
       if (!object_)
         throw rld_error_at ("object pointer is 0");
-      if (!demangle_name (name_, demangled_))
-        demangled_ = name_;
     }
 
     symbol::symbol (int                 index,
                     const std::string&  name,
                     const elf::elf_sym& esym)
       : index_ (index),
-        name_ (name),
+        name_ (&intern (name)),
         object_ (0),
         esym_ (esym),
         references_ (0)
     {
-      if (!demangle_name (name_, demangled_))
-        demangled_ = name_;
     }
 
     symbol::symbol (const std::string&  name,
                     const elf::elf_addr value)
       : index_ (-1),
-        name_ (name),
+        name_ (&intern (name)),
         object_ (0),
         references_ (0)
     {
@@ -120,7 +225,7 @@ namespace rld
     symbol::symbol (const char*         name,
                     const elf::elf_addr value)
       : index_ (-1),
-        name_ (name),
+        name_ (&intern (name)),
         object_ (0),
         references_ (0)
     {
@@ -137,19 +242,25 @@ namespace rld
     const std::string&
     symbol::name () const
     {
-      return name_;
+      return name_->name;
     }
 
     const std::string&
     symbol::demangled () const
     {
-      return demangled_;
+      return name_->demangled;
+    }
+
+    const interned&
+    symbol::key () const
+    {
+      return *name_;
     }
 
     bool
     symbol::is_cplusplus () const
     {
-      return symbols::is_cplusplus (name_);
+      return name_->cplusplus;
     }
 
     bool
@@ -229,7 +340,7 @@ namespace rld
     bool
     symbol::operator< (const symbol& rhs) const
     {
-      return name_ < rhs.name_;
+      return name_->name < rhs.name_->name;
     }
 
     void
@@ -307,7 +418,104 @@ namespace rld
         out << "   (" << object ()->name ().basename () << ')';
     }
 
+    symhash::symhash ()
+      : used (0)
+    {
+    }
+
+    void
+    symhash::add (symbol& sym)
+    {
+      if (((used + 1) * 4) > (slots.size () * 3))
+        grow ();
+      const interned* key = &sym.key ();
+      size_t          mask = slots.size () - 1;
+      size_t          slot = key->hash & mask;
+      while (slots[slot] != 0)
+      {
+        if (&slots[slot]->key () == key)
+        {
+          slots[slot] = &sym;
+          return;
+        }
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = &sym;
+      ++used;
+    }
+
+    symbol*
+    symhash::find (const std::string& name) const
+    {
+      if (used == 0)
+        return 0;
+      uint32_t hash = hash_name (name);
+      size_t   mask = slots.size () - 1;
+      for (size_t slot = hash & mask;
+           slots[slot] != 0;
+           slot = (slot + 1) & mask)
+      {
+        const interned& key = slots[slot]->key ();
+        if (key.hash == hash && key.name == name)
+          return slots[slot];
+      }
+      return 0;
+    }
+
+    symbol*
+    symhash::find (const interned& key) const
+    {
+      if (used == 0)
+        return 0;
+      size_t mask = slots.size () - 1;
+      for (size_t slot = key.hash & mask;
+           slots[slot] != 0;
+           slot = (slot + 1) & mask)
+      {
+        if (&slots[slot]->key () == &key)
+          return slots[slot];
+      }
+      return 0;
+    }
+
+    size_t
+    symhash::size () const
+    {
+      return used;
+    }
+
+    void
+    symhash::sorted (symtab& symbols) const
+    {
+      symbols.clear ();
+      for (auto sym : slots)
+        if (sym)
+          symbols[sym->name ()] = sym;
+    }
+
+    void
+    symhash::grow ()
+    {
+      std::vector < symbol* > old;
+      old.swap (slots);
+      slots.resize (old.empty () ? 64 : old.size () * 2, 0);
+      size_t mask = slots.size () - 1;
+      for (auto sym : old)
+      {
+        if (sym)
+        {
+          size_t slot = sym->key ().hash & mask;
+          while (slots[slot] != 0)
+            slot = (slot + 1) & mask;
+          slots[slot] = sym;
+        }
+      }
+    }
+
     table::table ()
+      : globals_stale (false),
+        weaks_stale (false),
+        locals_stale (false)
     {
     }
 
@@ -318,46 +526,52 @@ namespace rld
     void
     table::add_global (symbol& sym)
     {
-      globals_[sym.name ()] = &sym;
+      globals_.add (sym);
+      globals_stale = true;
     }
 
     void
     table::add_weak (symbol& sym)
     {
-      weaks_[sym.name ()] = &sym;
+      weaks_.add (sym);
+      weaks_stale = true;
     }
 
     void
     table::add_local (symbol& sym)
     {
-      locals_[sym.name ()] = &sym;
+      locals_.add (sym);
+      locals_stale = true;
     }
 
     symbol*
     table::find_global (const std::string& name)
     {
-      symtab::iterator sti = globals_.find (name);
-      if (sti == globals_.end ())
-        return 0;
-      return (*sti).second;
+      return globals_.find (name);
+    }
+
+    symbol*
+    table::find_global (const interned& key)
+    {
+      return globals_.find (key);
     }
 
     symbol*
     table::find_weak (const std::string& name)
     {
-      symtab::iterator sti = weaks_.find (name);
-      if (sti == weaks_.end ())
-        return 0;
-      return (*sti).second;
+      return weaks_.find (name);
+    }
+
+    symbol*
+    table::find_weak (const interned& key)
+    {
+      return weaks_.find (key);
     }
 
     symbol*
     table::find_local (const std::string& name)
     {
-      symtab::iterator sti = locals_.find (name);
-      if (sti == locals_.end ())
-        return 0;
-      return (*sti).second;
+      return locals_.find (name);
     }
 
     size_t
@@ -369,26 +583,27 @@ namespace rld
     const symtab&
     table::globals () const
     {
-      return globals_;
+      return view (globals_, globals_view, globals_stale);
     }
 
     const symtab&
     table::weaks () const
     {
-      return weaks_;
+      return view (weaks_, weaks_view, weaks_stale);
     }
 
     const symtab&
     table::locals () const
     {
-      return locals_;
+      return view (locals_, locals_view, locals_stale);
     }
 
     void
     table::globals (addrtab& addresses)
     {
-      for (symtab::iterator gi = globals_.begin ();
-           gi != globals_.end ();
+      const symtab& symbols = globals ();
+      for (symtab::const_iterator gi = symbols.begin ();
+           gi != symbols.end ();
            ++gi)
       {
         symbol& sym = *((*gi).second);
@@ -399,8 +614,9 @@ namespace rld
     void
     table::weaks (addrtab& addresses)
     {
-      for (symtab::iterator wi = weaks_.begin ();
-           wi != weaks_.end ();
+      const symtab& symbols = weaks ();
+      for (symtab::const_iterator wi = symbols.begin ();
+           wi != symbols.end ();
            ++wi)
       {
         symbol& sym = *((*wi).second);
@@ -411,8 +627,9 @@ namespace rld
     void
     table::locals (addrtab& addresses)
     {
-      for (symtab::iterator li = locals_.begin ();
-           li != locals_.end ();
+      const symtab& symbols = locals ();
+      for (symtab::const_iterator li = symbols.begin ();
+           li != symbols.end ();
            ++li)
       {
         symbol& sym = *((*li).second);
@@ -420,6 +637,17 @@ namespace rld
       }
     }
 
+    const symtab&
+    table::view (const symhash& symbols, symtab& sorted, bool& stale) const
+    {
+      if (stale)
+      {
+        symbols.sorted (sorted);
+        stale = false;
+      }
+      return sorted;
+    }
+
     void
     load (bucket& bucket_, table& table_)
     {
@@ -29,6 +29,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <rld-elf-types.h>
 
@@ -55,6 +56,30 @@ namespace rld
      */
     typedef elf::elf_addr address;
 
+    /**
+     * An interned name. Each unique symbol name is held once in a pool for
+     * the life of the program together with its demangled name and hash. All
+     * symbols with the same name share the same interned name so the address
+     * of an interned name can be used as the name's identifier.
+     */
+    struct interned
+    {
+      std::string name;      //< The name.
+      std::string demangled; //< The demangled name, or the name if not C++.
+      uint32_t    hash;      //< The hash of the name.
+      bool        cplusplus; //< The name is a C++ name.
+    };
+
+    /**
+     * Intern a name returning the pool's copy. This call is thread safe.
+     */
+    const interned& intern (const std::string& name);
+
+    /**
+     * The hash of a name. The same hash as held in an interned name.
+     */
+    uint32_t hash_name (const std::string& name);
+
     /**
      * A symbol.
      */
@@ -127,6 +152,11 @@ namespace rld
        */
       const std::string& demangled () const;
 
+      /**
+       * The symbol's interned name.
+       */
+      const interned& key () const;
+
       /**
        * Is the symbol a C++ name ?
        */
@@ -212,18 +242,19 @@ namespace rld
 
     private:
 
-      int            index_;      //< The symbol's index in the ELF file.
-      std::string    name_;       //< The name of the symbol.
-      std::string    demangled_;  //< If a C++ symbol the demangled name.
-      files::object* object_;     //< The object file containing the symbol.
-      elf::elf_sym   esym_;       //< The ELF symbol.
-      int            references_; //< The number of times if it referenced.
+      int             index_;      //< The symbol's index in the ELF file.
+      const interned* name_;       //< The interned name of the symbol.
+      files::object*  object_;     //< The object file containing the symbol.
+      elf::elf_sym    esym_;       //< The ELF symbol.
+      int             references_; //< The number of times if it referenced.
     };
 
     /**
-     * Container of symbols. A bucket of symbols.
+     * Container of symbols. A bucket of symbols. The symbols are held
+     * contiguously so a bucket must be fully loaded before pointers to its
+     * symbols are taken.
      */
-    typedef std::list < symbol > bucket;
+    typedef std::vector < symbol > bucket;
 
     /**
      * References to symbols. Should always point to symbols held in a bucket.
@@ -242,6 +273,55 @@ namespace rld
      */
     typedef std::map < address, symbol* > addrtab;
 
+    /**
+     * A hash table of symbols keyed by the symbol's interned name. The table
+     * is open addressed and adding a symbol with the same name as one held
+     * replaces it. Should always point to symbols held in a bucket.
+     */
+    class symhash
+    {
+    public:
+      /**
+       * Construct an empty hash table.
+       */
+      symhash ();
+
+      /**
+       * Add a symbol replacing any symbol with the same name.
+       */
+      void add (symbol& sym);
+
+      /**
+       * Find a symbol by name. Returns 0 if not found.
+       */
+      symbol* find (const std::string& name) const;
+
+      /**
+       * Find a symbol by interned name. Returns 0 if not found.
+       */
+      symbol* find (const interned& key) const;
+
+      /**
+       * The number of symbols in the table.
+       */
+      size_t size () const;
+
+      /**
+       * Load the symbols into a symbol table sorted by name.
+       */
+      void sorted (symtab& symbols) const;
+
+    private:
+
+      /**
+       * Resize the slots.
+       */
+      void grow ();
+
+      std::vector < symbol* > slots; //< The open addressed slots.
+      size_t                  used;  //< The number of slots used.
+    };
+
     /**
      * A symbols contains a symbol table of global, weak and local symbols.
      */
@@ -278,11 +358,21 @@ namespace rld
        */
       symbol* find_global (const std::string& name);
 
+      /**
+       * Find a global symbol by interned name.
+       */
+      symbol* find_global (const interned& key);
+
       /**
        * Find an weak symbol.
        */
       symbol* find_weak (const std::string& name);
 
+      /**
+       * Find a weak symbol by interned name.
+       */
+      symbol* find_weak (const interned& key);
+
       /**
        * Find an local symbol.
        */
@@ -294,17 +384,18 @@ namespace rld
       size_t size () const;
 
       /**
-       * Return the globals symbol table.
+       * Return the globals symbol table. The table is sorted by name and is
+       * built when first asked for after the globals change.
        */
       const symtab& globals () const;
 
       /**
-       * Return the weaks symbol table.
+       * Return the weaks symbol table. Built on demand as for the globals.
        */
       const symtab& weaks () const;
 
       /**
-       * Return the locals symbol table.
+       * Return the locals symbol table. Built on demand as for the globals.
        */
       const symtab& locals () const;
 
@@ -330,20 +421,37 @@ namespace rld
        */
       table (const table& orig);
 
+      /**
+       * Return a sorted view of a hash table, building it if stale.
+       */
+      const symtab& view (const symhash& symbols,
+                          symtab&        sorted,
+                          bool&          stale) const;
+
       /**
        * A table of global symbols.
        */
-      symtab globals_;
+      symhash globals_;
 
       /**
        * A table of weak symbols.
        */
-      symtab weaks_;
+      symhash weaks_;
 
       /**
        * A table of local symbols.
        */
-      symtab locals_;
+      symhash locals_;
+
+      /**
+       * The sorted views of the tables and if they need to be rebuilt.
+       */
+      mutable symtab globals_view;
+      mutable symtab weaks_view;
+      mutable symtab locals_view;
+      mutable bool   globals_stale;
+      mutable bool   weaks_stale;
+      mutable bool   locals_stale;
     };
 
     /**
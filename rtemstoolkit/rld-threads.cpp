@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2026, RTEMS Project (http://www.rtems.org/)
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief Run independent pieces of work on a number of threads.
+ *
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <rld-threads.h>
+
+namespace rld
+{
+  namespace threads
+  {
+    unsigned int
+    hardware_jobs ()
+    {
+      unsigned int jobs = std::thread::hardware_concurrency ();
+      if (jobs == 0)
+        jobs = 1;
+      return jobs;
+    }
+
+    void
+    parallel_for (size_t count, unsigned int jobs, const work& func)
+    {
+      parallel_for (count, jobs, func, work ());
+    }
+
+    void
+    parallel_for (size_t       count,
+                  unsigned int jobs,
+                  const work&  func,
+                  const work&  ordered)
+    {
+      if (jobs > count)
+        jobs = count;
+
+      if (jobs <= 1)
+      {
+        for (size_t i = 0; i < count; ++i)
+        {
+          func (i);
+          if (ordered)
+            ordered (i);
+        }
+        return;
+      }
+
+      std::atomic < size_t > next (0);
+      std::mutex             lock;
+      std::vector < bool >   finished (count, false);
+      size_t                 consumed = 0;
+      bool                   consuming = false;
+      std::exception_ptr     error;
+      size_t                 error_index = count;
+
+      auto failed = [&] (size_t i) {
+        if (i < error_index)
+        {
+          error = std::current_exception ();
+          error_index = i;
+        }
+        next = count;
+      };
+
+      /*
+       * The lock is only held to publish a finished index or to claim the
+       * next ordered index. One thread at a time is the consumer and makes
+       * the ordered calls outside of the lock so the other threads keep
+       * working. The consumer checks for indexes finished while it was
+       * calling before it gives up being the consumer.
+       */
+      auto worker = [&] () {
+        while (true)
+        {
+          size_t i = next++;
+          if (i >= count)
+            break;
+          try
+          {
+            func (i);
+          }
+          catch (...)
+          {
+            std::lock_guard < std::mutex > guard (lock);
+            failed (i);
+            continue;
+          }
+          std::unique_lock < std::mutex > guard (lock);
+          finished[i] = true;
+          if (consuming)
+            continue;
+          consuming = true;
+          while (consumed < error_index && finished[consumed])
+          {
+            size_t c = consumed;
+            guard.unlock ();
+            try
+            {
+              if (ordered)
+                ordered (c);
+            }
+            catch (...)
+            {
+              guard.lock ();
+              failed (c);
+              break;
+            }
+            guard.lock ();
+            ++consumed;
+          }
+          consuming = false;
+        }
+      };
+
+      std::vector < std::thread > threads;
+      threads.reserve (jobs - 1);
+      for (unsigned int t = 1; t < jobs; ++t)
+        threads.push_back (std::thread (worker));
+      worker ();
+      for (auto& t : threads)
+        t.join ();
+
+      if (error)
+        std::rethrow_exception (error);
+    }
+  }
+}
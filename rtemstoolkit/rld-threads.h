@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, RTEMS Project (http://www.rtems.org/)
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+/**
+ * @file
+ *
+ * @ingroup rtems-ld
+ *
+ * @brief Run independent pieces of work on a number of threads.
+ *
+ */
+
+#if !defined (_RLD_THREADS_H_)
+#define _RLD_THREADS_H_
+
+#include <stddef.h>
+
+#include <functional>
+
+namespace rld
+{
+  namespace threads
+  {
+    /**
+     * The work function called for each index.
+     */
+    typedef std::function < void (size_t index) > work;
+
+    /**
+     * The number of jobs the host can run at the same time. This is at least
+     * one.
+     */
+    unsigned int hardware_jobs ();
+
+    /**
+     * Call the work function for each index from 0 to count - 1 using up to
+     * the number of jobs threads. The indexes are handed out in order. A
+     * single job runs the work on the calling thread. If the work throws for
+     * an index the remaining indexes are not started and the exception of the
+     * lowest index that failed is rethrown once all threads have finished.
+     *
+     * @param count The number of indexes to call the work with.
+     * @param jobs The maximum number of threads to use.
+     * @param func The work to call for each index.
+     */
+    void parallel_for (size_t count, unsigned int jobs, const work& func);
+
+    /**
+     * Call the work function for each index as above and then call the
+     * ordered function for each index in index order. The ordered calls are
+     * serialised and are made as soon as the work for an index and all lower
+     * indexes has finished so results can be consumed while other work is
+     * still running. An exception from either function stops the remaining
+     * indexes.
+     *
+     * @param count The number of indexes to call the work with.
+     * @param jobs The maximum number of threads to use.
+     * @param func The work to call for each index.
+     * @param ordered The function to call for each index in order.
+     */
+    void parallel_for (size_t       count,
+                       unsigned int jobs,
+                       const work&  func,
+                       const work&  ordered);
+  }
+}
+
+#endif
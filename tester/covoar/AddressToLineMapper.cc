@@ -5,6 +5,8 @@
  *  of the AddressToLineMapper class.
  */
 
+#include <algorithm>
+
 #include "AddressToLineMapper.h"
 
 namespace Coverage {
@@ -34,18 +36,39 @@ namespace Coverage {
   }
 
   void AddressLineRange::addSourceLine(const rld::dwarf::address& address)
+  {
+    addSourceLine(
+      address.location(),
+      address.path(),
+      address.line(),
+      address.is_an_end_sequence()
+    );
+  }
+
+  void AddressLineRange::addSourceLine(
+    uint64_t address,
+    const std::string& path,
+    int line,
+    bool end_sequence
+  )
   {
     auto insertResult = sourcePaths.insert(
-      std::make_shared<std::string>(address.path()));
+      std::make_shared<std::string>(path));
 
     sourceLines.emplace_back(
       SourceLine (
-        address.location(),
+        address,
         *insertResult.first,
-        address.line(),
-        address.is_an_end_sequence()
+        line,
+        end_sequence
       )
     );
+
+    if (highestLocations.empty() || address > highestLocations.back()) {
+      highestLocations.push_back(address);
+    } else {
+      highestLocations.push_back(highestLocations.back());
+    }
   }
 
   const SourceLine& AddressLineRange::getSourceLine(uint32_t address) const
@@ -54,22 +77,61 @@ namespace Coverage {
       throw SourceNotFoundError(std::to_string(address));
     }
 
-    const SourceLine* last_line = nullptr;
-    for (const auto &line : sourceLines) {
-      if (address <= line.location())
-      {
-        if (address == line.location())
-          last_line = &line;
-        break;
-      }
-      last_line = &line;
+    // The first line at or after the address is the first line with the
+    // highest location so far at or after the address.
+    auto   found = std::lower_bound(
+      highestLocations.begin(),
+      highestLocations.end(),
+      address
+    );
+    size_t index = found - highestLocations.begin();
+
+    if (index < sourceLines.size() && sourceLines[index].location() == address) {
+      return sourceLines[index];
     }
 
-    if (last_line == nullptr) {
+    if (index == 0) {
       throw SourceNotFoundError(std::to_string(address));
     }
 
-    return *last_line;
+    return sourceLines[index - 1];
+  }
+
+  void AddressLineRange::getSourceLines(
+    const uint32_t* addresses,
+    size_t count,
+    const SourceLine** lines
+  ) const
+  {
+    auto found = highestLocations.begin();
+
+    for (size_t a = 0; a < count; ++a) {
+      uint32_t address = addresses[a];
+
+      lines[a] = nullptr;
+      if (address < lowAddress || address > highAddress) {
+        continue;
+      }
+
+      found = std::lower_bound(found, highestLocations.end(), address);
+      size_t index = found - highestLocations.begin();
+
+      if (index < sourceLines.size() && sourceLines[index].location() == address) {
+        lines[a] = &sourceLines[index];
+      } else if (index > 0) {
+        lines[a] = &sourceLines[index - 1];
+      }
+    }
+  }
+
+  uint32_t AddressLineRange::getLowAddress() const
+  {
+    return lowAddress;
+  }
+
+  uint32_t AddressLineRange::getHighAddress() const
+  {
+    return highAddress;
   }
 
   void AddressToLineMapper::getSource(
@@ -79,10 +141,14 @@ namespace Coverage {
   ) const {
     const SourceLine default_sourceline = SourceLine();
     const SourceLine* match = &default_sourceline;
+    std::vector<size_t> ranges;
 
-    for (const auto &range : addressLineRanges) {
+    findRanges(address, ranges);
+
+    for (size_t r : ranges) {
       try {
-        const SourceLine& potential_match = range.getSourceLine(address);
+        const SourceLine& potential_match =
+          addressLineRanges[r].getSourceLine(address);
 
         if (match->is_an_end_sequence() || !potential_match.is_an_end_sequence()) {
           match = &potential_match;
@@ -94,6 +160,74 @@ namespace Coverage {
     sourceLine = match->line();
   }
 
+  void AddressToLineMapper::getSources(
+    const std::vector<uint32_t>& addresses,
+    std::vector<std::string>& sourceFiles,
+    std::vector<int>& sourceLines
+  ) const {
+    const SourceLine default_sourceline = SourceLine();
+    size_t count = addresses.size();
+    std::vector<size_t> order(count);
+
+    for (size_t a = 0; a < count; ++a) {
+      order[a] = a;
+    }
+    std::stable_sort(
+      order.begin(),
+      order.end(),
+      [&addresses](size_t lhs, size_t rhs) {
+        return addresses[lhs] < addresses[rhs];
+      }
+    );
+
+    std::vector<uint32_t> sorted(count);
+    for (size_t a = 0; a < count; ++a) {
+      sorted[a] = addresses[order[a]];
+    }
+
+    // Each range looks up the addresses it holds in one pass. The ranges
+    // are worked in the order they were made so the match of an address is
+    // the one getSource() finds.
+    std::vector<const SourceLine*> matches(count, &default_sourceline);
+    std::vector<const SourceLine*> potentials;
+
+    for (const auto& range : addressLineRanges) {
+      auto first = std::lower_bound(
+        sorted.begin(),
+        sorted.end(),
+        range.getLowAddress()
+      );
+      auto last = std::upper_bound(first, sorted.end(), range.getHighAddress());
+      size_t offset = first - sorted.begin();
+      size_t size = last - first;
+
+      if (size == 0) {
+        continue;
+      }
+
+      potentials.resize(size);
+      range.getSourceLines(sorted.data() + offset, size, potentials.data());
+
+      for (size_t a = 0; a < size; ++a) {
+        const SourceLine*& match = matches[offset + a];
+        const SourceLine*  potential_match = potentials[a];
+
+        if (potential_match != nullptr &&
+            (match->is_an_end_sequence() ||
+             !potential_match->is_an_end_sequence())) {
+          match = potential_match;
+        }
+      }
+    }
+
+    sourceFiles.resize(count);
+    sourceLines.resize(count);
+    for (size_t a = 0; a < count; ++a) {
+      sourceFiles[order[a]] = matches[a]->path();
+      sourceLines[order[a]] = matches[a]->line();
+    }
+  }
+
   AddressLineRange& AddressToLineMapper::makeRange(
     uint32_t low,
     uint32_t high
@@ -106,4 +240,63 @@ namespace Coverage {
     return addressLineRanges.back();
   }
 
+  void AddressToLineMapper::buildIndex()
+  {
+    size_t count = addressLineRanges.size();
+
+    rangeOrder.resize(count);
+    for (size_t r = 0; r < count; ++r) {
+      rangeOrder[r] = r;
+    }
+    std::stable_sort(
+      rangeOrder.begin(),
+      rangeOrder.end(),
+      [this](size_t lhs, size_t rhs) {
+        return addressLineRanges[lhs].getLowAddress() <
+          addressLineRanges[rhs].getLowAddress();
+      }
+    );
+
+    rangeLows.resize(count);
+    rangeHighs.resize(count);
+    for (size_t r = 0; r < count; ++r) {
+      const AddressLineRange& range = addressLineRanges[rangeOrder[r]];
+
+      rangeLows[r] = range.getLowAddress();
+      rangeHighs[r] = range.getHighAddress();
+      if (r > 0 && rangeHighs[r - 1] > rangeHighs[r]) {
+        rangeHighs[r] = rangeHighs[r - 1];
+      }
+    }
+  }
+
+  void AddressToLineMapper::findRanges(
+    uint32_t address,
+    std::vector<size_t>& ranges
+  ) const
+  {
+    ranges.clear();
+
+    if (rangeOrder.size() != addressLineRanges.size()) {
+      for (size_t r = 0; r < addressLineRanges.size(); ++r) {
+        ranges.push_back(r);
+      }
+      return;
+    }
+
+    // Walk back from the last range starting at or before the address
+    // while a range before it can still end at or after the address.
+    size_t r = std::upper_bound(rangeLows.begin(), rangeLows.end(), address) -
+      rangeLows.begin();
+
+    while (r > 0 && rangeHighs[r - 1] >= address) {
+      --r;
+      if (addressLineRanges[rangeOrder[r]].getHighAddress() >= address) {
+        ranges.push_back(rangeOrder[r]);
+      }
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+  }
+
 }
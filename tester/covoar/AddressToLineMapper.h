@@ -140,6 +140,22 @@ namespace Coverage {
      */
     void addSourceLine(const rld::dwarf::address& address);
 
+    /*!
+     *  This method adds source and line information for a specified address.
+     *
+     *  @param[in] address specifies the address
+     *  @param[in] path specifies the source file path
+     *  @param[in] line specifies the source line number
+     *  @param[in] end_sequence specifies whether the address is an end
+     *             sequence
+     */
+    void addSourceLine(
+      uint64_t address,
+      const std::string& path,
+      int line,
+      bool end_sequence
+    );
+
     /*!
      *  This method gets the source file name and line number for a given
      *  address.
@@ -150,6 +166,36 @@ namespace Coverage {
      */
     const SourceLine& getSourceLine(uint32_t address) const;
 
+    /*!
+     *  This method gets the source information for addresses sorted from
+     *  low to high in one pass over the source information of the range.
+     *  The source information of an address is the same as getSourceLine()
+     *  finds or a null pointer if getSourceLine() would throw.
+     *
+     *  @param[in] addresses specifies the sorted addresses to look up
+     *  @param[in] count specifies the number of addresses
+     *  @param[out] lines specifies the source information of each address
+     */
+    void getSourceLines(
+      const uint32_t* addresses,
+      size_t count,
+      const SourceLine** lines
+    ) const;
+
+    /*!
+     *  This method gets the low address of this range.
+     *
+     *  @return Returns the low address of this range
+     */
+    uint32_t getLowAddress() const;
+
+    /*!
+     *  This method gets the high address of this range.
+     *
+     *  @return Returns the high address of this range
+     */
+    uint32_t getHighAddress() const;
+
   private:
 
     /*!
@@ -167,6 +213,13 @@ namespace Coverage {
      */
     SourceLines sourceLines;
 
+    /*!
+     *  The highest address of the source information up to and including
+     *  each entry of the source information. The addresses are not always
+     *  in order so this is searched rather than the source information.
+     */
+    std::vector<uint64_t> highestLocations;
+
     /*!
      *  The set of source file names for this range.
      */
@@ -198,6 +251,21 @@ namespace Coverage {
       int& sourceLine
     ) const;
 
+    /*!
+     *  This method gets the source file name and line number for each of
+     *  a list of addresses. The addresses do not need to be sorted. The
+     *  result for an address is the same as getSource() returns.
+     *
+     *  @param[in] addresses specifies the addresses to look up
+     *  @param[out] sourceFiles specifies the name of each source file
+     *  @param[out] sourceLines specifies each line number
+     */
+    void getSources(
+      const std::vector<uint32_t>& addresses,
+      std::vector<std::string>& sourceFiles,
+      std::vector<int>& sourceLines
+    ) const;
+
     /*!
      *  This method creates a new range with the specified addresses.
      *
@@ -208,13 +276,49 @@ namespace Coverage {
      */
     AddressLineRange& makeRange(uint32_t low, uint32_t high);
 
+    /*!
+     *  This method indexes the ranges by address. It is called after the
+     *  ranges are made. A range made after the index is built is not
+     *  indexed and the ranges are searched one at a time until the index
+     *  is built again.
+     */
+    void buildIndex();
+
   private:
 
+    /*!
+     *  This method gets the indices of the ranges that hold an address in
+     *  the order the ranges were made.
+     *
+     *  @param[in] address specifies the address to look up
+     *  @param[out] ranges specifies the indices of the ranges
+     */
+    void findRanges(
+      uint32_t address,
+      std::vector<size_t>& ranges
+    ) const;
+
     /*!
      *  The address and line information ranges.
      */
     AddressLineRanges addressLineRanges;
 
+    /*!
+     *  The indices of the ranges sorted by the low address.
+     */
+    std::vector<size_t> rangeOrder;
+
+    /*!
+     *  The low address of each range in the range order.
+     */
+    std::vector<uint32_t> rangeLows;
+
+    /*!
+     *  The highest high address of the ranges up to and including each
+     *  range in the range order.
+     */
+    std::vector<uint32_t> rangeHighs;
+
   };
 
 }
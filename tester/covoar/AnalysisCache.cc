@@ -0,0 +1,820 @@
+/*! @file AnalysisCache.cc
+ *  @brief AnalysisCache Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  the cache of executable analysis results.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <rld.h>
+#include <rld-elf.h>
+
+#include "AnalysisCache.h"
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+#ifdef __WIN32__
+#include <direct.h>
+#endif
+
+namespace Coverage {
+
+  /*
+   * The entry header's magic and the format version. Change the version if
+   * the layout of an entry or how its contents are found changes.
+   */
+  static const char     entryMagic[ 8 ] = {
+    'C', 'O', 'V', 'O', 'A', 'R', 'A', 'C'
+  };
+  static const uint32_t entryVersion = 5;
+
+  /*
+   * The kinds of entry.
+   */
+  static const uint32_t executableEntry = 1;
+  static const uint32_t listingsEntry = 2;
+
+  /*
+   * An entry is a header, a block of counts, arrays of fixed size records
+   * and a string table. The header is the magic, version, kind, key and the
+   * offset and size of the string table. Each array starts on an 8 byte
+   * boundary and a string in a record is its offset and size in the string
+   * table. All values are little-endian. The records are found from the
+   * counts without reading the entry so it is used in place where it is
+   * mapped.
+   */
+  static const size_t entryHeaderSize = sizeof( entryMagic ) + 4 + 4 + 8 + 4 + 4;
+  static const size_t entryAlign = 8;
+
+  /*
+   * The size of each record.
+   */
+  static const size_t strSize = 8;
+  static const size_t symbolStartSize = 4 + strSize;
+  static const size_t pathSize = strSize;
+  static const size_t lineRangeSize = 16;
+  static const size_t lineSize = 24;
+  static const size_t functionSize = strSize + strSize + 8 + 8 + 8;
+  static const size_t listingSize = 4 + strSize + 24;
+  static const size_t listingLineSize = strSize + 4;
+
+  /*
+   * The listings hold a bitmap of the instruction starts, nops and branches
+   * over the addresses of a listing's instructions.
+   */
+  static const uint32_t instructionBitmap = 0;
+  static const uint32_t nopBitmap = 1;
+  static const uint32_t branchBitmap = 2;
+  static const uint32_t bitmaps = 3;
+
+  /*
+   * Encode an entry's fields in little-endian byte order.
+   */
+  class EntryWriter {
+
+  public:
+
+    EntryWriter( uint32_t kind, uint64_t key )
+    {
+      data.append( entryMagic, sizeof( entryMagic ) );
+      u32( entryVersion );
+      u32( kind );
+      u64( key );
+      u32( 0 );
+      u32( 0 );
+    }
+
+    void u8( uint8_t v )
+    {
+      data.push_back( static_cast<char>( v ) );
+    }
+
+    void u32( uint32_t v )
+    {
+      for ( int b = 0; b < 4; ++b ) {
+        u8( static_cast<uint8_t>( v >> ( b * 8 ) ) );
+      }
+    }
+
+    void u64( uint64_t v )
+    {
+      u32( static_cast<uint32_t>( v ) );
+      u32( static_cast<uint32_t>( v >> 32 ) );
+    }
+
+    void str( const std::string& s )
+    {
+      u32( strings.size() );
+      u32( s.size() );
+      strings.append( s );
+    }
+
+    /*
+     * Start an array of records.
+     */
+    void array()
+    {
+      while ( ( data.size() % entryAlign ) != 0 ) {
+        u8( 0 );
+      }
+    }
+
+    /*
+     * Append the string table and set its offset and size in the header.
+     */
+    const std::string& finish()
+    {
+      array();
+      patch( entryHeaderSize - 8, data.size() );
+      patch( entryHeaderSize - 4, strings.size() );
+      data.append( strings );
+      return data;
+    }
+
+  private:
+
+    void patch( size_t offset, uint32_t v )
+    {
+      for ( int b = 0; b < 4; ++b ) {
+        data[ offset + b ] = static_cast<char>( v >> ( b * 8 ) );
+      }
+    }
+
+    std::string data;
+    std::string strings;
+  };
+
+  /*
+   * Decode the fields of an entry where it is mapped. Accessing a record
+   * past the end of the entry throws an error.
+   */
+  class EntryReader {
+
+  public:
+
+    EntryReader( const MappedFile& file ) :
+      data( file.data() ),
+      size( file.size() ),
+      next( 0 ),
+      strings( 0 ),
+      stringsSize( 0 )
+    {
+    }
+
+    /*
+     * Check the header and move to the counts.
+     */
+    bool header( uint32_t kind, uint64_t key )
+    {
+      if (
+        ( size < entryHeaderSize ) ||
+        ( ::memcmp( data, entryMagic, sizeof( entryMagic ) ) != 0 )
+      ) {
+        return false;
+      }
+
+      next = sizeof( entryMagic );
+      if (
+        ( u32() != entryVersion ) ||
+        ( u32() != kind ) ||
+        ( u64() != key )
+      ) {
+        return false;
+      }
+
+      strings = u32();
+      stringsSize = u32();
+
+      return ( strings <= size ) && ( stringsSize <= size - strings );
+    }
+
+    uint32_t u32()
+    {
+      uint32_t v = u32( next );
+      next += 4;
+      return v;
+    }
+
+    uint64_t u64()
+    {
+      uint64_t v = u64( next );
+      next += 8;
+      return v;
+    }
+
+    uint8_t u8( size_t offset ) const
+    {
+      check( offset, 1 );
+      return data[ offset ];
+    }
+
+    uint32_t u32( size_t offset ) const
+    {
+      uint32_t v = 0;
+      check( offset, 4 );
+      for ( int b = 0; b < 4; ++b ) {
+        v |= static_cast<uint32_t>( data[ offset + b ] ) << ( b * 8 );
+      }
+      return v;
+    }
+
+    uint64_t u64( size_t offset ) const
+    {
+      uint64_t low = u32( offset );
+      uint64_t high = u32( offset + 4 );
+      return low | ( high << 32 );
+    }
+
+    void str( size_t offset, std::string& s ) const
+    {
+      uint32_t at = u32( offset );
+      uint32_t length = u32( offset + 4 );
+      if ( ( at > stringsSize ) || ( length > stringsSize - at ) ) {
+        throw rld::error( "String is out of range", "AnalysisCache" );
+      }
+      s.assign(
+        reinterpret_cast<const char*>( data + strings + at ), length
+      );
+    }
+
+    /*
+     * Returns the offset of an array of records and moves past it.
+     */
+    size_t array( uint32_t count, size_t recordSize )
+    {
+      next = ( next + entryAlign - 1 ) & ~( entryAlign - 1 );
+      check( next, static_cast<uint64_t>( count ) * recordSize );
+      size_t offset = next;
+      next += count * recordSize;
+      return offset;
+    }
+
+  private:
+
+    void check( size_t offset, uint64_t length ) const
+    {
+      if ( ( offset > size ) || ( length > size - offset ) ) {
+        throw rld::error( "Entry is truncated", "AnalysisCache" );
+      }
+    }
+
+    const uint8_t* data;
+    size_t         size;
+    size_t         next;
+    size_t         strings;
+    size_t         stringsSize;
+  };
+
+  /*
+   * Test a bit in the bitmaps of a listing.
+   */
+  static bool testBit(
+    const EntryReader& entry,
+    size_t             words,
+    uint32_t           count,
+    uint32_t           bitmap,
+    uint32_t           bit
+  )
+  {
+    uint32_t word = entry.u32( words + ( bitmap * count + bit / 32 ) * 4 );
+    return ( word & ( 1U << ( bit % 32 ) ) ) != 0;
+  }
+
+  AnalysisCache::AnalysisCache(
+    const std::string& directory,
+    const std::string& target
+  ) : directory_m( directory ),
+      target_m( target )
+  {
+    int sc;
+
+#ifdef __WIN32__
+    sc = _mkdir( directory_m.c_str() );
+#else
+    sc = mkdir( directory_m.c_str(), 0755 );
+#endif
+    if ( ( sc == -1 ) && ( errno != EEXIST ) ) {
+      throw rld::error(
+        "Unable to create cache directory: " + directory_m,
+        "AnalysisCache::AnalysisCache"
+      );
+    }
+  }
+
+  AnalysisCache::~AnalysisCache()
+  {
+  }
+
+  uint64_t AnalysisCache::getKey( rld::files::object& executable ) const
+  {
+    rld::elf::sections sections;
+    ContentHash        hash;
+
+    hash.add( target_m );
+
+    // The analysis is read from the code, the symbol table and the debug
+    // information.
+    executable.elf().get_sections( sections, 0 );
+    for ( auto sec : sections ) {
+      const std::string& name = sec->name();
+
+      if (
+        ( sec->type() == SHT_NOBITS ) ||
+        ( ( name != ".text" ) &&
+          ( name != ".symtab" ) &&
+          ( name != ".strtab" ) &&
+          ( name.compare( 0, 7, ".debug_" ) != 0 ) )
+      ) {
+        continue;
+      }
+
+      hash.add( name );
+      hash.add( static_cast<uint64_t>( sec->address() ) );
+
+      rld::elf::elf_data* data = sec->data();
+      if ( data != nullptr && data->d_buf != nullptr ) {
+        hash.add( static_cast<uint64_t>( data->d_size ) );
+        hash.add( data->d_buf, data->d_size );
+      }
+    }
+
+    return hash.get();
+  }
+
+  uint64_t AnalysisCache::getKey(
+    uint64_t                             executableKey,
+    const ExecutableInfo::DesiredRanges& ranges
+  ) const
+  {
+    ContentHash hash;
+
+    hash.add( executableKey );
+    for ( const auto& range : ranges ) {
+      hash.add( range.low );
+      hash.add( range.high );
+    }
+
+    return hash.get();
+  }
+
+  bool AnalysisCache::load(
+    uint64_t            key,
+    ExecutableAnalysis& analysis
+  ) const
+  {
+    MappedFile file;
+
+    if ( !file.open( entryPath( key, ".analysis" ) ) ) {
+      return false;
+    }
+
+    try {
+      EntryReader entry( file );
+
+      if ( !entry.header( executableEntry, key ) ) {
+        return false;
+      }
+
+      analysis = ExecutableAnalysis();
+      analysis.hasText  = entry.u32() != 0;
+      analysis.textHigh = entry.u32();
+
+      uint32_t symbolStarts = entry.u32();
+      uint32_t paths = entry.u32();
+      uint32_t lineRanges = entry.u32();
+      uint32_t lines = entry.u32();
+      uint32_t functions = entry.u32();
+
+      size_t at = entry.array( symbolStarts, symbolStartSize );
+      analysis.symbolStarts.resize( symbolStarts );
+      for ( auto& start : analysis.symbolStarts ) {
+        start.address = entry.u32( at );
+        entry.str( at + 4, start.name );
+        at += symbolStartSize;
+      }
+
+      at = entry.array( paths, pathSize );
+      analysis.paths.resize( paths );
+      for ( auto& path : analysis.paths ) {
+        entry.str( at, path );
+        at += pathSize;
+      }
+
+      size_t rangesAt = entry.array( lineRanges, lineRangeSize );
+      size_t linesAt = entry.array( lines, lineSize );
+      analysis.lineRanges.resize( lineRanges );
+      for ( auto& range : analysis.lineRanges ) {
+        uint32_t first = entry.u32( rangesAt + 8 );
+        uint32_t count = entry.u32( rangesAt + 12 );
+
+        range.low  = entry.u32( rangesAt );
+        range.high = entry.u32( rangesAt + 4 );
+        rangesAt += lineRangeSize;
+
+        if ( ( first > lines ) || ( count > lines - first ) ) {
+          return false;
+        }
+
+        size_t lineAt = linesAt + first * lineSize;
+        range.lines.resize( count );
+        for ( auto& line : range.lines ) {
+          line.address     = entry.u64( lineAt );
+          line.path        = entry.u32( lineAt + 8 );
+          line.line        = static_cast<int32_t>( entry.u32( lineAt + 12 ) );
+          line.endSequence = entry.u32( lineAt + 16 ) != 0;
+          lineAt += lineSize;
+          if ( line.path >= analysis.paths.size() ) {
+            return false;
+          }
+        }
+      }
+
+      at = entry.array( functions, functionSize );
+      analysis.functions.resize( functions );
+      for ( auto& func : analysis.functions ) {
+        entry.str( at, func.compUnit );
+        entry.str( at + 8, func.name );
+        func.low  = entry.u64( at + 16 );
+        func.high = entry.u64( at + 24 );
+        uint32_t flags = entry.u32( at + 32 );
+        func.inlined  = ( flags & 1 ) != 0;
+        func.external = ( flags & 2 ) != 0;
+        func.entryPc  = ( flags & 4 ) != 0;
+        at += functionSize;
+      }
+
+      return true;
+    } catch ( rld::error& ) {
+      return false;
+    }
+  }
+
+  void AnalysisCache::save(
+    uint64_t                  key,
+    const ExecutableAnalysis& analysis
+  ) const
+  {
+    EntryWriter entry( executableEntry, key );
+    uint32_t    lines = 0;
+
+    for ( const auto& range : analysis.lineRanges ) {
+      lines += range.lines.size();
+    }
+
+    entry.u32( analysis.hasText ? 1 : 0 );
+    entry.u32( analysis.textHigh );
+    entry.u32( analysis.symbolStarts.size() );
+    entry.u32( analysis.paths.size() );
+    entry.u32( analysis.lineRanges.size() );
+    entry.u32( lines );
+    entry.u32( analysis.functions.size() );
+
+    entry.array();
+    for ( const auto& start : analysis.symbolStarts ) {
+      entry.u32( start.address );
+      entry.str( start.name );
+    }
+
+    entry.array();
+    for ( const auto& path : analysis.paths ) {
+      entry.str( path );
+    }
+
+    entry.array();
+    lines = 0;
+    for ( const auto& range : analysis.lineRanges ) {
+      entry.u32( range.low );
+      entry.u32( range.high );
+      entry.u32( lines );
+      entry.u32( range.lines.size() );
+      lines += range.lines.size();
+    }
+
+    entry.array();
+    for ( const auto& range : analysis.lineRanges ) {
+      for ( const auto& line : range.lines ) {
+        entry.u64( line.address );
+        entry.u32( line.path );
+        entry.u32( static_cast<uint32_t>( line.line ) );
+        entry.u32( line.endSequence ? 1 : 0 );
+        entry.u32( 0 );
+      }
+    }
+
+    entry.array();
+    for ( const auto& func : analysis.functions ) {
+      entry.str( func.compUnit );
+      entry.str( func.name );
+      entry.u64( func.low );
+      entry.u64( func.high );
+      entry.u32(
+        ( func.inlined ? 1 : 0 ) |
+        ( func.external ? 2 : 0 ) |
+        ( func.entryPc ? 4 : 0 )
+      );
+      entry.u32( 0 );
+    }
+
+    writeEntry( entryPath( key, ".analysis" ), entry.finish() );
+  }
+
+  bool AnalysisCache::load(
+    uint64_t                             key,
+    ObjdumpProcessor::objdumpListings_t& listings,
+    bool&                                endsInListing
+  ) const
+  {
+    MappedFile file;
+
+    listings.clear();
+
+    if ( !file.open( entryPath( key, ".listings" ) ) ) {
+      return false;
+    }
+
+    try {
+      EntryReader entry( file );
+
+      if ( !entry.header( listingsEntry, key ) ) {
+        return false;
+      }
+
+      endsInListing = entry.u32() != 0;
+
+      uint32_t count = entry.u32();
+      uint32_t lines = entry.u32();
+      uint32_t words = entry.u32();
+      uint32_t nops = entry.u32();
+
+      size_t listingAt = entry.array( count, listingSize );
+      size_t linesAt = entry.array( lines, listingLineSize );
+      size_t wordsAt = entry.array( words, 4 );
+      size_t nopsAt = entry.array( nops, 1 );
+
+      for ( uint32_t l = 0; l < count; ++l ) {
+        listings.push_back( ObjdumpProcessor::objdumpListing_t() );
+
+        ObjdumpProcessor::objdumpListing_t& listing = listings.back();
+
+        listing.address = entry.u32( listingAt );
+        entry.str( listingAt + 4, listing.name );
+
+        uint32_t firstLine = entry.u32( listingAt + 12 );
+        uint32_t lineCount = entry.u32( listingAt + 16 );
+        uint32_t low       = entry.u32( listingAt + 20 );
+        uint32_t span      = entry.u32( listingAt + 24 );
+        uint32_t firstWord = entry.u32( listingAt + 28 );
+        uint32_t nop       = entry.u32( listingAt + 32 );
+        listingAt += listingSize;
+
+        if (
+          ( firstLine > lines ) || ( lineCount > lines - firstLine ) ||
+          ( firstWord > words ) || ( span > ( words - firstWord ) / bitmaps )
+        ) {
+          listings.clear();
+          return false;
+        }
+
+        size_t bits = wordsAt + firstWord * 4;
+        size_t at = linesAt + firstLine * listingLineSize;
+
+        listing.instructions.resize( lineCount );
+        for ( auto& line : listing.instructions ) {
+          entry.str( at, line.line );
+          line.address       = entry.u32( at + 8 );
+          line.isInstruction = false;
+          line.isNop         = false;
+          line.nopSize       = 0;
+          line.isBranch      = false;
+          at += listingLineSize;
+
+          uint32_t bit = line.address - low;
+          if (
+            ( line.address < low ) ||
+            ( bit / 32 >= span ) ||
+            !testBit( entry, bits, span, instructionBitmap, bit )
+          ) {
+            continue;
+          }
+
+          line.isInstruction = true;
+          line.isBranch = testBit( entry, bits, span, branchBitmap, bit );
+          if ( testBit( entry, bits, span, nopBitmap, bit ) ) {
+            if ( nop >= nops ) {
+              listings.clear();
+              return false;
+            }
+            line.isNop   = true;
+            line.nopSize = entry.u8( nopsAt + nop++ );
+          }
+        }
+      }
+
+      return true;
+    } catch ( rld::error& ) {
+      listings.clear();
+      return false;
+    }
+  }
+
+  void AnalysisCache::save(
+    uint64_t                                   key,
+    const ObjdumpProcessor::objdumpListings_t& listings,
+    bool                                       endsInListing
+  ) const
+  {
+    /*
+     * The instruction lines of a listing are held in the bitmaps of its
+     * instruction addresses and the sizes of its nops in the order of the
+     * lines. A listing with two instructions at an address, a line that is
+     * not an instruction at an instruction's address or a nop that does not
+     * fit is not saved.
+     */
+    struct Span {
+      uint32_t              low = 0;
+      uint32_t              words = 0;
+      std::vector<uint32_t> bits;
+    };
+
+    std::vector<Span>    spans;
+    std::vector<uint8_t> nopSizes;
+    uint32_t             lines = 0;
+    uint32_t             words = 0;
+
+    for ( const auto& listing : listings ) {
+      uint32_t low = UINT32_MAX;
+      uint32_t high = 0;
+
+      for ( const auto& line : listing.instructions ) {
+        if ( line.isInstruction ) {
+          low = std::min( low, line.address );
+          high = std::max( high, line.address );
+        }
+      }
+
+      spans.push_back( Span() );
+
+      Span& span = spans.back();
+
+      if ( low <= high ) {
+        span.low = low;
+        span.words = ( high - low ) / 32 + 1;
+        span.bits.resize( span.words * bitmaps );
+      }
+
+      auto bit = [&span] ( uint32_t bitmap, uint32_t b ) -> uint32_t& {
+        return span.bits[ bitmap * span.words + b / 32 ];
+      };
+
+      for ( const auto& line : listing.instructions ) {
+        if ( !line.isInstruction ) {
+          continue;
+        }
+
+        uint32_t b = line.address - span.low;
+        uint32_t mask = 1U << ( b % 32 );
+
+        if ( ( bit( instructionBitmap, b ) & mask ) != 0 ) {
+          return;
+        }
+
+        bit( instructionBitmap, b ) |= mask;
+        if ( line.isBranch ) {
+          bit( branchBitmap, b ) |= mask;
+        }
+        if ( line.isNop ) {
+          if ( ( line.nopSize < 0 ) || ( line.nopSize > UINT8_MAX ) ) {
+            return;
+          }
+          bit( nopBitmap, b ) |= mask;
+          nopSizes.push_back( line.nopSize );
+        }
+      }
+
+      for ( const auto& line : listing.instructions ) {
+        uint32_t b = line.address - span.low;
+        if (
+          !line.isInstruction &&
+          ( line.address >= span.low ) &&
+          ( b / 32 < span.words ) &&
+          ( ( bit( instructionBitmap, b ) & ( 1U << ( b % 32 ) ) ) != 0 )
+        ) {
+          return;
+        }
+      }
+
+      lines += listing.instructions.size();
+      words += span.bits.size();
+    }
+
+    EntryWriter entry( listingsEntry, key );
+
+    entry.u32( endsInListing ? 1 : 0 );
+    entry.u32( listings.size() );
+    entry.u32( lines );
+    entry.u32( words );
+    entry.u32( nopSizes.size() );
+
+    entry.array();
+    lines = 0;
+    words = 0;
+    uint32_t nop = 0;
+    auto     span = spans.begin();
+    for ( const auto& listing : listings ) {
+      entry.u32( listing.address );
+      entry.str( listing.name );
+      entry.u32( lines );
+      entry.u32( listing.instructions.size() );
+      entry.u32( span->low );
+      entry.u32( span->words );
+      entry.u32( words );
+      entry.u32( nop );
+      lines += listing.instructions.size();
+      words += span->bits.size();
+      for ( const auto& line : listing.instructions ) {
+        if ( line.isNop ) {
+          ++nop;
+        }
+      }
+      ++span;
+    }
+
+    entry.array();
+    for ( const auto& listing : listings ) {
+      for ( const auto& line : listing.instructions ) {
+        entry.str( line.line );
+        entry.u32( line.address );
+      }
+    }
+
+    entry.array();
+    for ( const auto& s : spans ) {
+      for ( auto w : s.bits ) {
+        entry.u32( w );
+      }
+    }
+
+    entry.array();
+    for ( auto size : nopSizes ) {
+      entry.u8( size );
+    }
+
+    writeEntry( entryPath( key, ".listings" ), entry.finish() );
+  }
+
+  std::string AnalysisCache::entryPath(
+    uint64_t           key,
+    const std::string& extension
+  ) const
+  {
+    std::ostringstream name;
+    std::string        path;
+
+    name << std::hex << std::setfill( '0' ) << std::setw( 16 ) << key
+         << extension;
+
+    rld::path::path_join( directory_m, name.str(), path );
+
+    return path;
+  }
+
+  void AnalysisCache::writeEntry(
+    const std::string& path,
+    const std::string& data
+  ) const
+  {
+    static std::atomic<unsigned int> counter( 0 );
+
+    std::ostringstream temp;
+    temp << path << '.' << ::getpid() << '.' << counter++;
+
+    std::ofstream out( temp.str(), std::ios::out | std::ios::binary );
+    if ( out.is_open() ) {
+      out.write( data.data(), data.size() );
+      out.close();
+    }
+
+    if (
+      !out.good() ||
+      ( ::rename( temp.str().c_str(), path.c_str() ) != 0 )
+    ) {
+      std::cerr << "warning: Unable to write cache entry " << path
+                << std::endl;
+      ::remove( temp.str().c_str() );
+    }
+  }
+
+}
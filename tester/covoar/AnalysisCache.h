@@ -0,0 +1,247 @@
+/*! @file AnalysisCache.h
+ *  @brief AnalysisCache Specification
+ *
+ *  This file contains the specification of the AnalysisCache class.
+ */
+
+#ifndef __ANALYSIS_CACHE_H__
+#define __ANALYSIS_CACHE_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <rld-files.h>
+
+#include "ExecutableInfo.h"
+#include "ObjdumpProcessor.h"
+
+namespace Coverage {
+
+  /*!
+   *  This structure holds the information read from the ELF symbol table
+   *  and the DWARF debug information of an executable. It does not depend
+   *  on the desired symbols so it can be used with any symbol set.
+   */
+  struct ExecutableAnalysis {
+
+    /*!
+     *  This structure is a symbol in the .text section. The name is
+     *  truncated at the first '.' in the same way as the object dump.
+     */
+    struct SymbolStart {
+      uint32_t    address;
+      std::string name;
+    };
+
+    /*!
+     *  This structure is a DWARF line. The path is an index into the
+     *  paths.
+     */
+    struct Line {
+      uint64_t address;
+      uint32_t path;
+      int32_t  line;
+      bool     endSequence;
+    };
+
+    /*!
+     *  This structure holds the lines of a compilation unit.
+     */
+    struct LineRange {
+      uint32_t          low;
+      uint32_t          high;
+      std::vector<Line> lines;
+    };
+
+    /*!
+     *  This structure is a DWARF function that has machine code.
+     */
+    struct Function {
+      std::string compUnit;
+      std::string name;
+      uint64_t    low;
+      uint64_t    high;
+      bool        inlined;
+      bool        external;
+      bool        entryPc;
+    };
+
+    /*!
+     *  This member variable is true if the executable has a .text section.
+     */
+    bool hasText = false;
+
+    /*!
+     *  This member variable contains the address after the .text section.
+     */
+    uint32_t textHigh = 0;
+
+    /*!
+     *  This member variable contains the symbols in the .text section.
+     */
+    std::vector<SymbolStart> symbolStarts;
+
+    /*!
+     *  This member variable contains the source file paths of the lines.
+     */
+    std::vector<std::string> paths;
+
+    /*!
+     *  This member variable contains the lines of each compilation unit.
+     */
+    std::vector<LineRange> lineRanges;
+
+    /*!
+     *  This member variable contains the functions in the order the DWARF
+     *  information holds them.
+     */
+    std::vector<Function> functions;
+  };
+
+  /*! @class AnalysisCache
+   *
+   *  This class manages a directory of analysis results so an unchanged
+   *  executable does not need to be processed again. The analysis of an
+   *  executable is keyed by a hash of its .text, symbol and debug sections
+   *  and the target name. The object dump listings are also keyed by the
+   *  address ranges that were dumped.
+   *
+   *  Each entry is a file of fixed size little-endian records that is
+   *  mapped and read in place. The object dump listings hold bitmaps of
+   *  the instruction starts, nops and branches of each listing. An entry
+   *  is written to a temporary file that is renamed so entries can be
+   *  shared by more than one covoar at the same time. An entry that can
+   *  not be read is ignored.
+   */
+  class AnalysisCache {
+
+  public:
+
+    /*!
+     *  This method constructs an AnalysisCache instance. The directory is
+     *  created if it does not exist.
+     *
+     *  @param[in] directory is the path to the cache directory
+     *  @param[in] target is the name of the target
+     */
+    AnalysisCache(
+      const std::string& directory,
+      const std::string& target
+    );
+
+    /*!
+     *  This method destructs an AnalysisCache instance.
+     */
+    virtual ~AnalysisCache();
+
+    /*!
+     *  This method returns the key of an executable.
+     *
+     *  @param[in] executable is the open executable
+     *
+     *  @return Returns the key of the executable's analysis
+     */
+    uint64_t getKey( rld::files::object& executable ) const;
+
+    /*!
+     *  This method returns the key of the object dump listings of an
+     *  executable for a set of address ranges.
+     *
+     *  @param[in] executableKey is the key of the executable
+     *  @param[in] ranges are the address ranges dumped
+     *
+     *  @return Returns the key of the object dump listings
+     */
+    uint64_t getKey(
+      uint64_t                             executableKey,
+      const ExecutableInfo::DesiredRanges& ranges
+    ) const;
+
+    /*!
+     *  This method loads the analysis of an executable.
+     *
+     *  @param[in] key is the key of the executable
+     *  @param[out] analysis is the analysis of the executable
+     *
+     *  @return Returns TRUE if the analysis was loaded, FALSE otherwise.
+     */
+    bool load( uint64_t key, ExecutableAnalysis& analysis ) const;
+
+    /*!
+     *  This method saves the analysis of an executable.
+     *
+     *  @param[in] key is the key of the executable
+     *  @param[in] analysis is the analysis of the executable
+     */
+    void save( uint64_t key, const ExecutableAnalysis& analysis ) const;
+
+    /*!
+     *  This method loads the object dump listings of an executable.
+     *
+     *  @param[in] key is the key of the object dump listings
+     *  @param[out] listings are the object dump listings
+     *  @param[out] endsInListing is true if the object dump ended in the
+     *              last listing
+     *
+     *  @return Returns TRUE if the listings were loaded, FALSE otherwise.
+     */
+    bool load(
+      uint64_t                             key,
+      ObjdumpProcessor::objdumpListings_t& listings,
+      bool&                                endsInListing
+    ) const;
+
+    /*!
+     *  This method saves the object dump listings of an executable.
+     *
+     *  @param[in] key is the key of the object dump listings
+     *  @param[in] listings are the object dump listings
+     *  @param[in] endsInListing is true if the object dump ended in the
+     *             last listing
+     */
+    void save(
+      uint64_t                                   key,
+      const ObjdumpProcessor::objdumpListings_t& listings,
+      bool                                       endsInListing
+    ) const;
+
+  private:
+
+    /*!
+     *  This method returns the path of an entry.
+     *
+     *  @param[in] key is the key of the entry
+     *  @param[in] extension is the extension of the entry's file
+     *
+     *  @return Returns the path of the entry's file
+     */
+    std::string entryPath(
+      uint64_t           key,
+      const std::string& extension
+    ) const;
+
+    /*!
+     *  This method writes an entry.
+     *
+     *  @param[in] path is the path of the entry's file
+     *  @param[in] data is the entry's data including the header
+     */
+    void writeEntry(
+      const std::string& path,
+      const std::string& data
+    ) const;
+
+    /*!
+     *  The path to the cache directory.
+     */
+    std::string directory_m;
+
+    /*!
+     *  The name of the target.
+     */
+    std::string target_m;
+  };
+
+}
+#endif
@@ -0,0 +1,91 @@
+/*! @file ContentHash.h
+ *  @brief ContentHash Specification
+ *
+ *  This file contains the specification of the ContentHash class.
+ */
+
+#ifndef __CONTENT_HASH_H__
+#define __CONTENT_HASH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+namespace Coverage {
+
+  /*! @class ContentHash
+   *
+   *  This class is a 64-bit FNV-1a hash of data. The value does not depend
+   *  on the host so it can be saved.
+   */
+  class ContentHash {
+
+  public:
+
+    /*!
+     *  This method constructs a ContentHash instance.
+     */
+    ContentHash() : value( 0xcbf29ce484222325ULL )
+    {
+    }
+
+    /*!
+     *  This method adds data to the hash.
+     *
+     *  @param[in] data is the data to add
+     *  @param[in] size is the size of the data in bytes
+     */
+    void add( const void* data, size_t size )
+    {
+      const uint8_t* bytes = static_cast<const uint8_t*>( data );
+      for ( size_t b = 0; b < size; ++b ) {
+        value ^= bytes[ b ];
+        value *= 0x100000001b3ULL;
+      }
+    }
+
+    /*!
+     *  This method adds a string and its size to the hash.
+     *
+     *  @param[in] str is the string to add
+     */
+    void add( const std::string& str )
+    {
+      add( static_cast<uint64_t>( str.size() ) );
+      add( str.data(), str.size() );
+    }
+
+    /*!
+     *  This method adds a value to the hash in little-endian byte order.
+     *
+     *  @param[in] v is the value to add
+     */
+    void add( uint64_t v )
+    {
+      uint8_t bytes[ 8 ];
+      for ( int b = 0; b < 8; ++b ) {
+        bytes[ b ] = static_cast<uint8_t>( v >> ( b * 8 ) );
+      }
+      add( bytes, sizeof( bytes ) );
+    }
+
+    /*!
+     *  This method returns the hash.
+     *
+     *  @return Returns the hash of the data added
+     */
+    uint64_t get() const
+    {
+      return value;
+    }
+
+  private:
+
+    /*!
+     *  The hash of the data added.
+     */
+    uint64_t value;
+  };
+
+}
+#endif
@@ -0,0 +1,962 @@
+/*! @file CoverageDatabase.cc
+ *  @brief CoverageDatabase Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  the database accumulating coverage across runs.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifdef __WIN32__
+#include <io.h>
+#else
+#include <sys/file.h>
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <rld.h>
+
+#include "CoverageDatabase.h"
+#include "CoverageMapBase.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+namespace Coverage {
+
+  /*
+   * The database header's magic and the format version. Change the version
+   * if the layout changes.
+   */
+  static const char     databaseMagic[ 8 ] = {
+    'C', 'O', 'V', 'O', 'A', 'R', 'D', 'B'
+  };
+  static const uint32_t databaseVersion = 3;
+
+  /*
+   * The database header is the magic, the version, the flags, the number
+   * of runs, the number of records, the 64-bit end of the records and the
+   * size of the target. The target follows padded to a word.
+   */
+  static const size_t headerVersion = 8;
+  static const size_t headerFlags = 12;
+  static const size_t headerRuns = 16;
+  static const size_t headerRecords = 20;
+  static const size_t headerEnd = 24;
+  static const size_t headerTargetSize = 32;
+  static const size_t headerSize = 40;
+
+  /*
+   * The flags of the database header.
+   */
+  static const uint32_t branchInfoFlag = 1;
+
+  /*
+   * A record is its size in bytes, the size of the symbol, the size of the
+   * name, the flags and the size of the executable's path. The name and
+   * the path follow each padded to a word and then the executed, taken
+   * and not taken arrays of a word for each byte of the symbol.
+   */
+  static const size_t recordBytes = 0;
+  static const size_t recordSymbolSize = 4;
+  static const size_t recordNameSize = 8;
+  static const size_t recordFlags = 12;
+  static const size_t recordExecutableSize = 16;
+  static const size_t recordHeaderSize = 20;
+
+  /*
+   * The flags of a record.
+   */
+  static const uint32_t recordReplacedFlag = 1;
+
+  /*
+   * The journal is the magic, the number of changes and a hash of the
+   * changes. Each change is the 64-bit offset of a word and its value.
+   */
+  static const char     journalMagic[ 8 ] = {
+    'C', 'O', 'V', 'O', 'A', 'R', 'J', 'L'
+  };
+  static const size_t   journalCount = 8;
+  static const size_t   journalHash = 12;
+  static const size_t   journalHeaderSize = 16;
+  static const size_t   journalChangeSize = 12;
+
+  /*
+   * The index of each of a record's arrays.
+   */
+  enum {
+    executedArray = 0,
+    takenArray = 1,
+    notTakenArray = 2,
+    recordArrays = 3
+  };
+
+  /*
+   * Return the size padded to a word.
+   */
+  static size_t padded( size_t size )
+  {
+    return ( size + 3 ) & ~static_cast<size_t>( 3 );
+  }
+
+  /*
+   * Return the size of a record.
+   */
+  static size_t recordSize(
+    size_t   nameSize,
+    size_t   executableSize,
+    uint32_t symbolSize
+  )
+  {
+    return recordHeaderSize + padded( nameSize ) + padded( executableSize ) +
+      ( (size_t) symbolSize * recordArrays * 4 );
+  }
+
+  /*
+   * Read a word in little-endian byte order.
+   */
+  static uint32_t getWord( const uint8_t* p )
+  {
+    return p[ 0 ] | ( p[ 1 ] << 8 ) | ( p[ 2 ] << 16 ) |
+      ( static_cast<uint32_t>( p[ 3 ] ) << 24 );
+  }
+
+  /*
+   * Write a word in little-endian byte order.
+   */
+  static void putWord( uint8_t* p, uint32_t v )
+  {
+    for ( int b = 0; b < 4; ++b ) {
+      p[ b ] = static_cast<uint8_t>( v >> ( b * 8 ) );
+    }
+  }
+
+  /*
+   * Return a record's array of words.
+   */
+  static uint8_t* recordArray( uint8_t* record, int array )
+  {
+    uint32_t symbolSize = getWord( record + recordSymbolSize );
+    return record + recordHeaderSize +
+      padded( getWord( record + recordNameSize ) ) +
+      padded( getWord( record + recordExecutableSize ) ) +
+      ( (size_t) array * symbolSize * 4 );
+  }
+
+  /*
+   * Return the hash of a journal's changes.
+   */
+  static uint32_t journalHashOf( const uint8_t* changes, size_t size )
+  {
+    uint32_t hash = 2166136261U;
+
+    for ( size_t b = 0; b < size; ++b ) {
+      hash = ( hash ^ changes[ b ] ) * 16777619U;
+    }
+
+    return hash;
+  }
+
+  /*
+   * Write all of a buffer to a file.
+   */
+  static bool writeAll( int fd, const uint8_t* data, size_t size )
+  {
+    while ( size > 0 ) {
+      ssize_t w = ::write( fd, data, size );
+      if ( w < 0 && errno == EINTR ) {
+        continue;
+      }
+      if ( w <= 0 ) {
+        return false;
+      }
+      data += w;
+      size -= w;
+    }
+
+    return true;
+  }
+
+  /*
+   * Read all of a file into a buffer.
+   */
+  static bool readAll( int fd, uint8_t* data, size_t size )
+  {
+    while ( size > 0 ) {
+      ssize_t r = ::read( fd, data, size );
+      if ( r < 0 && errno == EINTR ) {
+        continue;
+      }
+      if ( r <= 0 ) {
+        return false;
+      }
+      data += r;
+      size -= r;
+    }
+
+    return true;
+  }
+
+  /*
+   * Write a file to the disk.
+   */
+  static int syncFile( int fd )
+  {
+#ifdef __WIN32__
+    return ::_commit( fd );
+#else
+    return ::fsync( fd );
+#endif
+  }
+
+  CoverageDatabase::CoverageDatabase(
+    const std::string& file,
+    const std::string& target,
+    bool               readOnly
+  ) : file_m( file ),
+      journal_m( file + ".journal" ),
+      target_m( target ),
+      readOnly_m( readOnly ),
+      fd_m( -1 ),
+      data_m( nullptr ),
+      size_m( 0 ),
+      end_m( 0 ),
+      branchInfoAvailable_m( false ),
+      runs_m( 0 )
+  {
+    try {
+      open();
+    } catch ( ... ) {
+      close();
+      throw;
+    }
+  }
+
+  CoverageDatabase::~CoverageDatabase()
+  {
+    close();
+  }
+
+  void CoverageDatabase::open()
+  {
+    struct stat sb;
+    size_t      offset;
+    uint32_t    records;
+    int         flags = readOnly_m ? O_RDONLY : ( O_RDWR | O_CREAT );
+
+    fd_m = ::open( file_m.c_str(), flags | O_BINARY, 0644 );
+    if ( fd_m < 0 ) {
+      throw rld::error(
+        "Unable to open coverage database: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+
+#ifndef __WIN32__
+    // Wait for any other covoar updating the database.
+    int sc;
+    do {
+      sc = ::flock( fd_m, readOnly_m ? LOCK_SH : LOCK_EX );
+    } while ( ( sc != 0 ) && ( errno == EINTR ) );
+    if ( sc != 0 ) {
+      throw rld::error(
+        "Unable to lock coverage database: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+#endif
+
+    if ( ::fstat( fd_m, &sb ) != 0 ) {
+      throw rld::error(
+        "Unable to stat coverage database: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+
+    if ( sb.st_size != 0 ) {
+      map( sb.st_size );
+      replay();
+    }
+
+    //
+    // The header of a new database is only written when its first update
+    // is committed. A database whose first update was interrupted is
+    // empty.
+    //
+    if (
+      ( size_m >= sizeof( databaseMagic ) ) &&
+      ( data_m[ 0 ] == 0 ) &&
+      ( ::memcmp( data_m, data_m + 1, sizeof( databaseMagic ) - 1 ) == 0 )
+    ) {
+      unmap();
+      if ( !readOnly_m && ( ::ftruncate( fd_m, 0 ) != 0 ) ) {
+        throw rld::error(
+          "Unable to truncate coverage database: " + file_m,
+          "CoverageDatabase::open"
+        );
+      }
+    }
+
+    if ( size_m == 0 ) {
+      create();
+      return;
+    }
+
+    if (
+      ( size_m < headerSize ) ||
+      ( ::memcmp( data_m, databaseMagic, sizeof( databaseMagic ) ) != 0 )
+    ) {
+      throw rld::error(
+        "Not a coverage database: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+
+    if ( getWord( data_m + headerVersion ) != databaseVersion ) {
+      throw rld::error(
+        "Coverage database version does not match: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+
+    branchInfoAvailable_m =
+      ( getWord( data_m + headerFlags ) & branchInfoFlag ) != 0;
+    runs_m = getWord( data_m + headerRuns );
+    records = getWord( data_m + headerRecords );
+    end_m = getWord( data_m + headerEnd ) |
+      ( static_cast<uint64_t>( getWord( data_m + headerEnd + 4 ) ) << 32 );
+
+    size_t targetSize = getWord( data_m + headerTargetSize );
+    offset = headerSize + padded( targetSize );
+
+    if ( ( offset > end_m ) || ( end_m > size_m ) ) {
+      throw rld::error(
+        "Coverage database is truncated: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+
+    std::string target(
+      reinterpret_cast<const char*>( data_m + headerSize ), targetSize
+    );
+    if ( target != target_m ) {
+      throw rld::error(
+        "Coverage database target does not match: " + target,
+        "CoverageDatabase::open"
+      );
+    }
+
+    //
+    // Drop the records an interrupted update was appending. The end in
+    // the header is only moved once the records are written.
+    //
+    if ( !readOnly_m && ( end_m < size_m ) ) {
+      unmap();
+      if ( ::ftruncate( fd_m, end_m ) != 0 ) {
+        throw rld::error(
+          "Unable to truncate coverage database: " + file_m,
+          "CoverageDatabase::open"
+        );
+      }
+      map( end_m );
+    }
+
+    //
+    // Index the records which are not replaced. Only the record headers
+    // and names are read.
+    //
+    for ( ; offset < end_m; --records ) {
+      uint8_t* record = data_m + offset;
+      size_t   bytes;
+
+      if (
+        ( records == 0 ) ||
+        ( ( end_m - offset ) < recordHeaderSize )
+      ) {
+        throw rld::error(
+          "Coverage database records are corrupt: " + file_m,
+          "CoverageDatabase::open"
+        );
+      }
+
+      bytes = getWord( record + recordBytes );
+      if (
+        ( bytes > ( end_m - offset ) ) ||
+        ( bytes != recordSize(
+            getWord( record + recordNameSize ),
+            getWord( record + recordExecutableSize ),
+            getWord( record + recordSymbolSize )
+          ) )
+      ) {
+        throw rld::error(
+          "Coverage database records are corrupt: " + file_m,
+          "CoverageDatabase::open"
+        );
+      }
+
+      if ( ( getWord( record + recordFlags ) & recordReplacedFlag ) == 0 ) {
+        std::string name(
+          reinterpret_cast<const char*>( record + recordHeaderSize ),
+          getWord( record + recordNameSize )
+        );
+        symbols_m[ name ] = offset;
+      }
+
+      offset += bytes;
+    }
+
+    if ( records != 0 ) {
+      throw rld::error(
+        "Coverage database is truncated: " + file_m,
+        "CoverageDatabase::open"
+      );
+    }
+  }
+
+  void CoverageDatabase::create()
+  {
+    std::vector<uint8_t> header( headerSize + padded( target_m.size() ) );
+
+    end_m = header.size();
+    if ( readOnly_m ) {
+      return;
+    }
+
+    ::memcpy( header.data(), databaseMagic, sizeof( databaseMagic ) );
+    putWord( header.data() + headerVersion, databaseVersion );
+    putWord( header.data() + headerEnd, end_m );
+    putWord(
+      header.data() + headerEnd + 4, static_cast<uint64_t>( end_m ) >> 32
+    );
+    putWord( header.data() + headerTargetSize, target_m.size() );
+    ::memcpy( header.data() + headerSize, target_m.data(), target_m.size() );
+
+    for ( size_t offset = 0; offset < header.size(); offset += 4 ) {
+      change( offset, getWord( header.data() + offset ) );
+    }
+  }
+
+  void CoverageDatabase::close()
+  {
+    unmap();
+    if ( fd_m >= 0 ) {
+#ifndef __WIN32__
+      ::flock( fd_m, LOCK_UN );
+#endif
+      ::close( fd_m );
+      fd_m = -1;
+    }
+  }
+
+  void CoverageDatabase::map( size_t size )
+  {
+    struct stat sb;
+
+    if (
+      ( ::fstat( fd_m, &sb ) != 0 ) ||
+      (
+        ( static_cast<size_t>( sb.st_size ) < size ) &&
+        ( readOnly_m || ( ::ftruncate( fd_m, size ) != 0 ) )
+      )
+    ) {
+      throw rld::error(
+        "Unable to extend coverage database: " + file_m,
+        "CoverageDatabase::map"
+      );
+    }
+
+#ifdef __WIN32__
+    buffer_m.resize( size );
+    ::lseek( fd_m, 0, SEEK_SET );
+    if ( !readAll( fd_m, buffer_m.data(), size ) ) {
+      throw rld::error(
+        "Unable to read coverage database: " + file_m,
+        "CoverageDatabase::map"
+      );
+    }
+    data_m = buffer_m.data();
+#else
+    // A database which is only read is mapped privately so a journal can
+    // be written to it without writing the file.
+    void* m = ::mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      readOnly_m ? MAP_PRIVATE : MAP_SHARED,
+      fd_m,
+      0
+    );
+    if ( m == MAP_FAILED ) {
+      throw rld::error(
+        "Unable to map coverage database: " + file_m,
+        "CoverageDatabase::map"
+      );
+    }
+    data_m = static_cast<uint8_t*>( m );
+#endif
+    size_m = size;
+  }
+
+  void CoverageDatabase::unmap()
+  {
+    if ( data_m != nullptr ) {
+#ifdef __WIN32__
+      if ( !readOnly_m ) {
+        ::lseek( fd_m, 0, SEEK_SET );
+        writeAll( fd_m, buffer_m.data(), size_m );
+      }
+      buffer_m.clear();
+#else
+      ::munmap( data_m, size_m );
+#endif
+      data_m = nullptr;
+      size_m = 0;
+    }
+  }
+
+  void CoverageDatabase::sync()
+  {
+    bool ok = true;
+
+    if ( data_m != nullptr ) {
+#ifdef __WIN32__
+      ::lseek( fd_m, 0, SEEK_SET );
+      ok = writeAll( fd_m, buffer_m.data(), size_m );
+#else
+      ok = ::msync( data_m, size_m, MS_SYNC ) == 0;
+#endif
+    }
+
+    if ( !ok || ( syncFile( fd_m ) != 0 ) ) {
+      throw rld::error(
+        "Unable to write coverage database: " + file_m,
+        "CoverageDatabase::sync"
+      );
+    }
+  }
+
+  void CoverageDatabase::replay()
+  {
+    struct stat          sb;
+    std::vector<uint8_t> journal;
+    bool                 complete = false;
+    int                  fd;
+
+    fd = ::open( journal_m.c_str(), O_RDONLY | O_BINARY );
+    if ( fd < 0 ) {
+      return;
+    }
+
+    if (
+      ( ::fstat( fd, &sb ) == 0 ) &&
+      ( static_cast<size_t>( sb.st_size ) >= journalHeaderSize )
+    ) {
+      journal.resize( sb.st_size );
+      if ( readAll( fd, journal.data(), journal.size() ) ) {
+        size_t count = getWord( journal.data() + journalCount );
+        complete =
+          ( ::memcmp(
+              journal.data(), journalMagic, sizeof( journalMagic )
+            ) == 0 ) &&
+          ( journal.size() ==
+            journalHeaderSize + ( count * journalChangeSize ) ) &&
+          ( getWord( journal.data() + journalHash ) ==
+            journalHashOf(
+              journal.data() + journalHeaderSize,
+              journal.size() - journalHeaderSize
+            ) );
+      }
+    }
+
+    ::close( fd );
+
+    //
+    // A journal is only complete once all of it is synced and only then
+    // are its changes written to the database. The changes of an
+    // incomplete journal were not written.
+    //
+    if ( complete ) {
+      for (
+        size_t at = journalHeaderSize;
+        at < journal.size();
+        at += journalChangeSize
+      ) {
+        uint64_t offset = getWord( journal.data() + at ) |
+          ( static_cast<uint64_t>( getWord( journal.data() + at + 4 ) ) << 32 );
+
+        if ( offset + 4 > size_m ) {
+          throw rld::error(
+            "Coverage database journal is corrupt: " + journal_m,
+            "CoverageDatabase::replay"
+          );
+        }
+
+        putWord( data_m + offset, getWord( journal.data() + at + 8 ) );
+      }
+    }
+
+    // A database which is only read leaves the journal for the next
+    // update.
+    if ( readOnly_m ) {
+      return;
+    }
+
+    if ( complete ) {
+      sync();
+    }
+
+    if ( ::unlink( journal_m.c_str() ) != 0 ) {
+      throw rld::error(
+        "Unable to remove coverage database journal: " + journal_m,
+        "CoverageDatabase::replay"
+      );
+    }
+  }
+
+  void CoverageDatabase::change( size_t offset, uint32_t value )
+  {
+    changes_m.push_back( change_t{ offset, value } );
+  }
+
+  void CoverageDatabase::commit()
+  {
+    std::vector<uint8_t> journal;
+    int                  fd;
+    bool                 ok;
+
+    if ( changes_m.empty() ) {
+      return;
+    }
+
+    // The appended records are on the disk before the journal which
+    // moves the end of the records over them.
+    sync();
+
+    journal.resize(
+      journalHeaderSize + ( changes_m.size() * journalChangeSize )
+    );
+    ::memcpy( journal.data(), journalMagic, sizeof( journalMagic ) );
+    putWord( journal.data() + journalCount, changes_m.size() );
+
+    uint8_t* at = journal.data() + journalHeaderSize;
+    for ( const change_t& c : changes_m ) {
+      putWord( at, c.offset );
+      putWord( at + 4, static_cast<uint64_t>( c.offset ) >> 32 );
+      putWord( at + 8, c.value );
+      at += journalChangeSize;
+    }
+
+    putWord(
+      journal.data() + journalHash,
+      journalHashOf(
+        journal.data() + journalHeaderSize,
+        journal.size() - journalHeaderSize
+      )
+    );
+
+    fd = ::open(
+      journal_m.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644
+    );
+    if ( fd < 0 ) {
+      throw rld::error(
+        "Unable to create coverage database journal: " + journal_m,
+        "CoverageDatabase::commit"
+      );
+    }
+
+    ok = writeAll( fd, journal.data(), journal.size() ) &&
+      ( syncFile( fd ) == 0 );
+    ::close( fd );
+    if ( !ok ) {
+      ::unlink( journal_m.c_str() );
+      throw rld::error(
+        "Unable to write coverage database journal: " + journal_m,
+        "CoverageDatabase::commit"
+      );
+    }
+
+    for ( const change_t& c : changes_m ) {
+      putWord( data_m + c.offset, c.value );
+    }
+
+    changes_m.clear();
+    sync();
+
+    if ( ::unlink( journal_m.c_str() ) != 0 ) {
+      throw rld::error(
+        "Unable to remove coverage database journal: " + journal_m,
+        "CoverageDatabase::commit"
+      );
+    }
+  }
+
+  void CoverageDatabase::getExecutables(
+    const DesiredSymbols&               symbolsToAnalyze,
+    const std::vector<ExecutableInfo*>& executables,
+    std::vector<std::string>&           missing
+  ) const
+  {
+    for ( const auto& symbol : symbols_m ) {
+      if ( !symbolsToAnalyze.isDesired( symbol.first ) ) {
+        continue;
+      }
+
+      bool found = false;
+      for ( const auto exe : executables ) {
+        if ( exe->hasCoverageMap( symbol.first ) ) {
+          found = true;
+          break;
+        }
+      }
+      if ( found ) {
+        continue;
+      }
+
+      const uint8_t* record = data_m + symbol.second;
+      std::string    executable(
+        reinterpret_cast<const char*>( record + recordHeaderSize ) +
+          padded( getWord( record + recordNameSize ) ),
+        getWord( record + recordExecutableSize )
+      );
+
+      if (
+        !executable.empty() &&
+        ( std::find( missing.begin(), missing.end(), executable ) ==
+          missing.end() )
+      ) {
+        missing.push_back( executable );
+      }
+    }
+  }
+
+  bool CoverageDatabase::addTo(
+    DesiredSymbols& symbolsToAnalyze,
+    bool            verbose
+  ) const
+  {
+    for ( const auto& symbol : symbolsToAnalyze.allSymbols() ) {
+      CoverageMapBase* map = symbol.second.unifiedCoverageMap;
+
+      symbolRecords_t::const_iterator itr = symbols_m.find( symbol.first );
+      if ( itr == symbols_m.end() ) {
+        continue;
+      }
+
+      if ( map == NULL ) {
+        if ( verbose ) {
+          std::cerr << "INFO: CoverageDatabase::addTo - Unable to add "
+                    << "coverage for " << symbol.first
+                    << " because it is in no executable"
+                    << std::endl;
+        }
+        continue;
+      }
+
+      uint8_t* record = data_m + itr->second;
+      uint32_t size = map->getSize();
+      uint32_t databaseSize = getWord( record + recordSymbolSize );
+
+      if ( databaseSize != size ) {
+        if ( verbose ) {
+          std::cerr << "INFO: CoverageDatabase::addTo - Unable to add "
+                    << "coverage for " << symbol.first
+                    << " because the sizes are different ("
+                    << "size: " << size << ", database: "
+                    << databaseSize << ')'
+                    << std::endl;
+        }
+        continue;
+      }
+
+      const uint8_t* executed = recordArray( record, executedArray );
+      const uint8_t* taken = recordArray( record, takenArray );
+      const uint8_t* notTaken = recordArray( record, notTakenArray );
+
+      for ( uint32_t offset = 0; offset < size; ++offset ) {
+        uint32_t count;
+
+        count = getWord( executed + ( offset * 4 ) );
+        if ( count != 0 ) {
+          map->sumWasExecuted( offset, count );
+        }
+        count = getWord( taken + ( offset * 4 ) );
+        if ( count != 0 ) {
+          map->sumWasTaken( offset, count );
+        }
+        count = getWord( notTaken + ( offset * 4 ) );
+        if ( count != 0 ) {
+          map->sumWasNotTaken( offset, count );
+        }
+      }
+    }
+
+    return branchInfoAvailable_m;
+  }
+
+  void CoverageDatabase::save(
+    const DesiredSymbols& symbolsToAnalyze,
+    bool                  branchInfoAvailable,
+    uint32_t              runs
+  )
+  {
+    typedef std::pair<const std::string*, const SymbolInformation*> append_t;
+
+    std::vector<append_t> appends;
+    size_t                end = end_m;
+
+    if ( readOnly_m ) {
+      throw rld::error(
+        "Coverage database is read only: " + file_m,
+        "CoverageDatabase::save"
+      );
+    }
+
+    //
+    // Queue the counts of the symbols in the database which changed. Only
+    // the words which changed are written so the pages holding the
+    // coverage of the earlier runs are left clean. The symbols which are
+    // new or whose size changed are appended.
+    //
+    for ( const auto& symbol : symbolsToAnalyze.allSymbols() ) {
+      const CoverageMapBase* coverage = symbol.second.unifiedCoverageMap;
+
+      if ( coverage == NULL ) {
+        continue;
+      }
+
+      uint32_t                        size = coverage->getSize();
+      symbolRecords_t::const_iterator itr = symbols_m.find( symbol.first );
+
+      if (
+        ( itr == symbols_m.end() ) ||
+        ( getWord( data_m + itr->second + recordSymbolSize ) != size )
+      ) {
+        const ExecutableInfo* exe = symbol.second.sourceFile;
+        size_t                exeSize =
+          exe == nullptr ? 0 : exe->getFileName().size();
+
+        appends.push_back( append_t( &symbol.first, &symbol.second ) );
+        end += recordSize( symbol.first.size(), exeSize, size );
+        continue;
+      }
+
+      uint8_t* record = data_m + itr->second;
+      size_t   executed = recordArray( record, executedArray ) - data_m;
+      size_t   taken = recordArray( record, takenArray ) - data_m;
+      size_t   notTaken = recordArray( record, notTakenArray ) - data_m;
+
+      for ( uint32_t offset = 0; offset < size; ++offset ) {
+        uint32_t count;
+
+        count = coverage->getWasExecuted( offset );
+        if ( getWord( data_m + executed + ( offset * 4 ) ) != count ) {
+          change( executed + ( offset * 4 ), count );
+        }
+        count = coverage->getWasTaken( offset );
+        if ( getWord( data_m + taken + ( offset * 4 ) ) != count ) {
+          change( taken + ( offset * 4 ), count );
+        }
+        count = coverage->getWasNotTaken( offset );
+        if ( getWord( data_m + notTaken + ( offset * 4 ) ) != count ) {
+          change( notTaken + ( offset * 4 ), count );
+        }
+      }
+    }
+
+    if ( end > size_m ) {
+      unmap();
+      map( end );
+    }
+
+    //
+    // The appended records are written past the end of the records so
+    // they are not part of the database until the header is changed.
+    //
+    size_t next = end_m;
+
+    for ( const append_t& append : appends ) {
+      const std::string&     name = *append.first;
+      const CoverageMapBase* coverage = append.second->unifiedCoverageMap;
+      const ExecutableInfo*  exe = append.second->sourceFile;
+      std::string            executable =
+        exe == nullptr ? std::string() : exe->getFileName();
+      uint32_t               size = coverage->getSize();
+      uint8_t*               record = data_m + next;
+      size_t                 bytes =
+        recordSize( name.size(), executable.size(), size );
+
+      ::memset( record, 0, bytes );
+      putWord( record + recordBytes, bytes );
+      putWord( record + recordSymbolSize, size );
+      putWord( record + recordNameSize, name.size() );
+      putWord( record + recordFlags, 0 );
+      putWord( record + recordExecutableSize, executable.size() );
+      ::memcpy( record + recordHeaderSize, name.data(), name.size() );
+      ::memcpy(
+        record + recordHeaderSize + padded( name.size() ),
+        executable.data(),
+        executable.size()
+      );
+
+      uint8_t* executed = recordArray( record, executedArray );
+      uint8_t* taken = recordArray( record, takenArray );
+      uint8_t* notTaken = recordArray( record, notTakenArray );
+
+      for ( uint32_t offset = 0; offset < size; ++offset ) {
+        putWord( executed + ( offset * 4 ), coverage->getWasExecuted( offset ) );
+        putWord( taken + ( offset * 4 ), coverage->getWasTaken( offset ) );
+        putWord( notTaken + ( offset * 4 ), coverage->getWasNotTaken( offset ) );
+      }
+
+      symbolRecords_t::iterator itr = symbols_m.find( name );
+      if ( itr != symbols_m.end() ) {
+        change(
+          itr->second + recordFlags,
+          getWord( data_m + itr->second + recordFlags ) | recordReplacedFlag
+        );
+      }
+
+      symbols_m[ name ] = next;
+      next += bytes;
+    }
+
+    if ( branchInfoAvailable ) {
+      branchInfoAvailable_m = true;
+    }
+    runs_m += runs;
+
+    //
+    // The header moves the end of the records over the appended records
+    // in the same journalled update as the counts and the replaced
+    // records.
+    //
+    end_m = next;
+    change( headerFlags, branchInfoAvailable_m ? branchInfoFlag : 0 );
+    change( headerRuns, runs_m );
+    change(
+      headerRecords,
+      getWord( data_m + headerRecords ) + appends.size()
+    );
+    change( headerEnd, end_m );
+    change( headerEnd + 4, static_cast<uint64_t>( end_m ) >> 32 );
+
+    commit();
+  }
+
+  uint32_t CoverageDatabase::getRuns() const
+  {
+    return runs_m;
+  }
+
+}
@@ -0,0 +1,257 @@
+/*! @file CoverageDatabase.h
+ *  @brief CoverageDatabase Specification
+ *
+ *  This file contains the specification of the CoverageDatabase class.
+ */
+
+#ifndef __COVERAGE_DATABASE_H__
+#define __COVERAGE_DATABASE_H__
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DesiredSymbols.h"
+#include "ExecutableInfo.h"
+
+namespace Coverage {
+
+  /*! @class CoverageDatabase
+   *
+   *  This class manages a file accumulating the unified coverage maps of
+   *  the desired symbols across covoar runs. Each run adds the coverage of
+   *  its coverage files to the database and reports the totals so coverage
+   *  can be fed in test by test as the tests finish. The totals can also
+   *  be reported from the database alone.
+   *
+   *  The file is a little-endian layout of 32-bit words which is mapped
+   *  into memory and updated in place. A header holds the magic, version,
+   *  flags, number of runs, the end of the records and the target. Each
+   *  symbol is a record holding its name, size and the executable it was
+   *  analysed from and then three arrays of the executed, taken and not
+   *  taken count of each byte of the symbol. A run only writes the counts
+   *  which changed and appends the records of new symbols. A symbol whose
+   *  size changed is appended again and its old record is marked as
+   *  replaced.
+   *
+   *  The appended records are written past the end of the records and
+   *  synced. The words changed in place are then written to a journal
+   *  file which is synced before they are written to the database. A
+   *  journal left by an interrupted update is written to the database when
+   *  it is next opened so the counts and the header always match.
+   *
+   *  The database is locked from when it is opened until it is destructed
+   *  so covoar runs updating the same database wait for each other. A
+   *  host without mmap reads the file into memory and writes all of it
+   *  back and does not lock it.
+   */
+  class CoverageDatabase {
+
+  public:
+
+    /*!
+     *  This method constructs a CoverageDatabase instance. A database
+     *  opened to be updated is created if it does not exist and is locked
+     *  against other updates. A database opened to be read is locked
+     *  against updates only.
+     *
+     *  @param[in] file is the path to the database file
+     *  @param[in] target is the name of the target
+     *  @param[in] readOnly is true if the database is only read
+     */
+    CoverageDatabase(
+      const std::string& file,
+      const std::string& target,
+      bool               readOnly = false
+    );
+
+    /*!
+     *  This method destructs a CoverageDatabase instance unlocking the
+     *  database file.
+     */
+    virtual ~CoverageDatabase();
+
+    /*!
+     *  This method returns the executables the desired symbols in the
+     *  database were analysed from and which are not in any of the
+     *  executables of this run. Analysing them lets the symbols of the
+     *  earlier runs be reported.
+     *
+     *  @param[in] symbolsToAnalyze are the desired symbols
+     *  @param[in] executables are the executables of this run
+     *  @param[out] missing are the executables which are not in the run
+     */
+    void getExecutables(
+      const DesiredSymbols&               symbolsToAnalyze,
+      const std::vector<ExecutableInfo*>& executables,
+      std::vector<std::string>&           missing
+    ) const;
+
+    /*!
+     *  This method adds the counts held in the database to the unified
+     *  coverage maps of the desired symbols. A symbol whose size changed
+     *  since it was added to the database starts again from the counts of
+     *  this run.
+     *
+     *  @param[in] symbolsToAnalyze are the symbols to add the counts to
+     *  @param[in] verbose specifies whether to be verbose with output
+     *
+     *  @return Returns TRUE if the database holds branch information.
+     */
+    bool addTo( DesiredSymbols& symbolsToAnalyze, bool verbose ) const;
+
+    /*!
+     *  This method saves the unified coverage maps of the desired symbols
+     *  as the counts of the database. Only the counts which changed are
+     *  written. The symbols in the database which are not desired symbols
+     *  are kept.
+     *
+     *  @param[in] symbolsToAnalyze are the symbols to save the counts of
+     *  @param[in] branchInfoAvailable is true if there is branch information
+     *  @param[in] runs is the number of coverage files of this run
+     */
+    void save(
+      const DesiredSymbols& symbolsToAnalyze,
+      bool                  branchInfoAvailable,
+      uint32_t              runs
+    );
+
+    /*!
+     *  This method returns the number of coverage files in the database.
+     */
+    uint32_t getRuns() const;
+
+  private:
+
+    /*!
+     *  This type maps a symbol name to the offset of its record.
+     */
+    typedef std::map<std::string, size_t> symbolRecords_t;
+
+    /*!
+     *  This type is a word to write to the database file and its offset.
+     */
+    struct change_t {
+      size_t   offset;
+      uint32_t value;
+    };
+
+    /*!
+     *  This method opens, locks and reads the database file.
+     */
+    void open();
+
+    /*!
+     *  This method starts an empty database.
+     */
+    void create();
+
+    /*!
+     *  This method unmaps, unlocks and closes the database file.
+     */
+    void close();
+
+    /*!
+     *  This method maps the database file at @p size bytes. The file is
+     *  extended if it is smaller.
+     */
+    void map( size_t size );
+
+    /*!
+     *  This method unmaps the database file.
+     */
+    void unmap();
+
+    /*!
+     *  This method writes the mapped database file to the disk.
+     */
+    void sync();
+
+    /*!
+     *  This method writes a journal left by an interrupted update to the
+     *  mapped database file. An incomplete journal is dropped.
+     */
+    void replay();
+
+    /*!
+     *  This method queues a word to be written to the database file.
+     */
+    void change( size_t offset, uint32_t value );
+
+    /*!
+     *  This method journals and writes the queued words to the database
+     *  file.
+     */
+    void commit();
+
+    /*!
+     *  The path to the database file.
+     */
+    std::string file_m;
+
+    /*!
+     *  The path to the database's journal file.
+     */
+    std::string journal_m;
+
+    /*!
+     *  The name of the target.
+     */
+    std::string target_m;
+
+    /*!
+     *  This member variable is true if the database is only read.
+     */
+    bool readOnly_m;
+
+    /*!
+     *  The database file's descriptor.
+     */
+    int fd_m;
+
+    /*!
+     *  The mapped database file.
+     */
+    uint8_t* data_m;
+
+    /*!
+     *  The size of the mapped database file.
+     */
+    size_t size_m;
+
+    /*!
+     *  The end of the records in the database file.
+     */
+    size_t end_m;
+
+    /*!
+     *  This member variable is true if the database holds branch
+     *  information.
+     */
+    bool branchInfoAvailable_m;
+
+    /*!
+     *  The number of coverage files in the database.
+     */
+    uint32_t runs_m;
+
+    /*!
+     *  The record of each symbol in the database.
+     */
+    symbolRecords_t symbols_m;
+
+    /*!
+     *  The words to write to the database file when the update is
+     *  committed.
+     */
+    std::vector<change_t> changes_m;
+
+    /*!
+     *  The database file read on a host without mmap.
+     */
+    std::vector<uint8_t> buffer_m;
+  };
+
+}
+#endif
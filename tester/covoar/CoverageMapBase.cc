@@ -8,6 +8,8 @@
 
 #include <limits.h>
 
+#include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <iomanip>
 
@@ -18,13 +20,90 @@
 
 namespace Coverage {
 
-  AddressInfo::AddressInfo()
-    : isStartOfInstruction( false ),
-      wasExecuted( false ),
-      isBranch( false ),
-      isNop( false ),
-      wasTaken( false ),
-      wasNotTaken( false )
+  /*
+   * Returns the index of the lowest set bit of a non-zero word.
+   */
+  static size_t lowestBit( uint64_t word )
+  {
+#if defined( __GNUC__ )
+    return __builtin_ctzll( word );
+#else
+    size_t bit = 0;
+    while ( ( word & 1 ) == 0 ) {
+      word >>= 1;
+      ++bit;
+    }
+    return bit;
+#endif
+  }
+
+  /*
+   * Returns a mask of the bits from @p first up to but not including
+   * @p last of a word.
+   */
+  static uint64_t wordMask( size_t first, size_t last )
+  {
+    uint64_t high = ( last >= 64 ) ? ~( (uint64_t) 0 ) :
+      ( ( (uint64_t) 1 ) << last ) - 1;
+    return high & ~( ( ( (uint64_t) 1 ) << first ) - 1 );
+  }
+
+  void AddressBits::resize( size_t count )
+  {
+    bits.assign( ( count + 63 ) / 64, 0 );
+  }
+
+  void AddressBits::set( size_t slot, size_t count )
+  {
+    size_t last = slot + count;
+
+    while ( slot < last ) {
+      size_t w = slot / 64;
+      size_t end = std::min( last, ( w + 1 ) * 64 );
+      bits[w] |= wordMask( slot % 64, end - w * 64 );
+      slot = end;
+    }
+  }
+
+  size_t AddressBits::find( size_t first, size_t last, bool value ) const
+  {
+    size_t slot = first;
+
+    while ( slot < last ) {
+      size_t   w = slot / 64;
+      size_t   end = std::min( last, ( w + 1 ) * 64 );
+      uint64_t word = value ? bits[w] : ~bits[w];
+
+      word &= wordMask( slot % 64, end - w * 64 );
+      if ( word != 0 ) {
+        return w * 64 + lowestBit( word );
+      }
+      slot = end;
+    }
+
+    return last;
+  }
+
+  size_t AddressBits::count( size_t first, size_t last ) const
+  {
+    size_t slot = first;
+    size_t total = 0;
+
+    while ( slot < last ) {
+      size_t w = slot / 64;
+      size_t end = std::min( last, ( w + 1 ) * 64 );
+      total += std::bitset<64>(
+        bits[w] & wordMask( slot % 64, end - w * 64 )
+      ).count();
+      slot = end;
+    }
+
+    return total;
+  }
+
+  BranchInfo::BranchInfo()
+    : wasTaken( 0 ),
+      wasNotTaken( 0 )
   {
   }
 
@@ -42,7 +121,10 @@ namespace Coverage {
       lowAddress( lowAddress ),
       highAddress( highAddress )
   {
-    info.resize( size() );
+    startOfInstruction.resize( size() );
+    branch.resize( size() );
+    nop.resize( size() );
+    executed.resize( size() );
   }
 
   size_t AddressRange::size() const
@@ -55,34 +137,231 @@ namespace Coverage {
     return address >= lowAddress && address <= highAddress;
   }
 
-  AddressInfo& AddressRange::get( uint32_t address )
+  size_t AddressRange::slot( uint32_t address ) const
   {
     if ( !inside( address ) ) {
-      throw rld::error( "address outside range", "AddressRange::get" );
+      throw rld::error( "address outside range", "AddressRange::slot" );
     }
 
-    size_t slot = address - lowAddress;
+    return address - lowAddress;
+  }
+
+  bool AddressRange::isStartOfInstruction( uint32_t address ) const
+  {
+    return startOfInstruction.test( slot( address ) );
+  }
 
-    if ( slot >= info.size () ) {
-      throw rld::error( "address slot not found", "AddressRange::get" );
+  void AddressRange::setIsStartOfInstruction( uint32_t address )
+  {
+    startOfInstruction.set( slot( address ) );
+  }
+
+  bool AddressRange::isBranch( uint32_t address ) const
+  {
+    return branch.test( slot( address ) );
+  }
+
+  void AddressRange::setIsBranch( uint32_t address )
+  {
+    branch.set( slot( address ) );
+  }
+
+  bool AddressRange::isNop( uint32_t address ) const
+  {
+    return nop.test( slot( address ) );
+  }
+
+  void AddressRange::setIsNop( uint32_t address )
+  {
+    nop.set( slot( address ) );
+  }
+
+  bool AddressRange::wasExecuted( uint32_t address ) const
+  {
+    return executed.test( slot( address ) );
+  }
+
+  uint32_t AddressRange::getWasExecuted( uint32_t address ) const
+  {
+    size_t s = slot( address );
+
+    if ( executionCounts.empty() ) {
+      return 0;
     }
 
-    return info[slot];
+    return executionCounts[s];
   }
 
-  const AddressInfo& AddressRange::get( uint32_t address ) const
+  void AddressRange::sumWasExecuted( uint32_t address, uint32_t addition )
   {
-    if ( !inside( address ) ) {
-      throw rld::error( "address outside range", "AddressRange::get" );
+    size_t s = slot( address );
+
+    if ( addition == 0 ) {
+      return;
+    }
+
+    if ( executionCounts.empty() ) {
+      executionCounts.resize( size() );
+    }
+
+    executed.set( s );
+    executionCounts[s] += addition;
+  }
+
+  void AddressRange::sumWasExecuted(
+    uint32_t low,
+    uint32_t high,
+    uint32_t addition
+  )
+  {
+    size_t first = slot( low );
+    size_t last = slot( high ) + 1;
+
+    if ( addition == 0 || first >= last ) {
+      return;
+    }
+
+    if ( executionCounts.empty() ) {
+      executionCounts.resize( size() );
     }
 
-    size_t slot = address - lowAddress;
+    executed.set( first, last - first );
+    for ( size_t s = first; s < last; ++s ) {
+      executionCounts[s] += addition;
+    }
+  }
 
-    if ( slot >= info.size() ) {
-      throw rld::error( "address slot not found", "AddressRange::get" );
+  bool AddressRange::findStartOfInstruction(
+    uint32_t  low,
+    uint32_t  high,
+    uint32_t& start
+  ) const
+  {
+    size_t last = slot( high ) + 1;
+    size_t s = startOfInstruction.find( slot( low ), last, true );
+
+    if ( s >= last ) {
+      return false;
+    }
+
+    start = lowAddress + s;
+    return true;
+  }
+
+  bool AddressRange::findWasExecuted(
+    uint32_t  low,
+    uint32_t  high,
+    bool      executed_,
+    uint32_t& address
+  ) const
+  {
+    size_t last = slot( high ) + 1;
+    size_t s = executed.find( slot( low ), last, executed_ );
+
+    if ( s >= last ) {
+      return false;
     }
 
-    return info[slot];
+    address = lowAddress + s;
+    return true;
+  }
+
+  bool AddressRange::findIsBranch(
+    uint32_t  low,
+    uint32_t  high,
+    uint32_t& address
+  ) const
+  {
+    size_t last = slot( high ) + 1;
+    size_t s = branch.find( slot( low ), last, true );
+
+    if ( s >= last ) {
+      return false;
+    }
+
+    address = lowAddress + s;
+    return true;
+  }
+
+  uint32_t AddressRange::countStartsOfInstruction(
+    uint32_t low,
+    uint32_t high
+  ) const
+  {
+    return startOfInstruction.count( slot( low ), slot( high ) + 1 );
+  }
+
+  uint32_t AddressRange::countWasExecuted( uint32_t low, uint32_t high ) const
+  {
+    return executed.count( slot( low ), slot( high ) + 1 );
+  }
+
+  void AddressRange::countInstructions(
+    uint32_t           low,
+    uint32_t           high,
+    InstructionCounts& counts
+  ) const
+  {
+    size_t slot = this->slot( low );
+    size_t last = this->slot( high ) + 1;
+
+    while ( slot < last ) {
+      size_t   w = slot / 64;
+      size_t   end = std::min( last, ( w + 1 ) * 64 );
+      uint64_t mask = wordMask( slot % 64, end - w * 64 );
+      uint64_t starts = startOfInstruction.word( w ) & mask;
+      uint64_t ran = executed.word( w ) & mask;
+      uint64_t branches = starts & branch.word( w );
+
+      counts.instructions += std::bitset<64>( starts ).count();
+      counts.notExecuted += std::bitset<64>( starts & ~ran ).count();
+      counts.branchesExecuted += std::bitset<64>( branches & ran ).count();
+      counts.branchesNotExecuted +=
+        std::bitset<64>( branches & ~ran ).count();
+      counts.executedBytes += std::bitset<64>( ran ).count();
+
+      slot = end;
+    }
+  }
+
+  uint32_t AddressRange::getWasTaken( uint32_t address ) const
+  {
+    BranchInfos::const_iterator bi = branches.find( slot( address ) );
+
+    if ( bi == branches.end() ) {
+      return 0;
+    }
+
+    return bi->second.wasTaken;
+  }
+
+  void AddressRange::sumWasTaken( uint32_t address, uint32_t addition )
+  {
+    size_t s = slot( address );
+
+    if ( addition != 0 ) {
+      branches[s].wasTaken += addition;
+    }
+  }
+
+  uint32_t AddressRange::getWasNotTaken( uint32_t address ) const
+  {
+    BranchInfos::const_iterator bi = branches.find( slot( address ) );
+
+    if ( bi == branches.end() ) {
+      return 0;
+    }
+
+    return bi->second.wasNotTaken;
+  }
+
+  void AddressRange::sumWasNotTaken( uint32_t address, uint32_t addition )
+  {
+    size_t s = slot( address );
+
+    if ( addition != 0 ) {
+      branches[s].wasNotTaken += addition;
+    }
   }
 
   void AddressRange::dump( std::ostream& out, bool show_slots ) const
@@ -95,21 +374,20 @@ namespace Coverage {
         << std::endl;
 
     if (show_slots) {
-      size_t slot = 0;
-
-      for ( auto& i : info ) {
+      for ( size_t slot = 0; slot < size(); ++slot ) {
+        uint32_t address = lowAddress + slot;
         out << std::hex << std::setfill( '0' )
-            << "0x" << std::setw( 8 ) << slot++ + lowAddress
+            << "0x" << std::setw( 8 ) << address
             << "- isStartOfInstruction:"
-            << (char*) ( i.isStartOfInstruction ? "yes" : "no" )
+            << (char*) ( isStartOfInstruction( address ) ? "yes" : "no" )
             << " wasExecuted:"
-            << (char*) ( i.wasExecuted ? "yes" : "no" )
+            << (char*) ( wasExecuted( address ) ? "yes" : "no" )
             << "\n           isBranch:"
-            << (char*) ( i.isBranch ? "yes" : "no" )
+            << (char*) ( isBranch( address ) ? "yes" : "no" )
             << " wasTaken:"
-            << (char*) ( i.wasTaken ? "yes" : "no" )
+            << (char*) ( getWasTaken( address ) ? "yes" : "no" )
             << " wasNotTaken:"
-            << (char*) ( i.wasNotTaken ? "yes" : "no" )
+            << (char*) ( getWasNotTaken( address ) ? "yes" : "no" )
             << std::dec << std::setfill( ' ' )
             << std::endl;
       }
@@ -129,6 +407,16 @@ namespace Coverage {
   {
   }
 
+  CoverageMapBase::const_iterator CoverageMapBase::begin() const
+  {
+    return Ranges.begin();
+  }
+
+  CoverageMapBase::const_iterator CoverageMapBase::end() const
+  {
+    return Ranges.end();
+  }
+
   void CoverageMapBase::Add( uint32_t low, uint32_t high )
   {
     Ranges.push_back( AddressRange( exefileName, low, high ) );
@@ -175,19 +463,18 @@ namespace Coverage {
     uint32_t* beginning
   ) const
   {
-    bool         status = false;
-    uint32_t     start;
-    AddressRange range;
+    bool                status = false;
+    uint32_t            start;
+    const AddressRange* range = getRange( address );
 
-    status = getRange( address, range );
-    if ( status != true ) {
+    if ( range == nullptr ) {
       return status;
     }
 
     start = address;
 
-    while ( start >= range.lowAddress ) {
-      if ( isStartOfInstruction( start - range.lowAddress ) ) {
+    while ( start >= range->lowAddress ) {
+      if ( isStartOfInstruction( start - range->lowAddress ) ) {
         *beginning = start;
         status = true;
         break;
@@ -212,223 +499,422 @@ namespace Coverage {
     return Ranges.at( index ).lowAddress;
   }
 
-  bool CoverageMapBase::getRange( uint32_t address, AddressRange& range ) const
+  const AddressRange* CoverageMapBase::getRange( uint32_t address ) const
   {
-    for ( auto r : Ranges ) {
+    for ( auto& r : Ranges ) {
       if ( r.inside( address ) ) {
-        range.lowAddress  = r.lowAddress;
-        range.highAddress = r.highAddress;
-        range.info        = r.info;
-        return true;
+        return &r;
       }
     }
 
-    return false;
+    return nullptr;
   }
 
-  AddressInfo& CoverageMapBase::getInfo( uint32_t address )
+  AddressRange* CoverageMapBase::findRange( uint32_t address )
   {
     for ( auto& r : Ranges ) {
       if ( r.inside( address ) ) {
-        return r.get( address );
+        return &r;
       }
     }
 
-    throw rld::error( "address out of bounds", "CoverageMapBase::getInfo" );
+    return nullptr;
   }
 
-  const AddressInfo& CoverageMapBase::getInfo( uint32_t address ) const
+  size_t CoverageMapBase::getSegment( uint32_t address, uint32_t& last ) const
   {
-    for ( auto& r : Ranges ) {
-      if ( r.inside( address ) ) {
-        return r.get( address );
+    size_t index = Ranges.size();
+
+    // The first range holding the address holds the run up to its end or
+    // up to an earlier range starting after the address.
+    last = UINT32_MAX;
+    for ( size_t r = 0; r < Ranges.size(); ++r ) {
+      const AddressRange& range = Ranges[r];
+      if ( range.inside( address ) ) {
+        last = std::min( last, range.highAddress );
+        index = r;
+        break;
+      }
+      if ( range.lowAddress > address ) {
+        last = std::min( last, range.lowAddress - 1 );
       }
     }
 
-    throw rld::error( "address out of bounds", "CoverageMapBase::getInfo" );
+    // Without a range the run ends before the next range.
+    if ( index == Ranges.size() ) {
+      for ( const auto& range : Ranges ) {
+        if ( range.lowAddress > address ) {
+          last = std::min( last, range.lowAddress - 1 );
+        }
+      }
+    }
+
+    return index;
+  }
+
+  void CoverageMapBase::setBlockWasExecuted( uint32_t address, uint32_t size )
+  {
+    uint32_t high;
+    uint32_t last;
+
+    if ( size == 0 ) {
+      return;
+    }
+
+    high = address + size - 1;
+    if ( high < address ) {
+      high = UINT32_MAX;
+    }
+
+    while ( true ) {
+      size_t index = getSegment( address, last );
+      last = std::min( last, high );
+      if ( index < Ranges.size() ) {
+        Ranges[index].sumWasExecuted( address, last, 1 );
+      }
+      if ( last == high ) {
+        break;
+      }
+      address = last + 1;
+    }
+  }
+
+  bool CoverageMapBase::findStartOfInstruction(
+    uint32_t  low,
+    uint32_t  high,
+    uint32_t& start
+  ) const
+  {
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if (
+        ( index < Ranges.size() ) &&
+        Ranges[index].findStartOfInstruction( low, last, start )
+      ) {
+        return true;
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
+
+    return false;
+  }
+
+  bool CoverageMapBase::findWasExecuted(
+    uint32_t  low,
+    uint32_t  high,
+    bool      executed,
+    uint32_t& address
+  ) const
+  {
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if ( index < Ranges.size() ) {
+        if ( Ranges[index].findWasExecuted( low, last, executed, address ) ) {
+          return true;
+        }
+      } else if ( !executed ) {
+        // An address outside of the ranges was not executed.
+        address = low;
+        return true;
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
+
+    return false;
+  }
+
+  bool CoverageMapBase::findIsBranch(
+    uint32_t  low,
+    uint32_t  high,
+    uint32_t& address
+  ) const
+  {
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if (
+        ( index < Ranges.size() ) &&
+        Ranges[index].findIsBranch( low, last, address )
+      ) {
+        return true;
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
+
+    return false;
+  }
+
+  uint32_t CoverageMapBase::countStartsOfInstruction(
+    uint32_t low,
+    uint32_t high
+  ) const
+  {
+    uint32_t count = 0;
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if ( index < Ranges.size() ) {
+        count += Ranges[index].countStartsOfInstruction( low, last );
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
+
+    return count;
+  }
+
+  uint32_t CoverageMapBase::countWasExecuted(
+    uint32_t low,
+    uint32_t high
+  ) const
+  {
+    uint32_t count = 0;
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if ( index < Ranges.size() ) {
+        count += Ranges[index].countWasExecuted( low, last );
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
+
+    return count;
+  }
+
+  void CoverageMapBase::countInstructions(
+    uint32_t           low,
+    uint32_t           high,
+    InstructionCounts& counts
+  ) const
+  {
+    uint32_t last;
+
+    while ( low <= high ) {
+      size_t index = getSegment( low, last );
+      last = std::min( last, high );
+      if ( index < Ranges.size() ) {
+        Ranges[index].countInstructions( low, last, counts );
+      }
+      if ( last == high ) {
+        break;
+      }
+      low = last + 1;
+    }
   }
 
   void CoverageMapBase::setIsStartOfInstruction( uint32_t  address )
   {
-    if ( validAddress( address ) ) {
-      getInfo( address ).isStartOfInstruction = true;
+    AddressRange* range = findRange( address );
+
+    if ( range != nullptr ) {
+      range->setIsStartOfInstruction( address );
     }
   }
 
   bool CoverageMapBase::isStartOfInstruction( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return false;
     }
 
-    return getInfo( address ).isStartOfInstruction;
+    return range->isStartOfInstruction( address );
   }
 
   void CoverageMapBase::setWasExecuted( uint32_t address )
   {
-    if ( validAddress( address ) ) {
-      getInfo( address ).wasExecuted += 1;
+    AddressRange* range = findRange( address );
+
+    if ( range != nullptr ) {
+      range->sumWasExecuted( address, 1 );
     }
   }
 
   void CoverageMapBase::sumWasExecuted( uint32_t address, uint32_t addition )
   {
-    if ( validAddress( address ) ) {
-      getInfo( address ).wasExecuted += addition;
+    AddressRange* range = findRange( address );
+
+    if ( range != nullptr ) {
+      range->sumWasExecuted( address, addition );
     }
   }
 
   bool CoverageMapBase::wasExecuted( uint32_t address ) const
   {
-    bool result = false;
-
-    if ( validAddress( address ) && ( getInfo( address ).wasExecuted > 0 ) ) {
-      result = true;
-    }
+    const AddressRange* range = getRange( address );
 
-    return result;
+    return range != nullptr && range->wasExecuted( address );
   }
 
   uint32_t CoverageMapBase::getWasExecuted( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return 0;
     }
 
-    return getInfo( address ).wasExecuted;
+    return range->getWasExecuted( address );
   }
 
   void CoverageMapBase::setIsBranch( uint32_t address )
   {
-    if ( validAddress( address ) ) {
-      getInfo( address ).isBranch = true;
+    AddressRange* range = findRange( address );
+
+    if ( range != nullptr ) {
+      range->setIsBranch( address );
     }
   }
 
   bool CoverageMapBase::isNop( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return false;
     }
 
-    return getInfo( address ).isNop;
+    return range->isNop( address );
   }
 
   void CoverageMapBase::setIsNop( uint32_t address )
   {
-    if ( !validAddress( address ) ) {
-      return;
-    }
+    AddressRange* range = findRange( address );
 
-    getInfo( address ).isNop = true;
+    if ( range != nullptr ) {
+      range->setIsNop( address );
+    }
   }
 
   bool CoverageMapBase::isBranch( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return false;
     }
 
-    return getInfo( address ).isBranch;
+    return range->isBranch( address );
   }
 
   void CoverageMapBase::setWasTaken( uint32_t address )
   {
-    if ( !validAddress( address ) ) {
-      return;
-    }
+    AddressRange* range = findRange( address );
 
-    getInfo( address ).wasTaken += 1;
+    if ( range != nullptr ) {
+      range->sumWasTaken( address, 1 );
+    }
   }
 
   void CoverageMapBase::setWasNotTaken( uint32_t address )
   {
-    if ( !validAddress( address ) ) {
-      return;
-    }
+    AddressRange* range = findRange( address );
 
-    getInfo( address ).wasNotTaken += 1;
+    if ( range != nullptr ) {
+      range->sumWasNotTaken( address, 1 );
+    }
   }
 
   bool CoverageMapBase::wasAlwaysTaken( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return false;
     }
 
-    const AddressInfo& info = getInfo( address );
-
-    return info.wasTaken && !info.wasNotTaken;
+    return range->getWasTaken( address ) && !range->getWasNotTaken( address );
   }
 
   bool CoverageMapBase::wasNeverTaken( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return false;
     }
 
-    const AddressInfo& info = getInfo( address );
-
-    return !info.wasTaken && info.wasNotTaken;
+    return !range->getWasTaken( address ) && range->getWasNotTaken( address );
   }
 
   bool CoverageMapBase::wasNotTaken( uint32_t address ) const
   {
-    bool result = true;
-
-    if ( !validAddress( address ) ) {
-      result = false;
-    } else if ( getInfo( address ).wasNotTaken <= 0 ) {
-      result = false;
-    }
+    const AddressRange* range = getRange( address );
 
-    return result;
+    return range != nullptr && range->getWasNotTaken( address ) > 0;
   }
 
   void CoverageMapBase::sumWasNotTaken( uint32_t address, uint32_t addition )
   {
-    if ( validAddress( address ) ) {
-      getInfo( address ).wasNotTaken += addition;
+    AddressRange* range = findRange( address );
+
+    if ( range != nullptr ) {
+      range->sumWasNotTaken( address, addition );
     }
   }
 
   uint32_t CoverageMapBase::getWasNotTaken( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return 0;
     }
 
-    return getInfo( address ).wasNotTaken;
+    return range->getWasNotTaken( address );
   }
 
   bool CoverageMapBase::wasTaken( uint32_t address ) const
   {
-    bool result = true;
-
-    if ( !validAddress( address ) ) {
-      result = false;
-    } else if ( getInfo( address ).wasTaken <= 0 ) {
-      result = false;
-    }
+    const AddressRange* range = getRange( address );
 
-    return result;
+    return range != nullptr && range->getWasTaken( address ) > 0;
   }
 
   void CoverageMapBase::sumWasTaken( uint32_t address, uint32_t addition )
   {
-    if ( !validAddress( address ) ) {
-      return;
-    }
+    AddressRange* range = findRange( address );
 
-    getInfo( address ).wasTaken += addition;
+    if ( range != nullptr ) {
+      range->sumWasTaken( address, addition );
+    }
   }
 
   uint32_t CoverageMapBase::getWasTaken( uint32_t address ) const
   {
-    if ( !validAddress( address ) ) {
+    const AddressRange* range = getRange( address );
+
+    if ( range == nullptr ) {
       return 0;
     }
 
-    return getInfo( address ).wasTaken;
+    return range->getWasTaken( address );
   }
 }
@@ -8,6 +8,7 @@
 #define __COVERAGE_MAP_BASE_H__
 
 #include <stdint.h>
+#include <map>
 #include <string>
 #include <vector>
 #include <list>
@@ -15,54 +16,145 @@
 namespace Coverage {
 
   /*!
-   *  This structure defines the information that is gathered and
-   *  tracked per address.
+   *  This class holds one bit of information for each address of an
+   *  address range.
    */
-  struct AddressInfo {
+  class AddressBits {
 
-    AddressInfo ();
+  public:
+
+    /*!
+     *  This method sizes the bits to hold @p count slots. All slots are
+     *  clear.
+     */
+    void resize( size_t count );
+
+    /*!
+     *  This method returns true if the bit for the slot is set.
+     */
+    bool test( size_t slot ) const
+    {
+      return ( bits[slot / 64] & ( ( (uint64_t) 1 ) << ( slot % 64 ) ) ) != 0;
+    }
+
+    /*!
+     *  This method sets the bit for the slot.
+     */
+    void set( size_t slot )
+    {
+      bits[slot / 64] |= ( (uint64_t) 1 ) << ( slot % 64 );
+    }
 
     /*!
-     *  This member indicates that the address is the start of
-     *  an instruction.
+     *  This method sets the bits of @p count slots from @p slot.
      */
-    bool isStartOfInstruction;
+    void set( size_t slot, size_t count );
 
     /*!
-     *  This member indicates how many times the address was executed.
+     *  This method returns the first slot from @p first up to but not
+     *  including @p last whose bit is @p value, or @p last if there is
+     *  none.
      */
-    uint32_t wasExecuted;
+    size_t find( size_t first, size_t last, bool value ) const;
 
     /*!
-     *  This member indicates that the address is a branch instruction.
+     *  This method returns the number of bits set from slot @p first up
+     *  to but not including @p last.
      */
-    bool isBranch;
+    size_t count( size_t first, size_t last ) const;
 
     /*!
-     *  This member indicates that the address is a NOP instruction.
+     *  This method returns the number of 64-bit words holding the bits.
      */
-    bool isNop;
+    size_t words() const
+    {
+      return bits.size();
+    }
 
     /*!
-     *  When isBranch is TRUE, this member indicates that the branch
-     *  instruction at the address was taken.
+     *  This method returns a 64-bit word of bits. Bit 0 of word @p w is
+     *  slot 64 * @p w.
+     */
+    uint64_t word( size_t w ) const
+    {
+      return bits[w];
+    }
+
+  private:
+
+    std::vector<uint64_t> bits;
+
+  };
+
+  /*!
+   *  This structure holds the counters of a branch instruction.
+   */
+  struct BranchInfo {
+
+    BranchInfo ();
+
+    /*!
+     *  This member indicates how many times the branch was taken.
      */
     uint32_t wasTaken;
 
     /*!
-     *  When isBranch is TRUE, this member indicates that the branch
-     *  instruction at the address was NOT taken.
+     *  This member indicates how many times the branch was NOT taken.
      */
     uint32_t wasNotTaken;
 
   };
 
-  typedef std::vector<AddressInfo> AddressInfos;
+  /*!
+   *  This type maps the slot of a branch instruction to its counters.
+   */
+  typedef std::map<uint32_t, BranchInfo> BranchInfos;
+
+  /*!
+   *  This structure holds the counts of the instructions and executed
+   *  addresses of a span of addresses. Branches are only counted at the
+   *  start of an instruction.
+   */
+  struct InstructionCounts {
+
+    /*!
+     *  This member is the number of instructions.
+     */
+    uint32_t instructions = 0;
+
+    /*!
+     *  This member is the number of instructions not executed.
+     */
+    uint32_t notExecuted = 0;
+
+    /*!
+     *  This member is the number of branch instructions executed.
+     */
+    uint32_t branchesExecuted = 0;
+
+    /*!
+     *  This member is the number of branch instructions not executed.
+     */
+    uint32_t branchesNotExecuted = 0;
+
+    /*!
+     *  This member is the number of addresses executed.
+     */
+    uint32_t executedBytes = 0;
+
+  };
 
   /*!
    *  This structure identifies the low and high addresses
    *  of one range.  Note:: There may be more than one address
    *  range per symbol.
+   *
+   *  The information tracked per address is held compactly. The
+   *  instruction start, branch, NOP and executed flags are bits per
+   *  address. The execution count of each address is held once an
+   *  address of the range is executed, so a range which never ran only
+   *  holds the bits. Branch counters are held for the addresses that have
+   *  them.
    */
   struct AddressRange {
 
@@ -77,11 +169,68 @@ namespace Coverage {
 
     bool inside( uint32_t address ) const;
 
-    AddressInfo& get( uint32_t address );
+    void dump( std::ostream& out, bool show_slots = false ) const;
 
-    const AddressInfo& get( uint32_t address ) const;
+    bool isStartOfInstruction( uint32_t address ) const;
 
-    void dump( std::ostream& out, bool show_slots = false ) const;
+    void setIsStartOfInstruction( uint32_t address );
+
+    bool isBranch( uint32_t address ) const;
+
+    void setIsBranch( uint32_t address );
+
+    bool isNop( uint32_t address ) const;
+
+    void setIsNop( uint32_t address );
+
+    bool wasExecuted( uint32_t address ) const;
+
+    uint32_t getWasExecuted( uint32_t address ) const;
+
+    void sumWasExecuted( uint32_t address, uint32_t addition );
+
+    /*!
+     *  The following methods work on the addresses from @p low to @p high
+     *  which must be inside the range.
+     */
+    void sumWasExecuted( uint32_t low, uint32_t high, uint32_t addition );
+
+    bool findStartOfInstruction(
+      uint32_t  low,
+      uint32_t  high,
+      uint32_t& start
+    ) const;
+
+    bool findWasExecuted(
+      uint32_t  low,
+      uint32_t  high,
+      bool      executed,
+      uint32_t& address
+    ) const;
+
+    bool findIsBranch(
+      uint32_t  low,
+      uint32_t  high,
+      uint32_t& address
+    ) const;
+
+    uint32_t countStartsOfInstruction( uint32_t low, uint32_t high ) const;
+
+    uint32_t countWasExecuted( uint32_t low, uint32_t high ) const;
+
+    void countInstructions(
+      uint32_t           low,
+      uint32_t           high,
+      InstructionCounts& counts
+    ) const;
+
+    uint32_t getWasTaken( uint32_t address ) const;
+
+    void sumWasTaken( uint32_t address, uint32_t addition );
+
+    uint32_t getWasNotTaken( uint32_t address ) const;
+
+    void sumWasNotTaken( uint32_t address, uint32_t addition );
 
     /*!
      *  This is the file from which this originated.
@@ -98,10 +247,31 @@ namespace Coverage {
      */
     uint32_t highAddress;
 
+  private:
+
+    /*!
+     *  Range checked conversion of an address to a slot.
+     */
+    size_t slot( uint32_t address ) const;
+
     /*!
-     *  The address info for this range.
+     *  The per address flags.
      */
-    AddressInfos info;
+    AddressBits startOfInstruction;
+    AddressBits branch;
+    AddressBits nop;
+    AddressBits executed;
+
+    /*!
+     *  The execution count of each address. It is empty until an address
+     *  is executed.
+     */
+    std::vector<uint32_t> executionCounts;
+
+    /*!
+     *  The branch counters.
+     */
+    BranchInfos branches;
 
   };
 
@@ -136,6 +306,22 @@ namespace Coverage {
      */
     virtual ~CoverageMapBase();
 
+    /*!
+     *  This type is an iterator over the address ranges. Each range is a
+     *  contiguous view of the information of its addresses.
+     */
+    typedef AddressRanges::const_iterator const_iterator;
+
+    /*!
+     *  This method returns an iterator to the first address range.
+     */
+    const_iterator begin() const;
+
+    /*!
+     *  This method returns an iterator past the last address range.
+     */
+    const_iterator end() const;
+
     /*!
      *  This method adds a address range to the RangeList.
      *
@@ -179,18 +365,15 @@ namespace Coverage {
     uint32_t getLowAddressOfRange( size_t index ) const;
 
     /*!
-     *  This method returns true and sets the address range if
-     *  the address falls with the bounds of an address range
-     *  in the RangeList.
+     *  This method returns the address range in the RangeList that
+     *  holds the address.
      *
-     *  @param[in]  address specifies the address to find
-     *  @param[out] range contains the high and low addresse for
-     *              the range
+     *  @param[in] address specifies the address to find
      *
-     *  @return Returns TRUE if the address range can be found
-     *   and FALSE if it was not.
+     *  @return Returns the address range or NULL if no range holds
+     *   the address.
      */
-    bool getRange( uint32_t address, AddressRange& range ) const;
+    const AddressRange* getRange( uint32_t address ) const;
 
     /*!
      *  This method returns the size of the address range.
@@ -265,6 +448,100 @@ namespace Coverage {
      */
     virtual void setWasExecuted( uint32_t address );
 
+    /*!
+     *  This method increments the execution counters of a block of
+     *  addresses. It is the same as calling setWasExecuted() for each
+     *  address of the block.
+     *
+     *  @param[in] address specifies the first address of the block
+     *  @param[in] size specifies the number of addresses in the block
+     */
+    void setBlockWasExecuted( uint32_t address, uint32_t size );
+
+    /*!
+     *  This method finds the first start of an instruction from @p low to
+     *  @p high.
+     *
+     *  @param[in] low specifies the first address to check
+     *  @param[in] high specifies the last address to check
+     *  @param[out] start is set to the start of the instruction found
+     *
+     *  @return Returns TRUE if an instruction starts between the addresses
+     *   and FALSE otherwise.
+     */
+    bool findStartOfInstruction(
+      uint32_t  low,
+      uint32_t  high,
+      uint32_t& start
+    ) const;
+
+    /*!
+     *  This method finds the first address from @p low to @p high for
+     *  which wasExecuted() returns @p executed.
+     *
+     *  @param[in] low specifies the first address to check
+     *  @param[in] high specifies the last address to check
+     *  @param[in] executed specifies the state to find
+     *  @param[out] address is set to the address found
+     *
+     *  @return Returns TRUE if an address was found and FALSE otherwise.
+     */
+    bool findWasExecuted(
+      uint32_t  low,
+      uint32_t  high,
+      bool      executed,
+      uint32_t& address
+    ) const;
+
+    /*!
+     *  This method finds the first branch instruction from @p low to
+     *  @p high.
+     *
+     *  @param[in] low specifies the first address to check
+     *  @param[in] high specifies the last address to check
+     *  @param[out] address is set to the address found
+     *
+     *  @return Returns TRUE if an address was found and FALSE otherwise.
+     */
+    bool findIsBranch(
+      uint32_t  low,
+      uint32_t  high,
+      uint32_t& address
+    ) const;
+
+    /*!
+     *  This method returns the number of instructions that start from
+     *  @p low to @p high.
+     *
+     *  @param[in] low specifies the first address to count
+     *  @param[in] high specifies the last address to count
+     */
+    uint32_t countStartsOfInstruction( uint32_t low, uint32_t high ) const;
+
+    /*!
+     *  This method returns the number of addresses from @p low to @p high
+     *  that were executed.
+     *
+     *  @param[in] low specifies the first address to count
+     *  @param[in] high specifies the last address to count
+     */
+    uint32_t countWasExecuted( uint32_t low, uint32_t high ) const;
+
+    /*!
+     *  This method adds the counts of the instructions and executed
+     *  addresses from @p low to @p high in one pass over the flags of the
+     *  addresses.
+     *
+     *  @param[in] low specifies the first address to count
+     *  @param[in] high specifies the last address to count
+     *  @param[in,out] counts are the counts to add to
+     */
+    void countInstructions(
+      uint32_t           low,
+      uint32_t           high,
+      InstructionCounts& counts
+    ) const;
+
     /*!
      *  This method returns a boolean which indicates if the instruction
      *  at the specified address was executed.
@@ -451,14 +728,19 @@ namespace Coverage {
     AddressRanges Ranges;
 
     /*!
-     * Range checked access to the info.
+     *  This method returns the range that holds an address or NULL if no
+     *  range holds it.
      */
-    AddressInfo& getInfo( uint32_t offset );
+    AddressRange* findRange( uint32_t address );
 
     /*!
-     * Constant range checked access to the info.
+     *  This method returns the index of the range that holds an address in
+     *  the same way as getRange() or the number of ranges if no range
+     *  holds it. The @p last address is set to the end of the run of
+     *  addresses from @p address that are held by the same range, or by
+     *  no range.
      */
-    const AddressInfo& getInfo( uint32_t offset ) const;
+    size_t getSegment( uint32_t address, uint32_t& last ) const;
 
   };
 
@@ -5,6 +5,13 @@
  *  All CoverageReader implementations inherit from this.
  */
 
+#include <stdio.h>
+#include <string.h>
+
+#include <sstream>
+
+#include <rld.h>
+
 #include "CoverageReaderBase.h"
 
 namespace Coverage {
@@ -21,4 +28,127 @@ namespace Coverage {
   {
     return branchInfoAvailable_m;
   }
+
+  void CoverageReaderBase::readFile(
+    const std::string&    file,
+    std::vector<uint8_t>& data
+  )
+  {
+    FILE* coverageFile;
+    long  size;
+
+    coverageFile = ::fopen( file.c_str(), "rb" );
+    if ( coverageFile == nullptr ) {
+      std::ostringstream what;
+      what << "Unable to open " << file;
+      throw rld::error( what, "CoverageReaderBase::readFile" );
+    }
+
+    if ( ::fseek( coverageFile, 0, SEEK_END ) != 0 ||
+         ( size = ::ftell( coverageFile ) ) < 0 ||
+         ::fseek( coverageFile, 0, SEEK_SET ) != 0 ) {
+      ::fclose( coverageFile );
+      std::ostringstream what;
+      what << "Unable to find the size of " << file;
+      throw rld::error( what, "CoverageReaderBase::readFile" );
+    }
+
+    data.resize( size );
+    data.resize( ::fread( data.data(), 1, data.size(), coverageFile ) );
+    ::fclose( coverageFile );
+  }
+
+  size_t CoverageReaderBase::findNonZero(
+    const uint8_t* bytes,
+    size_t         first,
+    size_t         last
+  )
+  {
+    while ( last - first >= sizeof( uint64_t ) ) {
+      uint64_t word;
+      ::memcpy( &word, &bytes[first], sizeof( word ) );
+      if ( word != 0 ) {
+        break;
+      }
+      first += sizeof( word );
+    }
+
+    while ( first < last && bytes[first] == 0 ) {
+      ++first;
+    }
+
+    return first;
+  }
+
+  size_t CoverageReaderBase::findZero(
+    const uint8_t* bytes,
+    size_t         first,
+    size_t         last
+  )
+  {
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+
+    while ( last - first >= sizeof( uint64_t ) ) {
+      uint64_t word;
+      ::memcpy( &word, &bytes[first], sizeof( word ) );
+      // The result is not zero if any byte of the word is zero.
+      if ( ( ( word - ones ) & ~word & highs ) != 0 ) {
+        break;
+      }
+      first += sizeof( word );
+    }
+
+    while ( first < last && bytes[first] != 0 ) {
+      ++first;
+    }
+
+    return first;
+  }
+
+  void CoverageReaderBase::skipSpace( const char*& p, const char* end )
+  {
+    while (
+      p < end && ( *p == ' ' || *p == '\t' || *p == '\n' || *p == '\r' )
+    ) {
+      ++p;
+    }
+  }
+
+  bool CoverageReaderBase::readHex(
+    const char*& p,
+    const char*  end,
+    uint32_t&    value
+  )
+  {
+    int digits = 0;
+
+    skipSpace( p, end );
+
+    if (
+      ( end - p ) > 2 && p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' )
+    ) {
+      p += 2;
+    }
+
+    value = 0;
+
+    for ( ; p < end; ++p, ++digits ) {
+      char c = *p;
+      int  v;
+
+      if ( c >= '0' && c <= '9' ) {
+        v = c - '0';
+      } else if ( c >= 'a' && c <= 'f' ) {
+        v = c - 'a' + 10;
+      } else if ( c >= 'A' && c <= 'F' ) {
+        v = c - 'A' + 10;
+      } else {
+        break;
+      }
+      value = ( value << 4 ) | v;
+    }
+
+    return digits > 0;
+  }
 }
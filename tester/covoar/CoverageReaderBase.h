@@ -7,6 +7,10 @@
 #ifndef __COVERAGE_READER_BASE_H__
 #define __COVERAGE_READER_BASE_H__
 
+#include <stdint.h>
+#include <string>
+#include <vector>
+
 #include "ExecutableInfo.h"
 
 namespace Coverage {
@@ -57,6 +61,52 @@ namespace Coverage {
    * This member variable points to the target's info
    */
   std::shared_ptr<Target::TargetBase> targetInfo_m = nullptr;
+
+  protected:
+
+    /*!
+     *  This method reads all of a coverage file in one go.
+     *
+     *  @param[in] file is the coverage file to read
+     *  @param[out] data is the contents of the file
+     */
+    static void readFile( const std::string& file, std::vector<uint8_t>& data );
+
+    /*!
+     *  This method returns the first byte from @p first up to but not
+     *  including @p last which is not zero, or @p last if there is none.
+     *  The bytes are checked a 64-bit word at a time.
+     */
+    static size_t findNonZero(
+      const uint8_t* bytes,
+      size_t         first,
+      size_t         last
+    );
+
+    /*!
+     *  This method returns the first byte from @p first up to but not
+     *  including @p last which is zero, or @p last if there is none. The
+     *  bytes are checked a 64-bit word at a time.
+     */
+    static size_t findZero( const uint8_t* bytes, size_t first, size_t last );
+
+    /*!
+     *  This method advances @p p past any white space before @p end.
+     */
+    static void skipSpace( const char*& p, const char* end );
+
+    /*!
+     *  This method reads a hex number from @p p which can be preceded by
+     *  white space and a 0x. The number ends at the first character which
+     *  is not a hex digit or at @p end.
+     *
+     *  @param[in,out] p is the text to read and is left after the number
+     *  @param[in] end is the end of the text
+     *  @param[out] value is the number read
+     *
+     *  @return Returns TRUE if there is a number, FALSE otherwise.
+     */
+    static bool readHex( const char*& p, const char* end, uint32_t& value );
   };
 
 }
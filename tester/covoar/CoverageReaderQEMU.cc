@@ -9,9 +9,11 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <stdio.h>
+#include <stdint.h>
 #include <sys/stat.h>
 
+#include <vector>
+
 #include <rld.h>
 
 #include "CoverageReaderQEMU.h"
@@ -22,6 +24,60 @@
 
 namespace Coverage {
 
+  /*
+   * The number of trace entries read from the trace file in one block.
+   */
+  static const size_t ENTRIES_PER_BLOCK = 64 * 1024;
+
+  /*
+   * A trace entry decoded from the file independent of the width of the
+   * target's PC and the byte order of the host that wrote the file.
+   */
+  struct decodedEntry {
+    uint64_t pc;
+    uint16_t size;
+    uint8_t  op;
+  };
+
+  /*
+   * Get a field of an entry in the byte order of the trace file.
+   */
+  template < typename T, bool BigEndian >
+  static inline T getField( const uint8_t* bytes )
+  {
+    T value = 0;
+    if ( BigEndian ) {
+      for ( size_t b = 0; b < sizeof( T ); ++b ) {
+        value = ( value << 8 ) | bytes[b];
+      }
+    } else {
+      for ( size_t b = sizeof( T ); b != 0; --b ) {
+        value = ( value << 8 ) | bytes[b - 1];
+      }
+    }
+    return value;
+  }
+
+  /*
+   * Decode a block of raw trace entries. The layout of an entry is
+   * selected once per file so the loop has no per entry checks.
+   */
+  template < typename Entry, typename PC, bool BigEndian >
+  static void decodeEntries(
+    const uint8_t* raw,
+    size_t         count,
+    decodedEntry*  entries
+  )
+  {
+    for ( size_t e = 0; e < count; ++e, raw += sizeof( Entry ) ) {
+      entries[e].pc   = getField< PC, BigEndian >( raw );
+      entries[e].size = getField< uint16_t, BigEndian >( raw + sizeof( PC ) );
+      entries[e].op   = raw[sizeof( PC ) + sizeof( uint16_t )];
+    }
+  }
+
+  typedef void (*entryDecoder)( const uint8_t*, size_t, decodedEntry* );
+
   CoverageReaderQEMU::CoverageReaderQEMU()
   {
     branchInfoAvailable_m = true;
@@ -37,11 +93,15 @@ namespace Coverage {
   )
   {
     struct trace_header header;
-    uintptr_t           i;
     std::ifstream       traceFile;
     uint8_t             taken;
     uint8_t             notTaken;
     uint8_t             branchInfo;
+    size_t              entrySize;
+    entryDecoder        decoder;
+
+    const InstructionIndex& instructions =
+      executableInformation->getInstructionIndex();
 
     taken      = targetInfo_m->qemuTakenBit();
     notTaken   = targetInfo_m->qemuNotTakenBit();
@@ -50,7 +110,7 @@ namespace Coverage {
     //
     // Open the coverage file and read the header.
     //
-    traceFile.open( file );
+    traceFile.open( file, std::ios::in | std::ios::binary );
     if ( !traceFile.is_open() ) {
       std::ostringstream what;
       what << "Unable to open " << file;
@@ -65,58 +125,116 @@ namespace Coverage {
     }
 
     //
-    // Read ENTRIES number of trace entries.
+    // Select the entry layout. QEMU records the size of the PC in bytes,
+    // the trace-converter records it in bits.
+    //
+    switch ( header.sizeof_target_pc ) {
+      case 4:
+      case 32:
+        entrySize = sizeof( struct trace_entry32 );
+        if ( header.big_endian ) {
+          decoder = decodeEntries< struct trace_entry32, uint32_t, true >;
+        } else {
+          decoder = decodeEntries< struct trace_entry32, uint32_t, false >;
+        }
+        break;
+      case 8:
+      case 64:
+        entrySize = sizeof( struct trace_entry64 );
+        if ( header.big_endian ) {
+          decoder = decodeEntries< struct trace_entry64, uint64_t, true >;
+        } else {
+          decoder = decodeEntries< struct trace_entry64, uint64_t, false >;
+        }
+        break;
+      default:
+        {
+          std::ostringstream what;
+          what << "Invalid target PC size ("
+               << (int) header.sizeof_target_pc << ") in " << file;
+          throw rld::error( what, "CoverageReaderQEMU::processFile" );
+        }
+    }
+
+    std::vector<uint8_t>      raw( ENTRIES_PER_BLOCK * entrySize );
+    std::vector<decodedEntry> entries( ENTRIES_PER_BLOCK );
+
+    //
+    // Read blocks of ENTRIES_PER_BLOCK trace entries.
     //
-#define ENTRIES 1024
     while ( true ) {
-      CoverageMapBase*    aCoverageMap = NULL;
-      struct trace_entry  entries[ENTRIES];
-      struct trace_entry* entry;
+      CoverageMapBase* aCoverageMap = NULL;
 
-      // Read and process each line of the coverage file.
-      traceFile.read( (char *) entries, sizeof( struct trace_entry ) );
-      if ( traceFile.gcount() == 0 ) {
+      traceFile.read( (char *) raw.data(), raw.size() );
+      size_t bytes = traceFile.gcount();
+      if ( bytes == 0 ) {
         break;
       }
 
+      if ( ( bytes % entrySize ) != 0 ) {
+        std::ostringstream what;
+        what << "Truncated trace entry in " << file;
+        throw rld::error( what, "CoverageReaderQEMU::processFile" );
+      }
+
+      size_t count = bytes / entrySize;
+
+      decoder( raw.data(), count, entries.data() );
+
       // Get the coverage map for each entry.  Note that the map is
       // the same for each entry in the coverage map
-      for ( int count = 0; count < traceFile.gcount(); count++ ) {
+      for ( size_t e = 0; e < count; e++ ) {
+        const decodedEntry& entry = entries[e];
+
+        // The coverage maps only hold 32-bit addresses.
+        if ( entry.pc > UINT32_MAX ) {
+          continue;
+        }
 
-        entry = &entries[count];
+        uint32_t pc = entry.pc;
 
         // Mark block as fully executed.
         // Obtain the coverage map containing the specified address.
-        aCoverageMap = executableInformation->getCoverageMap( entry->pc );
+        aCoverageMap = executableInformation->getCoverageMap( pc );
 
         // Ensure that coverage map exists.
         if ( !aCoverageMap )
           continue;
 
         // Set was executed for each TRACE_OP_BLOCK
-        if ( entry->op & TRACE_OP_BLOCK ) {
-         for ( i = 0; i < entry->size; i++ ) {
-            aCoverageMap->setWasExecuted( entry->pc + i );
-          }
+        if ( entry.op & TRACE_OP_BLOCK ) {
+          aCoverageMap->setBlockWasExecuted( pc, entry.size );
         }
 
         // Determine if additional branch information is available.
-        if ( ( entry->op & branchInfo ) != 0 ) {
-          uint32_t  a = entry->pc + entry->size - 1;
-            while ( a > entry->pc && !aCoverageMap->isStartOfInstruction( a ) )
-              a--;
-            if ( a == entry->pc && !aCoverageMap->isStartOfInstruction( a ) ) {
-              // Something went wrong parsing the objdump.
-              std::ostringstream what;
-              what << "Reached beginning of range in " << file
-                << " at " << entry->pc << " with no start of instruction.";
-              throw rld::error( what, "CoverageReaderQEMU::processFile" );
+        if ( ( entry.op & branchInfo ) != 0 && entry.size != 0 ) {
+          // Find the start of the last instruction of the block in this
+          // coverage map. The index holds the starts of all the desired
+          // symbols so skip any that are not in the map.
+          uint32_t a = pc + entry.size - 1;
+          bool     found = false;
+          while ( instructions.getLastStartInRange( pc, a, a ) ) {
+            if ( aCoverageMap->isStartOfInstruction( a ) ) {
+              found = true;
+              break;
             }
-            if ( entry->op & taken ) {
-              aCoverageMap->setWasTaken( a );
-            } else if ( entry->op & notTaken ) {
-              aCoverageMap->setWasNotTaken( a );
+            if ( a == pc ) {
+              break;
             }
+            a--;
+          }
+          if ( !found ) {
+            // Something went wrong parsing the objdump.
+            std::ostringstream what;
+            what << "Reached beginning of range in " << file
+              << " at " << pc << " with no start of instruction.";
+            throw rld::error( what, "CoverageReaderQEMU::processFile" );
+          }
+          if ( entry.op & taken ) {
+            aCoverageMap->setWasTaken( a );
+          } else if ( entry.op & notTaken ) {
+            aCoverageMap->setWasNotTaken( a );
+          }
         }
       }
     }
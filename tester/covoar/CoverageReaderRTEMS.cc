@@ -7,11 +7,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include <rld.h>
 
@@ -35,59 +37,50 @@ namespace Coverage {
     ExecutableInfo* const executableInformation
   )
   {
-    CoverageMapBase*            aCoverageMap = NULL;
-    uintptr_t                   baseAddress;
-    uint8_t                     cover;
-    std::ifstream               coverageFile;
+    uint32_t                    baseAddress;
+    const uint8_t*              cover;
+    std::vector<uint8_t>        data;
     rtems_coverage_map_header_t header;
-    uintptr_t                   i;
-    uintptr_t                   length;
+    size_t                      end;
+    size_t                      i;
+    size_t                      length;
 
     //
-    // Open the coverage file and read the header.
+    // Read the whole coverage file and the header at its start.
     //
-    coverageFile.open( file );
-    if ( !coverageFile.is_open() ) {
-      std::ostringstream what;
-      what << "Unable to open " << file;
-      throw rld::error( what, "CoverageReaderRTEMS::processFile" );
-    }
+    readFile( file, data );
 
-    coverageFile.read( (char *) &header, sizeof( header ) );
-    if ( coverageFile.fail() ) {
+    if ( data.size() < sizeof( header ) ) {
       std::ostringstream what;
       what << "Unable to read header from " << file;
       throw rld::error( what, "CoverageReaderRTEMS::processFile" );
     }
 
+    ::memcpy( &header, data.data(), sizeof( header ) );
+
     baseAddress = header.start;
-    length      = header.end - header.start;
+    length      = (uint32_t) ( header.end - header.start );
+    cover       = data.data() + sizeof( header );
 
     //
-    // Read and process each line of the coverage file.
+    // Each byte is an address which was executed if the byte is not zero.
+    // Mark each run of executed addresses in the coverage maps holding
+    // them.
     //
-    for ( i = 0; i < length; i++ ) {
-      coverageFile.read( (char *) &cover, sizeof( uint8_t ) );
-      if ( coverageFile.fail() ) {
-        std::cerr << "breaking after 0x"
-                  << std::hex << std::setfill( '0' )
-                  << std::setw( 8 ) << i
-                  << std::setfill( ' ' ) << std::dec
-                  << " in " << file
-                  << std::endl;
-        break;
-      }
-
-      //
-      // Obtain the coverage map containing the address and
-      // mark the address as executed.
-      //
-      if ( cover ) {
-        aCoverageMap = executableInformation->getCoverageMap( baseAddress + i );
-        if ( aCoverageMap )
-          aCoverageMap->setWasExecuted( baseAddress + i );
-      }
+    end = std::min( length, data.size() - sizeof( header ) );
+    for ( i = findNonZero( cover, 0, end ); i < end; ) {
+      size_t last = findZero( cover, i, end );
+      executableInformation->setBlockWasExecuted( baseAddress + i, last - i );
+      i = findNonZero( cover, last, end );
     }
 
+    if ( end < length ) {
+      std::cerr << "breaking after 0x"
+                << std::hex << std::setfill( '0' )
+                << std::setw( 8 ) << end
+                << std::setfill( ' ' ) << std::dec
+                << " in " << file
+                << std::endl;
+    }
   }
 }
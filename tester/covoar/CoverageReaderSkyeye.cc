@@ -7,11 +7,13 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <iostream>
-#include <fstream>
 #include <iomanip>
+#include <sstream>
 
 #include "CoverageReaderSkyeye.h"
 #include "CoverageMap.h"
@@ -33,80 +35,70 @@ namespace Coverage {
     ExecutableInfo* const executableInformation
   )
   {
-    CoverageMapBase* aCoverageMap = NULL;
-    uintptr_t        baseAddress;
-    uint8_t          cover;
-    std::ifstream    coverageFile;
-    prof_header_t    header;
-    uintptr_t        i;
-    uintptr_t        length;
+    CoverageMapBase*     aCoverageMap = NULL;
+    uint32_t             baseAddress;
+    const uint8_t*       cover;
+    std::vector<uint8_t> data;
+    prof_header_t        header;
+    size_t               end;
+    size_t               i;
+    size_t               length;
 
     //
-    // Open the coverage file and read the header.
+    // Read the whole coverage file and the header at its start.
     //
-    coverageFile.open( file );
-    if ( !coverageFile ) {
-      std::ostringstream what;
-      what << "Unable to open " << file;
-      throw rld::error( what, "CoverageReaderSkyeye::processFile" );
-    }
+    readFile( file, data );
 
-    coverageFile.read( (char *) &header, sizeof( header ) );
-    if ( coverageFile.fail() ) {
+    if ( data.size() < sizeof( header ) ) {
       std::ostringstream what;
       what << "Unable to read header from " << file;
       throw rld::error( what, "CoverageReaderSkyeye::processFile" );
     }
 
+    ::memcpy( &header, data.data(), sizeof( header ) );
+
     baseAddress = header.prof_start;
-    length      = header.prof_end - header.prof_start;
+    length      = (uint32_t) ( header.prof_end - header.prof_start );
+    cover       = data.data() + sizeof( header );
 
     //
-    // Read and process each line of the coverage file.
+    // Each byte covers eight addresses. Bit 0 is set if the first four
+    // were executed and bit 4 if the last four were. The bytes which are
+    // zero are skipped a word at a time.
     //
-    for ( i = 0; i < length; i += 8 ) {
-      coverageFile.read( (char *) &cover, sizeof( uint8_t ) );
-      if ( coverageFile.gcount() != sizeof( uint8_t ) ) {
-        std::cerr << "CoverageReaderSkyeye::ProcessFile - breaking after 0x"
-                  << std::hex << std::setfill( '0' )
-                  << std::setw( 8 ) << i
-                  << std::setfill( ' ' ) << std::dec
-                  << " in " << file
-                  << std::endl;
-        break;
-      }
+    // NOTE: This method ONLY works for Skyeye in 32-bit mode.
+    //
+    end = std::min( ( length + 7 ) / 8, data.size() - sizeof( header ) );
+    for ( i = findNonZero( cover, 0, end ); i < end;
+          i = findNonZero( cover, i + 1, end ) ) {
+      uint32_t a = baseAddress + i * 8;
 
       //
       // Obtain the coverage map containing the address and
-      // mark the address as executed.
-      //
-      // NOTE: This method ONLY works for Skyeye in 32-bit mode.
+      // mark the addresses as executed.
       //
-      if ( cover & 0x01 ) {
-        aCoverageMap = executableInformation->getCoverageMap(
-          baseAddress + i
-        );
-
+      if ( cover[i] & 0x01 ) {
+        aCoverageMap = executableInformation->getCoverageMap( a );
         if ( aCoverageMap ) {
-          aCoverageMap->setWasExecuted( baseAddress + i );
-          aCoverageMap->setWasExecuted( baseAddress + i + 1 );
-          aCoverageMap->setWasExecuted( baseAddress + i + 2 );
-          aCoverageMap->setWasExecuted( baseAddress + i + 3 );
+          aCoverageMap->setBlockWasExecuted( a, 4 );
         }
       }
 
-      if ( cover & 0x10 ) {
-        aCoverageMap = executableInformation->getCoverageMap(
-          baseAddress + i + 4
-        );
+      if ( cover[i] & 0x10 ) {
+        aCoverageMap = executableInformation->getCoverageMap( a + 4 );
         if ( aCoverageMap ) {
-          aCoverageMap->setWasExecuted( baseAddress + i + 4 );
-          aCoverageMap->setWasExecuted( baseAddress + i + 5 );
-          aCoverageMap->setWasExecuted( baseAddress + i + 6 );
-          aCoverageMap->setWasExecuted( baseAddress + i + 7 );
+          aCoverageMap->setBlockWasExecuted( a + 4, 4 );
         }
       }
     }
 
+    if ( end * 8 < length ) {
+      std::cerr << "CoverageReaderSkyeye::ProcessFile - breaking after 0x"
+                << std::hex << std::setfill( '0' )
+                << std::setw( 8 ) << end * 8
+                << std::setfill( ' ' ) << std::dec
+                << " in " << file
+                << std::endl;
+    }
   }
 }
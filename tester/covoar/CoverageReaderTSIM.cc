@@ -10,7 +10,6 @@
 #include <sys/stat.h>
 
 #include <iostream>
-#include <fstream>
 #include <iomanip>
 
 #include <rld.h>
@@ -35,37 +34,38 @@ namespace Coverage {
     ExecutableInfo* const executableInformation
   )
   {
-    CoverageMapBase* aCoverageMap = NULL;
-    int              baseAddress;
-    int              cover;
-    std::ifstream    coverageFile;
-    int              i;
-    char             ignore;
+    CoverageMapBase*     aCoverageMap = NULL;
+    uint32_t             baseAddress;
+    uint32_t             cover;
+    std::vector<uint8_t> data;
+    const char*          p;
+    const char*          end;
+    int                  i;
 
     //
-    // Open the coverage file.
+    // Read the whole coverage file.
     //
-    coverageFile.open( file );
-    if ( !coverageFile.is_open() ) {
-      std::ostringstream what;
-      what << "Unable to open " << file;
-      throw rld::error( what, "CoverageReaderTSIM::processFile" );
-    }
+    readFile( file, data );
+
+    p   = reinterpret_cast<const char*>( data.data() );
+    end = p + data.size();
 
     //
-    // Read and process each line of the coverage file.
+    // Read and process each line of the coverage file. A line is an
+    // address, a separator and a word for each of the 32 words from the
+    // address.
     //
-    while ( true ) {
-      coverageFile >> std::hex >> baseAddress >> ignore >> std::dec;
-      if ( coverageFile.gcount() == 0 || coverageFile.fail() ) {
+    while ( readHex( p, end, baseAddress ) ) {
+      skipSpace( p, end );
+      if ( p == end ) {
         break;
       }
+      ++p;
 
       for ( i = 0; i < 0x80; i += 4 ) {
-        unsigned int a;
+        uint32_t a;
 
-        coverageFile >> std::hex >> cover >> std::dec;
-        if ( coverageFile.fail() || coverageFile.gcount() == 0 ) {
+        if ( !readHex( p, end, cover ) ) {
           std::cerr << "CoverageReaderTSIM: WARNING! Short line in "
                     << file
                     << " at address 0x"
@@ -73,9 +73,14 @@ namespace Coverage {
                     << baseAddress
                     << std::setfill( ' ' ) << std::dec
                     << std::endl;
+          p = end;
           break;
         }
 
+        if ( ( cover & 0x01 ) == 0 ) {
+          continue;
+        }
+
         //
         // Obtain the coverage map containing the address and
         // mark the address as executed.
@@ -86,22 +91,16 @@ namespace Coverage {
           continue;
         }
 
-        if ( cover & 0x01 ) {
-          aCoverageMap->setWasExecuted( a );
-          aCoverageMap->setWasExecuted( a + 1 );
-          aCoverageMap->setWasExecuted( a + 2 );
-          aCoverageMap->setWasExecuted( a + 3 );
-          if ( cover & 0x08 ) {
-            aCoverageMap->setWasTaken( a );
-            branchInfoAvailable_m = true;
-          }
-          if ( cover & 0x10 ) {
-            aCoverageMap->setWasNotTaken( a );
-            branchInfoAvailable_m = true;
-          }
+        aCoverageMap->setBlockWasExecuted( a, 4 );
+        if ( cover & 0x08 ) {
+          aCoverageMap->setWasTaken( a );
+          branchInfoAvailable_m = true;
+        }
+        if ( cover & 0x10 ) {
+          aCoverageMap->setWasNotTaken( a );
+          branchInfoAvailable_m = true;
         }
       }
     }
-
   }
 }
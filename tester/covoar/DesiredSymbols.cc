@@ -15,12 +15,17 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 #include "rld.h"
 #include <rld-config.h>
 #include "rld-symbols.h"
 #include "rld-files.h"
+#include "rld-threads.h"
 
 #include "DesiredSymbols.h"
 #include "CoverageMap.h"
@@ -44,7 +49,8 @@ namespace Coverage {
     const std::string& symbolsSet,
     const std::string& buildTarget,
     const std::string& buildBSP,
-    bool               verbose
+    bool               verbose,
+    unsigned int       jobs
   )
   {
     //
@@ -73,11 +79,38 @@ namespace Coverage {
     rld::strings sets;
     rld::config::parse_items (sym_section, "sets", sets, true);
 
-    // Load the symbols for each set specified in the config file.
+    // The sets are held in the order they are listed and a set listed
+    // more than once is loaded once.
+    setNames.clear();
     for (const auto& setName : sets) {
-      rld::files::cache cache;
-      cache.open();
+      if (std::find( setNames.begin(), setNames.end(), setName ) ==
+          setNames.end())
+        setNames.push_back( setName );
+    }
+
+    if (setNames.size() > maxSymbolSets) {
+      std::ostringstream what;
+      what << "Too many symbol sets: " << setNames.size()
+           << " (maximum " << maxSymbolSets << ")";
+      throw rld::error( what, "DesiredSymbols::load" );
+    }
 
+    // The sets are worked and reported in name order.
+    setOrder.resize( setNames.size() );
+    for (size_t s = 0; s < setNames.size(); ++s)
+      setOrder[s] = s;
+    std::sort(
+      setOrder.begin(),
+      setOrder.end(),
+      [&]( size_t a, size_t b ) { return setNames[a] < setNames[b]; }
+    );
+
+    // Find the sets each library is in. A library shared by sets is only
+    // loaded once.
+    std::map<std::string, setMembership_t> libraries;
+
+    for (size_t s = 0; s < setNames.size(); ++s) {
+      const std::string& setName = setNames[s];
       if (verbose)
         std::cerr << "Loading symbols for set: " << setName << std::endl;
       const rld::config::section& set_section = config.get_section(setName);
@@ -88,27 +121,111 @@ namespace Coverage {
         lib = rld::find_replace(lib, "@BSP@", buildBSP);
         if (verbose)
           std::cerr << " Loading library: " << lib << std::endl;
-        cache.add(lib);
+        libraries[lib].set( s );
       }
+    }
 
-      rld::symbols::table symbols;
+    rld::files::cache cache;
+    cache.open();
+
+    for (const auto& kv : libraries)
+      cache.add( kv.first );
+
+    // The sets of each object file are the sets of its library.
+    std::vector<rld::files::object*> objectFiles;
+    std::vector<setMembership_t>     objectSets;
+
+    for (auto& kv : cache.get_objects()) {
+      rld::files::object*  obj = kv.second;
+      rld::files::archive* ar = obj->get_archive();
+      const std::string&   lib =
+        ar ? ar->name().path() : obj->name().path();
+      auto l = libraries.find( lib );
+      if (l == libraries.end())
+        throw rld::error(
+          "No symbol set for: " + obj->name().full(), "DesiredSymbols::load"
+        );
+      objectFiles.push_back( obj );
+      objectSets.push_back( l->second );
+    }
 
-      cache.load_symbols (symbols, true);
+    // Read the global and weak function symbols of each object file. The
+    // objects share their archive's file so opening and closing an object
+    // is serialised.
+    std::vector<std::vector<std::string>> objectSymbols( objectFiles.size() );
+    std::vector<std::vector<bool>>        objectWeaks( objectFiles.size() );
+    std::mutex                            openLock;
+
+    rld::threads::parallel_for(
+      objectFiles.size(),
+      jobs,
+      [&]( size_t o ) {
+        rld::files::object& obj = *objectFiles[o];
+        rld::symbols::pointers syms;
+
+        {
+          std::lock_guard<std::mutex> guard( openLock );
+          obj.open();
+        }
 
-      // Populate the symbol maps with all global symbols.
-      for (auto& kv : symbols.globals()) {
-        const rld::symbols::symbol& sym = *(kv.second);
-        if (sym.type() == sym.st_func) {
-          set[sym.name()] = SymbolInformation();
-          setNamesToSymbols[setName].push_back(sym.name());
+        try {
+          obj.begin();
+          obj.elf().get_symbols( syms, false, false, true, true );
+          for (const auto sym : syms) {
+            if (sym->type() == sym->st_func) {
+              objectSymbols[o].push_back( sym->name() );
+              objectWeaks[o].push_back( sym->is_weak() );
+            }
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> guard( openLock );
+          obj.close();
+          throw;
         }
+
+        std::lock_guard<std::mutex> guard( openLock );
+        obj.close();
       }
-      // Populate the symbol maps with all weak symbols.
-      for (auto& kv : symbols.weaks()) {
-        const rld::symbols::symbol& sym = *(kv.second);
-        if (sym.type() == sym.st_func) {
-          set[sym.name()] = SymbolInformation();
-          setNamesToSymbols[setName].push_back(sym.name());
+    );
+
+    // Resolve each symbol to its sets with one lookup in the object order.
+    // A symbol is global in a set if any of the set's objects holds it as
+    // a global symbol.
+    struct symbolSets_t {
+      setMembership_t sets;
+      setMembership_t globalSets;
+    };
+
+    std::unordered_map<std::string, symbolSets_t> symbolSets;
+
+    for (size_t o = 0; o < objectFiles.size(); ++o) {
+      for (size_t n = 0; n < objectSymbols[o].size(); ++n) {
+        symbolSets_t& ss = symbolSets[objectSymbols[o][n]];
+        ss.sets |= objectSets[o];
+        if (!objectWeaks[o][n])
+          ss.globalSets |= objectSets[o];
+      }
+    }
+
+    for (const auto& kv : symbolSets) {
+      set[kv.first].sets |= kv.second.sets;
+      usedSets |= kv.second.sets;
+    }
+
+    // The symbols of a set are worked in the order of its global symbols
+    // then its weak symbols, each in name order.
+    setSymbols.assign( setNames.size(), {} );
+    for (bool global : { true, false }) {
+      for (auto& kv : set) {
+        auto ss = symbolSets.find( kv.first );
+        if (ss == symbolSets.end())
+          continue;
+        for (size_t n = 0; n < setNames.size(); ++n) {
+          if (
+            ss->second.sets.test( n ) &&
+            ss->second.globalSets.test( n ) == global
+          )
+            setSymbols[n].push_back( &kv );
         }
       }
     }
@@ -134,66 +251,60 @@ namespace Coverage {
     }
   }
 
-  void DesiredSymbols::calculateStatistics( void )
+  void DesiredSymbols::calculateStatistics( unsigned int jobs )
   {
-    // Look at each symbol set.
-    for (const auto& kv : setNamesToSymbols) {
-      // Look at each symbol.
-      for (const auto& symbol : kv.second) {
-        SymbolInformation& info = set.at(symbol);
-
+    forEachSymbol(
+      jobs,
+      [&](
+        const std::string& symbol,
+        SymbolInformation& info,
+        Statistics&        setStats,
+        std::ostream&      messages
+      ) {
         // If the unified coverage map does not exist, the symbol was
         // never referenced by any executable.  Just skip it.
         CoverageMapBase* theCoverageMap = info.unifiedCoverageMap;
         if (theCoverageMap) {
           // Increment the total sizeInBytes by the bytes in the symbol
-          stats[kv.first].sizeInBytes += info.stats.sizeInBytes;
-
-          // Now scan through the coverage map of this symbol.
-          uint32_t endAddress = info.stats.sizeInBytes - 1;
-
-          for (uint32_t a = 0; a <= endAddress; ++a) {
-            // If we are at the start of instruction increment
-            // instruction type counters as needed.
-            if ( theCoverageMap->isStartOfInstruction( a ) ) {
-
-              stats[kv.first].sizeInInstructions++;
-              info.stats.sizeInInstructions++;
-
-              if (!theCoverageMap->wasExecuted( a ) ) {
-                stats[kv.first].uncoveredInstructions++;
-                info.stats.uncoveredInstructions++;
-
-                if ( theCoverageMap->isBranch( a )) {
-                  stats[kv.first].branchesNotExecuted++;
-                  info.stats.branchesNotExecuted++;
-                }
-              } else if (theCoverageMap->isBranch( a )) {
-                stats[kv.first].branchesExecuted++;
-                info.stats.branchesExecuted++;
-              }
-            }
-
-            if (!theCoverageMap->wasExecuted( a )) {
-              stats[kv.first].uncoveredBytes++;
-              info.stats.uncoveredBytes++;
-            }
-          }
+          setStats.sizeInBytes += info.stats.sizeInBytes;
+
+          // Now count the instructions and executed bytes of the coverage
+          // map of this symbol in one pass.
+          InstructionCounts counts;
+          theCoverageMap->countInstructions(
+            0,
+            info.stats.sizeInBytes - 1,
+            counts
+          );
+
+          Statistics symbolStats;
+          symbolStats.sizeInInstructions = counts.instructions;
+          symbolStats.uncoveredInstructions = counts.notExecuted;
+          symbolStats.branchesNotExecuted = counts.branchesNotExecuted;
+          symbolStats.branchesExecuted = counts.branchesExecuted;
+          symbolStats.uncoveredBytes =
+            info.stats.sizeInBytes - counts.executedBytes;
+
+          setStats += symbolStats;
+          info.stats += symbolStats;
         } else {
-          stats[kv.first].unreferencedSymbols++;
+          setStats.unreferencedSymbols++;
         }
       }
-    }
+    );
   }
 
 
-  void DesiredSymbols::computeUncovered( bool verbose )
+  void DesiredSymbols::computeUncovered( bool verbose, unsigned int jobs )
   {
-    // Look at each symbol set.
-    for (const auto& kv : setNamesToSymbols) {
-      // Look at each symbol.
-      for (const auto& symbol : kv.second) {
-        SymbolInformation& info = set.at(symbol);
+    forEachSymbol(
+      jobs,
+      [&](
+        const std::string& symbol,
+        SymbolInformation& info,
+        Statistics&        setStats,
+        std::ostream&      messages
+      ) {
         // If the unified coverage map does not exist, the symbol was
         // never referenced by any executable.  Just skip it.
         CoverageMapBase* theCoverageMap = info.unifiedCoverageMap;
@@ -234,15 +345,13 @@ namespace Coverage {
           endAddress = info.stats.sizeInBytes - 1;
           a = 0;
           while (a < endAddress) {
-            if (!theCoverageMap->wasExecuted( a )) {
-              a++;
-              continue;
-            }
+            if (!theCoverageMap->findWasExecuted( a, endAddress - 1, true, a ))
+              break;
 
-            for (ha=a+1;
-                ha <= endAddress && !theCoverageMap->isStartOfInstruction( ha );
-                ha++)
-              ;
+            if (
+              !theCoverageMap->findStartOfInstruction( a + 1, endAddress, ha )
+            )
+              break;
             if ( ha >= endAddress )
               break;
 
@@ -267,16 +376,16 @@ namespace Coverage {
 
               la = a;
               count = 1;
-              for (ha = a + 1;
-                  ha <= endAddress && !theCoverageMap->wasExecuted( ha );
-                  ha++)
-              {
-                if ( theCoverageMap->isStartOfInstruction( ha ) )
-                  count++;
-              }
+              if (
+                !theCoverageMap->findWasExecuted( a + 1, endAddress, true, ha )
+              )
+                ha = endAddress + 1;
               ha--;
+              if ( ha > la )
+                count +=
+                  theCoverageMap->countStartsOfInstruction( la + 1, ha );
 
-              stats[kv.first].uncoveredRanges++;
+              setStats.uncoveredRanges++;
               info.stats.uncoveredRanges++;
               theRanges->add(
                 info.baseAddress + la,
@@ -291,14 +400,14 @@ namespace Coverage {
             // to the uncoverd branches.
             else if (theCoverageMap->isBranch( a )) {
               la = a;
-              for (ha = a + 1;
-                ha <= endAddress && !theCoverageMap->isStartOfInstruction( ha );
-                  ha++)
-                ;
+              if (
+                !theCoverageMap->findStartOfInstruction( a + 1, endAddress, ha )
+              )
+                ha = endAddress + 1;
               ha--;
 
               if (theCoverageMap->wasAlwaysTaken( la )) {
-                stats[kv.first].branchesAlwaysTaken++;
+                setStats.branchesAlwaysTaken++;
                 info.stats.branchesAlwaysTaken++;
                 theBranches->add(
                   info.baseAddress + la,
@@ -307,16 +416,16 @@ namespace Coverage {
                   1
                 );
                 if (verbose)
-                  std::cerr << "Branch always taken found in" << symbol
-                            << std::hex
-                            << " (0x" << info.baseAddress + la
-                            << " - 0x" << info.baseAddress + ha
-                            << ")"
-                            << std::dec
-                            << std::endl;
+                  messages << "Branch always taken found in" << symbol
+                           << std::hex
+                           << " (0x" << info.baseAddress + la
+                           << " - 0x" << info.baseAddress + ha
+                           << ")"
+                           << std::dec
+                           << std::endl;
               }
               else if (theCoverageMap->wasNeverTaken( la )) {
-                stats[kv.first].branchesNeverTaken++;
+                setStats.branchesNeverTaken++;
                 info.stats.branchesNeverTaken++;
                 theBranches->add(
                   info.baseAddress + la,
@@ -325,24 +434,76 @@ namespace Coverage {
                   1
                   );
                 if (verbose)
-                  std::cerr << "Branch never taken found in " << symbol
-                            << std::hex
-                            << " (0x" << info.baseAddress + la
-                            << " - 0x" << info.baseAddress + ha
-                            << ")"
-                            << std::dec
-                            << std::endl;
+                  messages << "Branch never taken found in " << symbol
+                           << std::hex
+                           << " (0x" << info.baseAddress + la
+                           << " - 0x" << info.baseAddress + ha
+                           << ")"
+                           << std::dec
+                           << std::endl;
               }
               a = ha + 1;
             }
-            else
-              a++;
+
+            // Skip to the next address that was not executed or is a
+            // branch instruction.
+            else {
+              uint32_t next = endAddress + 1;
+              if (a < endAddress) {
+                if (
+                  theCoverageMap->findWasExecuted( a + 1, endAddress, false, ha )
+                )
+                  next = ha;
+                if (theCoverageMap->findIsBranch( a + 1, next - 1, ha ))
+                  next = ha;
+              }
+              a = next;
+            }
           }
         }
       }
-    }
+    );
   }
 
+  void DesiredSymbols::forEachSymbol(
+    unsigned int      jobs,
+    const symbolWork& work
+  )
+  {
+    struct symbolUse {
+      Statistics  stats;
+      std::string messages;
+    };
+
+    for (size_t n : setOrder) {
+      const std::vector<symbolSet_t::value_type*>& symbols = setSymbols[n];
+      std::vector<symbolUse>                       uses( symbols.size() );
+
+      if (symbols.empty())
+        continue;
+
+      rld::threads::parallel_for(
+        symbols.size(),
+        jobs,
+        [&]( size_t s ) {
+          std::ostringstream messages;
+          work(
+            symbols[s]->first,
+            symbols[s]->second,
+            uses[s].stats,
+            messages
+          );
+          uses[s].messages = messages.str();
+        }
+      );
+
+      Statistics& setStats = stats[setNames[n]];
+      for (const auto& use : uses) {
+        setStats += use.stats;
+        std::cerr << use.messages;
+      }
+    }
+  }
 
   void DesiredSymbols::createCoverageMap(
     const std::string& exefileName,
@@ -415,17 +576,28 @@ namespace Coverage {
   }
 
   void DesiredSymbols::determineSourceLines(
-    CoverageRanges* const theRanges,
-    ExecutableInfo* const theExecutable
-
+    const std::vector<CoverageRanges*>& theRanges,
+    ExecutableInfo* const               theExecutable
   )
   {
-    for (auto& r : theRanges->set) {
-      std::string location;
-      theExecutable->getSourceAndLine(r.lowAddress, location);
-      r.lowSourceLine = rld::path::basename (location);
-      theExecutable->getSourceAndLine(r.highAddress, location);
-      r.highSourceLine = rld::path::basename (location);
+    std::vector<uint32_t>    addresses;
+    std::vector<std::string> locations;
+
+    for (const auto ranges : theRanges) {
+      for (const auto& r : ranges->set) {
+        addresses.push_back(r.lowAddress);
+        addresses.push_back(r.highAddress);
+      }
+    }
+
+    theExecutable->getSourceAndLines(addresses, locations);
+
+    size_t l = 0;
+    for (const auto ranges : theRanges) {
+      for (auto& r : ranges->set) {
+        r.lowSourceLine = rld::path::basename (locations[l++]);
+        r.highSourceLine = rld::path::basename (locations[l++]);
+      }
     }
   }
 
@@ -433,10 +605,12 @@ namespace Coverage {
     const std::string& symbolName
   )
   {
-    if (set.find( symbolName ) == set.end())
+    auto symbol = set.find( symbolName );
+
+    if (symbol == set.end())
       return NULL;
     else
-      return &set[ symbolName ];
+      return &symbol->second;
   }
 
   void DesiredSymbols::findSourceForUncovered(
@@ -444,8 +618,12 @@ namespace Coverage {
     const DesiredSymbols& symbolsToAnalyze
   )
   {
+    std::map<ExecutableInfo*, std::vector<CoverageRanges*>> lookups;
+
     // Process uncovered ranges and/or branches for each symbol.
     for (auto& d : symbolsToAnalyze.set) {
+      std::vector<CoverageRanges*>& theLookups = lookups[d.second.sourceFile];
+
       // First the unexecuted ranges, ...
       CoverageRanges* theRanges = d.second.uncoveredRanges;
       if (theRanges != nullptr) {
@@ -454,7 +632,7 @@ namespace Coverage {
             std::cerr << "Looking up source lines for uncovered ranges in "
                       << d.first
                       << std::endl;
-          determineSourceLines( theRanges, d.second.sourceFile );
+          theLookups.push_back( theRanges );
         }
 
         // then the uncovered branches.
@@ -465,11 +643,18 @@ namespace Coverage {
               std::cerr << "Looking up source lines for uncovered branches in "
                         << d.first
                         << std::endl;
-            determineSourceLines( theBranches, d.second.sourceFile );
+            theLookups.push_back( theBranches );
           }
         }
       }
     }
+
+    // Look up the source lines of all the ranges of an executable at once.
+    for (auto& l : lookups) {
+      if (!l.second.empty()) {
+        determineSourceLines( l.second, l.first );
+      }
+    }
   }
 
   uint32_t DesiredSymbols::getNumberBranchesAlwaysTaken(
@@ -512,19 +697,34 @@ namespace Coverage {
   };
 
   std::vector<std::string> DesiredSymbols::getSetNames( void ) const {
-    std::vector<std::string> setNames;
-    for (const auto &kv : setNamesToSymbols) {
-      setNames.push_back(kv.first);
+    std::vector<std::string> names;
+    for (size_t n : setOrder) {
+      if (usedSets.test( n ))
+        names.push_back( setNames[n] );
     }
 
-    return setNames;
+    return names;
   }
 
-  const std::vector<std::string>& DesiredSymbols::getSymbolsForSet(
+  std::vector<std::string> DesiredSymbols::getSymbolsForSet(
     const std::string& symbolSetName
   ) const
   {
-    return setNamesToSymbols.at(symbolSetName);
+    auto name = std::find( setNames.begin(), setNames.end(), symbolSetName );
+    if (name == setNames.end() || !usedSets.test( name - setNames.begin() ))
+      throw rld::error(
+        "Unknown symbol set: " + symbolSetName,
+        "DesiredSymbols::getSymbolsForSet"
+      );
+
+    const size_t             n = name - setNames.begin();
+    std::vector<std::string> symbols;
+    for (const auto& kv : set) {
+      if (kv.second.sets.test( n ))
+        symbols.push_back( kv.first );
+    }
+
+    return symbols;
   }
 
   bool DesiredSymbols::isDesired (
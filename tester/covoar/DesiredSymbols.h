@@ -7,8 +7,11 @@
 #ifndef __DESIRED_SYMBOLS_H__
 #define __DESIRED_SYMBOLS_H__
 
+#include <bitset>
+#include <functional>
 #include <list>
 #include <map>
+#include <ostream>
 #include <stdint.h>
 #include <string>
 
@@ -123,8 +126,38 @@ namespace Coverage {
      {
      }
 
+    /*!
+     *  This method adds the statistics of another instance.
+     */
+    Statistics& operator+=( const Statistics& other )
+    {
+      branchesAlwaysTaken    += other.branchesAlwaysTaken;
+      branchesExecuted       += other.branchesExecuted;
+      branchesNeverTaken     += other.branchesNeverTaken;
+      branchesNotExecuted    += other.branchesNotExecuted;
+      sizeInBytes            += other.sizeInBytes;
+      sizeInBytesWithoutNops += other.sizeInBytesWithoutNops;
+      sizeInInstructions     += other.sizeInInstructions;
+      uncoveredBytes         += other.uncoveredBytes;
+      uncoveredInstructions  += other.uncoveredInstructions;
+      uncoveredRanges        += other.uncoveredRanges;
+      unreferencedSymbols    += other.unreferencedSymbols;
+      return *this;
+    }
+
   };
 
+  /*!
+   *  This is the largest number of symbol sets that can be loaded.
+   */
+  const size_t maxSymbolSets = 64;
+
+  /*!
+   *  This type holds the symbol sets a symbol is in. Bit N is set if the
+   *  symbol is in the Nth symbol set.
+   */
+  typedef std::bitset<maxSymbolSets> setMembership_t;
+
   /*! @class SymbolInformation
    *
    *  This class defines the information kept for each symbol that is
@@ -174,6 +207,11 @@ namespace Coverage {
      */
     CoverageMapBase* unifiedCoverageMap;
 
+    /*!
+     *  This member contains the symbol sets the symbol is in.
+     */
+    setMembership_t sets;
+
     /*!
      *  This method constructs a SymbolInformation instance.
      */
@@ -221,16 +259,19 @@ namespace Coverage {
      *  This method loops through the coverage map and
      *  calculates the statistics that have not already
      *  been filled in.
+     *
+     *  @param[in] jobs specifies the number of symbols worked at once
      */
-    void calculateStatistics( void );
+    void calculateStatistics( unsigned int jobs );
 
     /*!
      *  This method analyzes each symbols coverage map to determine any
      *  uncovered ranges or branches.
      *
      *  @param[in] verbose specifies whether to be verbose with output
+     *  @param[in] jobs specifies the number of symbols worked at once
      */
-    void computeUncovered( bool verbose );
+    void computeUncovered( bool verbose, unsigned int jobs );
 
     /*!
      *  This method creates a coverage map for the specified symbol
@@ -348,7 +389,8 @@ namespace Coverage {
     ) const;
 
     /*!
-     *  This method returns all symbol set names.
+     *  This method returns the names of the symbol sets holding a symbol
+     *  in name order.
      *
      *  @return Returns all symbol set names
      */
@@ -359,9 +401,9 @@ namespace Coverage {
      *
      *  @param[in] symbolSetName specifies the symbol set of interest
      *
-     *  @return Returns all symbols for the given set
+     *  @return Returns all symbols for the given set in name order
      */
-    const std::vector<std::string>& getSymbolsForSet(
+    std::vector<std::string> getSymbolsForSet(
       const std::string& symbolSetName
     ) const;
 
@@ -378,17 +420,22 @@ namespace Coverage {
 
     /*!
      *  This method creates the set of symbols to analyze from the symbols
-     *  listed in the specified file.
+     *  listed in the specified file. The libraries of all the sets are
+     *  loaded once and the symbols of the object files are read by up to
+     *  the number of jobs at once.
      *
      *  @param[in] symbolsSet An INI format file of the symbols to be loaded.
      *  @param[in] buildTarget The build target
      *  @param[in] buildBSP The BSP
+     *  @param[in] verbose specifies whether to be verbose with output
+     *  @param[in] jobs specifies the number of object files read at once
      */
     void load(
       const std::string& symbolsSet,
       const std::string& buildTarget,
       const std::string& buildBSP,
-      bool               verbose
+      bool               verbose,
+      unsigned int       jobs
     );
 
     /*!
@@ -414,13 +461,38 @@ namespace Coverage {
 
   private:
 
+    /*!
+     *  This type is the work done for a symbol of a set. The statistics
+     *  of the set start at zero and are added to the set's statistics
+     *  with the messages printed once all the symbols have been worked.
+     */
+    typedef std::function<void (
+      const std::string& symbol,
+      SymbolInformation& info,
+      Statistics&        setStats,
+      std::ostream&      messages
+    )> symbolWork;
+
+    /*!
+     *  This method does the work for each symbol of each set. The sets
+     *  are worked one after the other in the set order and the symbols of
+     *  a set are worked at the same time by up to the number of jobs. The
+     *  results are added in the set order and then the symbol order so
+     *  they do not depend on the number of jobs.
+     *
+     *  @param[in] jobs specifies the number of symbols worked at once
+     *  @param[in] work specifies the work for a symbol of a set
+     */
+    void forEachSymbol( unsigned int jobs, const symbolWork& work );
+
     /*!
      *  This method uses the specified executable file to determine the
-     *  source lines for the elements in the specified ranges.
+     *  source lines for the elements in the specified ranges. The source
+     *  lines of all the ranges are looked up together.
      */
     void determineSourceLines(
-      CoverageRanges* const theRanges,
-      ExecutableInfo* const theExecutable
+      const std::vector<CoverageRanges*>& theRanges,
+      ExecutableInfo* const               theExecutable
     );
 
     /*!
@@ -430,9 +502,28 @@ namespace Coverage {
     symbolSet_t set;
 
     /*!
-     *  This variable contains a map of symbol set names to symbol name lists.
+     *  This variable contains the symbol set names in the order they are
+     *  listed in the symbol set file. The index of a name is its bit in a
+     *  symbol's set membership.
+     */
+    std::vector<std::string> setNames;
+
+    /*!
+     *  This variable contains the indexes of the symbol set names in name
+     *  order. The sets are worked and reported in this order.
+     */
+    std::vector<size_t> setOrder;
+
+    /*!
+     *  This variable contains the symbols of each symbol set in the order
+     *  they are worked.
+     */
+    std::vector<std::vector<symbolSet_t::value_type*>> setSymbols;
+
+    /*!
+     *  This variable contains the symbol sets with at least one symbol.
      */
-    std::map<std::string, std::vector<std::string>> setNamesToSymbols;
+    setMembership_t usedSets;
 
     /*!
      *  This member contains a map of symbol set names to statistics.
@@ -7,8 +7,13 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include <rld.h>
 
+#include "AnalysisCache.h"
+#include "ContentHash.h"
 #include "ExecutableInfo.h"
 #include "ObjdumpProcessor.h"
 #include "CoverageMap.h"
@@ -20,8 +25,13 @@ namespace Coverage {
     const char* const  theExecutableName,
     const std::string& theLibraryName,
     bool               verbose,
-    DesiredSymbols&    symbolsToAnalyze
+    DesiredSymbols&    symbolsToAnalyze,
+    AnalysisCache*     cache
     ) : fileName( theExecutableName ),
+        analysisCache( cache ),
+        analysisKey( 0 ),
+        hasText( false ),
+        lastCoverageMapHit( 0 ),
         loadAddress( 0 ),
         symbolsToAnalyze_m( symbolsToAnalyze )
   {
@@ -44,18 +54,163 @@ namespace Coverage {
     executable.begin();
     executable.load_symbols( symbols );
 
-    rld::dwarf::file debug;
+    // The symbols and debug information of an executable found in the
+    // cache are not read again.
+    ExecutableAnalysis analysis;
+    bool               cached = false;
+
+    if ( analysisCache != nullptr ) {
+      analysisKey = analysisCache->getKey( executable );
+      cached = analysisCache->load( analysisKey, analysis );
+      if ( verbose && cached ) {
+        std::cerr << "Using cached analysis of " << theExecutableName
+                  << std::endl;
+      }
+    }
+
+    if ( !cached ) {
+      readSymbolStarts( executable, analysis );
+      readDebug( executable, analysis );
+      if ( analysisCache != nullptr ) {
+        analysisCache->save( analysisKey, analysis );
+      }
+    }
+
+    findDesiredBodies( executable, analysis );
+    updateDesiredRanges();
+    loadDebug( analysis );
+  }
+
+  ExecutableInfo::ExecutableInfo(
+    const std::string& theName,
+    uint32_t           lowAddress,
+    uint32_t           highAddress,
+    DesiredSymbols&    symbolsToAnalyze
+    ) : fileName( theName ),
+        analysisCache( nullptr ),
+        analysisKey( 0 ),
+        hasText( false ),
+        lastCoverageMapHit( 0 ),
+        loadAddress( 0 ),
+        symbolsToAnalyze_m( symbolsToAnalyze )
+  {
+    createCoverageMap( theName, theName, lowAddress, highAddress );
+    theSymbolTable.addSymbol(
+      theName,
+      lowAddress,
+      highAddress - lowAddress + 1
+    );
+    buildCoverageMapIndex();
+  }
+
+  ExecutableInfo::~ExecutableInfo()
+  {
+  }
+
+  void ExecutableInfo::readSymbolStarts(
+    rld::files::object& executable,
+    ExecutableAnalysis& analysis
+  )
+  {
+    rld::elf::sections     sections;
+    rld::elf::section*     text = nullptr;
+    rld::symbols::pointers syms;
+
+    executable.elf().get_sections( sections, SHT_PROGBITS );
+    for ( auto sec : sections ) {
+      if ( sec->name() == ".text" ) {
+        text = sec;
+        break;
+      }
+    }
+
+    if ( text == nullptr ) {
+      analysis.hasText = false;
+      return;
+    }
+
+    analysis.hasText  = true;
+    analysis.textHigh = text->address() + text->size();
+
+    // Collect the addresses objdump starts a symbol's listing at. Mapping
+    // symbols and local labels are not shown by objdump. The name is
+    // truncated at a '.' in the same way as the objdump processing. The
+    // value of an ARM Thumb function has bit 0 set and objdump labels the
+    // function at the address with the bit clear.
+    bool arm = executable.elf().machinetype() == EM_ARM;
+
+    executable.elf().get_symbols( syms, false, true, true, true );
+    for ( auto sym : syms ) {
+      if ( sym->section_index() != text->index() ) {
+        continue;
+      }
+
+      std::string name = sym->demangled().empty() ?
+        sym->name() : sym->demangled();
+
+      if (
+        name.empty() ||
+        name[0] == '$' ||
+        name.compare( 0, 2, ".L" ) == 0
+      ) {
+        continue;
+      }
+
+      size_t period = name.find( '.' );
+      if ( period != std::string::npos ) {
+        name.erase( period );
+      }
+
+      uint32_t address = static_cast<uint32_t>( sym->value() );
+      if ( arm && sym->type() == STT_FUNC ) {
+        address &= ~static_cast<uint32_t>( 1 );
+      }
+
+      analysis.symbolStarts.push_back(
+        ExecutableAnalysis::SymbolStart{ address, name }
+      );
+    }
+  }
+
+  void ExecutableInfo::readDebug(
+    rld::files::object& executable,
+    ExecutableAnalysis& analysis
+  )
+  {
+    rld::dwarf::file                debug;
+    std::map<std::string, uint32_t> paths;
 
     debug.begin( executable.elf() );
     debug.load_debug();
     debug.load_functions();
 
     for ( auto& cu : debug.get_cus() ) {
-      AddressLineRange& range = mapper.makeRange( cu.pc_low(), cu.pc_high() );
-      // Does not filter on desired symbols under the assumption that the test
-      // code and any support code is small relative to what is being tested.
+      analysis.lineRanges.push_back(
+        ExecutableAnalysis::LineRange{
+          static_cast<uint32_t>( cu.pc_low() ),
+          static_cast<uint32_t>( cu.pc_high() ),
+          {}
+        }
+      );
+
+      ExecutableAnalysis::LineRange& range = analysis.lineRanges.back();
+
       for ( const auto &address : cu.get_addresses() ) {
-        range.addSourceLine( address );
+        auto path = paths.insert(
+          std::make_pair( address.path(), analysis.paths.size() )
+        );
+        if ( path.second ) {
+          analysis.paths.push_back( address.path() );
+        }
+
+        range.lines.push_back(
+          ExecutableAnalysis::Line{
+            address.location(),
+            path.first->second,
+            address.line(),
+            address.is_an_end_sequence()
+          }
+        );
       }
 
       for ( auto& func : cu.get_functions() ) {
@@ -63,45 +218,197 @@ namespace Coverage {
           continue;
         }
 
-        if ( !symbolsToAnalyze_m.isDesired( func.name() ) ) {
-          continue;
-        }
-
-        if ( func.is_inlined() ) {
-          if ( func.is_external() ) {
-            // Flag it
-            std::cerr << "Function is both external and inlined: "
-                      << func.name() << std::endl;
+        analysis.functions.push_back(
+          ExecutableAnalysis::Function{
+            cu.name(),
+            func.name(),
+            func.pc_low(),
+            func.pc_high(),
+            func.is_inlined(),
+            func.is_external(),
+            func.has_entry_pc()
           }
+        );
+      }
+    }
+  }
 
-          if ( func.has_entry_pc() ) {
-            continue;
-          }
+  void ExecutableInfo::findDesiredBodies(
+    rld::files::object&       executable,
+    const ExecutableAnalysis& analysis
+  )
+  {
+    rld::elf::sections sections;
+    rld::elf::section* text = nullptr;
 
-          // If the low PC address is zero, the symbol does not appear in
-          // this executable.
-          if ( func.pc_low() == 0 ) {
-            continue;
-          }
-        }
+    desiredBodies.clear();
+    hasText = analysis.hasText;
 
-        // We can't process a zero size function.
-        if ( func.pc_high() == 0 ) {
-          continue;
-        }
+    if ( !hasText ) {
+      return;
+    }
+
+    // Collect the addresses objdump starts a symbol's listing at, the
+    // names at the address and if a symbol at the address is desired.
+    struct Start {
+      bool                     desired = false;
+      std::vector<std::string> names;
+    };
+
+    std::map<uint32_t, Start> starts;
+
+    for ( const auto& symbol : analysis.symbolStarts ) {
+      Start& start = starts[ symbol.address ];
+      start.names.push_back( symbol.name );
+      if ( symbolsToAnalyze_m.isDesired( symbol.name ) ) {
+        start.desired = true;
+      }
+    }
+
+    std::vector<std::vector<std::string>> names;
+
+    for ( auto start = starts.begin(); start != starts.end(); ++start ) {
+      if ( !start->second.desired ) {
+        continue;
+      }
+
+      auto        next = std::next( start );
+      DesiredBody body = DesiredBody();
+
+      body.low  = start->first;
+      body.high = analysis.textHigh;
+      body.last = true;
+
+      if ( next != starts.end() && next->first < analysis.textHigh ) {
+        body.high = next->first;
+        body.last = false;
+      }
+
+      desiredBodies.push_back( body );
+      names.push_back( start->second.names );
+    }
+
+    // Hash the bytes of each body.
+    executable.elf().get_sections( sections, SHT_PROGBITS );
+    for ( auto sec : sections ) {
+      if ( sec->name() == ".text" ) {
+        text = sec;
+        break;
+      }
+    }
+
+    rld::elf::elf_data* data = text == nullptr ? nullptr : text->data();
+    uint32_t            textLow = text == nullptr ? 0 : text->address();
+
+    for ( size_t b = 0; b < desiredBodies.size(); ++b ) {
+      DesiredBody& body = desiredBodies[ b ];
+      ContentHash  hash;
+      uint32_t     size = body.high - body.low;
 
-        createCoverageMap(
-          cu.name(),
-          func.name(),
-          func.pc_low(),
-          func.pc_high() - 1
+      // The names are part of the hash because objdump labels the listing
+      // with one of them.
+      std::sort( names[ b ].begin(), names[ b ].end() );
+      for ( const auto& name : names[ b ] ) {
+        hash.add( name );
+      }
+
+      hash.add( static_cast<uint64_t>( size ) );
+      if (
+        ( data != nullptr ) &&
+        ( data->d_buf != nullptr ) &&
+        ( body.low >= textLow ) &&
+        ( body.high - textLow <= data->d_size )
+      ) {
+        hash.add(
+          static_cast<const uint8_t*>( data->d_buf ) + ( body.low - textLow ),
+          size
         );
+        body.shareable = !body.last;
       }
+
+      body.hash = hash.get();
     }
   }
 
-  ExecutableInfo::~ExecutableInfo()
+  void ExecutableInfo::updateDesiredRanges()
   {
+    desiredRanges.clear();
+
+    if ( !hasText ) {
+      desiredRanges.push_back( DesiredRange{ 0, UINT32_MAX } );
+      return;
+    }
+
+    // Create the ranges of the bodies that are dumped merging any that
+    // touch. A range ends just after the start of the next symbol so the
+    // end of a body can be seen.
+    for ( const auto& body : desiredBodies ) {
+      if ( body.owner != nullptr ) {
+        continue;
+      }
+
+      uint32_t high = body.last ? body.high : body.high + 1;
+
+      if ( !desiredRanges.empty() && desiredRanges.back().high >= body.low ) {
+        desiredRanges.back().high = high;
+      } else {
+        desiredRanges.push_back( DesiredRange{ body.low, high } );
+      }
+    }
+  }
+
+  void ExecutableInfo::loadDebug( const ExecutableAnalysis& analysis )
+  {
+    for ( const auto& lines : analysis.lineRanges ) {
+      AddressLineRange& range = mapper.makeRange( lines.low, lines.high );
+      // Does not filter on desired symbols under the assumption that the test
+      // code and any support code is small relative to what is being tested.
+      for ( const auto& line : lines.lines ) {
+        range.addSourceLine(
+          line.address,
+          analysis.paths[ line.path ],
+          line.line,
+          line.endSequence
+        );
+      }
+    }
+    mapper.buildIndex();
+
+    for ( const auto& func : analysis.functions ) {
+      if ( !symbolsToAnalyze_m.isDesired( func.name ) ) {
+        continue;
+      }
+
+      if ( func.inlined ) {
+        if ( func.external ) {
+          // Flag it
+          std::cerr << "Function is both external and inlined: "
+                    << func.name << std::endl;
+        }
+
+        if ( func.entryPc ) {
+          continue;
+        }
+
+        // If the low PC address is zero, the symbol does not appear in
+        // this executable.
+        if ( func.low == 0 ) {
+          continue;
+        }
+      }
+
+      // We can't process a zero size function.
+      if ( func.high == 0 ) {
+        continue;
+      }
+
+      createCoverageMap(
+        func.compUnit,
+        func.name,
+        func.low,
+        func.high - 1
+      );
+    }
   }
 
   void ExecutableInfo::dumpCoverageMaps()
@@ -124,19 +431,126 @@ namespace Coverage {
     theSymbolTable.dumpSymbolTable();
   }
 
+  void ExecutableInfo::buildCoverageMapIndex()
+  {
+    const SymbolTable::contents_t& contents = theSymbolTable.getContents();
+
+    coverageMapIndex.clear();
+    coverageMapIndexHigh.clear();
+    coverageMapIndex.reserve( contents.size() );
+    coverageMapIndexHigh.reserve( contents.size() );
+    lastCoverageMapHit = 0;
+
+    for ( const auto& c : contents ) {
+      CoverageMapRange range;
+      range.low  = c.second.low;
+      range.high = c.second.high;
+      range.map  = &findCoverageMap( c.second.symbol );
+      coverageMapIndex.push_back( range );
+      coverageMapIndexHigh.push_back( c.first );
+    }
+
+    instructionIndex.build();
+  }
+
+  void ExecutableInfo::addInstruction( uint32_t address )
+  {
+    instructionIndex.add( address );
+  }
+
+  const InstructionIndex& ExecutableInfo::getInstructionIndex() const
+  {
+    return instructionIndex;
+  }
+
   CoverageMapBase* ExecutableInfo::getCoverageMap( uint32_t address )
   {
-    CoverageMapBase*       aCoverageMap = NULL;
-    CoverageMaps::iterator it;
-    std::string            itsSymbol;
+    const size_t entries = coverageMapIndex.size();
+
+    if ( entries == 0 ) {
+      return NULL;
+    }
+
+    // The last hit is the answer if the address is inside it and the
+    // entry before it ends below the address.
+    size_t hit = lastCoverageMapHit;
+    if (
+      ( address >= coverageMapIndex[hit].low ) &&
+      ( address <= coverageMapIndex[hit].high ) &&
+      ( hit == 0 || coverageMapIndex[hit - 1].high < address )
+    ) {
+      return coverageMapIndex[hit].map;
+    }
+
+    // Find the first entry whose end address is not less than the
+    // specified address.
+    std::vector<uint32_t>::const_iterator it = std::lower_bound(
+      coverageMapIndexHigh.begin(),
+      coverageMapIndexHigh.end(),
+      address
+    );
+    if ( it == coverageMapIndexHigh.end() ) {
+      return NULL;
+    }
 
-    // Obtain the coverage map containing the specified address.
-    itsSymbol = theSymbolTable.getSymbol( address );
-    if ( itsSymbol != "" ) {
-      aCoverageMap = &findCoverageMap( itsSymbol );
+    hit = it - coverageMapIndexHigh.begin();
+    if ( coverageMapIndex[hit].low > address ) {
+      return NULL;
     }
 
-    return aCoverageMap;
+    lastCoverageMapHit = hit;
+
+    return coverageMapIndex[hit].map;
+  }
+
+  void ExecutableInfo::setBlockWasExecuted( uint32_t address, uint32_t size )
+  {
+    uint64_t a = address;
+    uint64_t end = a + size;
+
+    while ( a < end ) {
+      // Find the first entry whose end address is not less than the
+      // address. Skip to its start if the address is in a gap.
+      std::vector<uint32_t>::const_iterator it = std::lower_bound(
+        coverageMapIndexHigh.begin(),
+        coverageMapIndexHigh.end(),
+        (uint32_t) a
+      );
+      if ( it == coverageMapIndexHigh.end() ) {
+        break;
+      }
+
+      const CoverageMapRange& range =
+        coverageMapIndex[it - coverageMapIndexHigh.begin()];
+      if ( range.low > a ) {
+        a = range.low;
+        continue;
+      }
+
+      uint64_t last = std::min( end, (uint64_t) range.high + 1 );
+      range.map->setBlockWasExecuted( a, last - a );
+      a = last;
+    }
+  }
+
+  AnalysisCache* ExecutableInfo::getAnalysisCache() const
+  {
+    return analysisCache;
+  }
+
+  uint64_t ExecutableInfo::getAnalysisKey() const
+  {
+    return analysisKey;
+  }
+
+  ExecutableInfo::DesiredBodies& ExecutableInfo::getDesiredBodies()
+  {
+    return desiredBodies;
+  }
+
+  const ExecutableInfo::DesiredRanges& ExecutableInfo::getDesiredRanges() const
+  {
+    return desiredRanges;
   }
 
   const std::string& ExecutableInfo::getFileName() const
@@ -171,6 +585,11 @@ namespace Coverage {
     return *(cmi->second);
   }
 
+  bool ExecutableInfo::hasCoverageMap( const std::string& symbolName ) const
+  {
+    return coverageMaps.find( symbolName ) != coverageMaps.end();
+  }
+
   void ExecutableInfo::createCoverageMap (
     const std::string& fileName,
     const std::string& symbolName,
@@ -215,6 +634,22 @@ namespace Coverage {
     line = ss.str ();
   }
 
+  void ExecutableInfo::getSourceAndLines(
+    const std::vector<uint32_t>& addresses,
+    std::vector<std::string>&    lines
+  )
+  {
+    std::vector<std::string> files;
+    std::vector<int>         lnos;
+
+    mapper.getSources( addresses, files, lnos );
+
+    lines.resize( addresses.size() );
+    for ( size_t a = 0; a < addresses.size(); ++a ) {
+      lines[ a ] = files[ a ] + ':' + std::to_string( lnos[ a ] );
+    }
+  }
+
   bool ExecutableInfo::hasDynamicLibrary()
   {
     return !libraryName.empty();
@@ -10,6 +10,7 @@
 #include <map>
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 #include <rld-dwarf.h>
 #include <rld-files.h>
@@ -17,12 +18,15 @@
 
 #include "AddressToLineMapper.h"
 #include "CoverageMapBase.h"
+#include "InstructionIndex.h"
 #include "SymbolTable.h"
 #include "DesiredSymbols.h"
 
 namespace Coverage {
 
+class AnalysisCache;
 class DesiredSymbols;
+struct ExecutableAnalysis;
 
   /*! @class ExecutableInfo
    *
@@ -38,6 +42,81 @@ class DesiredSymbols;
       using std::runtime_error::runtime_error;
     };
 
+    /*!
+     *  This structure is an address range of the executable's .text
+     *  section holding desired symbols. A range starts at a desired
+     *  symbol and ends just after the start of the symbol that follows
+     *  the range so the end of the last desired symbol can be seen. The
+     *  high address is not part of the range.
+     */
+    struct DesiredRange {
+      uint32_t low;
+      uint32_t high;
+    };
+
+    /*!
+     *  This type defines the desired ranges in address order.
+     */
+    typedef std::vector<DesiredRange> DesiredRanges;
+
+    /*!
+     *  This structure is the body of a desired symbol in the .text
+     *  section. The body runs from the symbol to the next symbol or the
+     *  end of the .text section and includes any padding. Identical
+     *  bodies in different executables have the same hash. A body can use
+     *  the object dump listing of an identical body at the same address in
+     *  another executable.
+     */
+    struct DesiredBody {
+      /*!
+       *  The address of the symbol.
+       */
+      uint32_t low;
+
+      /*!
+       *  The address after the body. It is not part of the body.
+       */
+      uint32_t high;
+
+      /*!
+       *  This is true if the body is the last in the .text section.
+       */
+      bool last;
+
+      /*!
+       *  This is true if the body can be shared with other executables.
+       *  The last body is not shared because its listing ends the object
+       *  dump. A body whose bytes could not be read is not shared.
+       */
+      bool shareable;
+
+      /*!
+       *  The hash of the body's bytes and size.
+       */
+      uint64_t hash;
+
+      /*!
+       *  The executable holding the identical body whose listing is used
+       *  or null if the body is dumped.
+       */
+      const ExecutableInfo* owner;
+
+      /*!
+       *  The address of the identical body in the owner.
+       */
+      uint32_t ownerLow;
+
+      /*!
+       *  This is true if other executables use the body's listing.
+       */
+      bool shared;
+    };
+
+    /*!
+     *  This type defines the desired bodies in address order.
+     */
+    typedef std::vector<DesiredBody> DesiredBodies;
+
     /*!
      *  This method constructs an ExecutableInfo instance.
      *
@@ -45,11 +124,30 @@ class DesiredSymbols;
      *  @param[in] theLibraryName specifies the name of the executable
      *  @param[in] verbose specifies whether to be verbose with output
      *  @param[in] symbolsToAnalyze the symbols to be analyzed
+     *  @param[in] cache the analysis cache or null
      */
     ExecutableInfo(
       const char* const  theExecutableName,
       const std::string& theLibraryName,
       bool               verbose,
+      DesiredSymbols&    symbolsToAnalyze,
+      AnalysisCache*     cache = nullptr
+    );
+
+    /*!
+     *  This method constructs an ExecutableInfo instance without an
+     *  executable. It holds a single coverage map for an address range so
+     *  coverage files can be read for the range.
+     *
+     *  @param[in] theName specifies the name of the coverage map
+     *  @param[in] lowAddress specifies the low address of the range
+     *  @param[in] highAddress specifies the high address of the range
+     *  @param[in] symbolsToAnalyze the symbols to be analyzed
+     */
+    ExecutableInfo(
+      const std::string& theName,
+      uint32_t           lowAddress,
+      uint32_t           highAddress,
       DesiredSymbols&    symbolsToAnalyze
     );
 
@@ -69,6 +167,13 @@ class DesiredSymbols;
      */
     void dumpExecutableInfo();
 
+    /*!
+     *  This method builds the index used to find the coverage map
+     *  containing an address. It is called once the symbol table has
+     *  been loaded from the objdump.
+     */
+    void buildCoverageMapIndex();
+
     /*!
      *  This method returns a pointer to the executable's coverage map
      *  that contains the specified address.
@@ -79,6 +184,72 @@ class DesiredSymbols;
      */
     CoverageMapBase* getCoverageMap( uint32_t address );
 
+    /*!
+     *  This method marks @p size addresses from @p address as executed in
+     *  the coverage maps which contain them. It is the same as calling
+     *  setWasExecuted() on the coverage map returned by getCoverageMap()
+     *  for each address but it looks up each coverage map once.
+     *
+     *  @param[in] address specifies the first executed address
+     *  @param[in] size specifies the number of executed addresses
+     */
+    void setBlockWasExecuted( uint32_t address, uint32_t size );
+
+    /*!
+     *  This method adds the start of an instruction of a desired symbol
+     *  to the instruction index.
+     *
+     *  @param[in] address specifies the start of the instruction
+     */
+    void addInstruction( uint32_t address );
+
+    /*!
+     *  This method returns the index of the starts of the instructions of
+     *  the desired symbols. It is built with the coverage map index.
+     *
+     *  @return Returns the instruction index
+     */
+    const InstructionIndex& getInstructionIndex() const;
+
+    /*!
+     *  This method returns the analysis cache used by the executable.
+     *
+     *  @return Returns the analysis cache or null if there is none
+     */
+    AnalysisCache* getAnalysisCache() const;
+
+    /*!
+     *  This method returns the key of the executable in the analysis
+     *  cache.
+     *
+     *  @return Returns the key of the executable
+     */
+    uint64_t getAnalysisKey() const;
+
+    /*!
+     *  This method returns the address ranges of the executable that hold
+     *  desired symbols. The ranges are found using the executable's ELF
+     *  symbol table. If the executable has no .text section a single range
+     *  covers all addresses.
+     *
+     *  @return Returns the desired ranges in address order
+     */
+    const DesiredRanges& getDesiredRanges() const;
+
+    /*!
+     *  This method returns the bodies of the desired symbols in the .text
+     *  section.
+     *
+     *  @return Returns the desired bodies in address order
+     */
+    DesiredBodies& getDesiredBodies();
+
+    /*!
+     *  This method updates the desired ranges so they only hold the
+     *  desired bodies that do not use the listing of another executable.
+     */
+    void updateDesiredRanges();
+
     /*!
      *  This method returns the file name of the executable.
      *
@@ -116,6 +287,14 @@ class DesiredSymbols;
      */
     CoverageMapBase& findCoverageMap( const std::string& symbolName );
 
+    /*!
+     *  This method returns true if there is a coverage map for the
+     *  specified symbol.
+     *
+     *  @param[in] symbolName specifies the name of the symbol
+     */
+    bool hasCoverageMap( const std::string& symbolName ) const;
+
     /*!
      *  This method gets the source location, the file and line number given an
      *  address.
@@ -125,6 +304,19 @@ class DesiredSymbols;
       std::string&       location
     );
 
+    /*!
+     *  This method gets the source locations of a list of addresses in one
+     *  pass over the address-to-line information. The addresses do not need
+     *  to be sorted.
+     *
+     *  @param[in] addresses specifies the addresses to look up
+     *  @param[out] locations specifies the location of each address
+     */
+    void getSourceAndLines(
+      const std::vector<uint32_t>& addresses,
+      std::vector<std::string>&    locations
+    );
+
     /*!
      *  This method indicates whether a dynamic library has been
      *  associated with the executable.
@@ -149,6 +341,50 @@ class DesiredSymbols;
 
   private:
 
+    /*!
+     *  This method reads the symbols in the .text section from the
+     *  executable's ELF symbol table.
+     *
+     *  @param[in] executable is the open executable
+     *  @param[out] analysis holds the symbols read
+     */
+    void readSymbolStarts(
+      rld::files::object& executable,
+      ExecutableAnalysis& analysis
+    );
+
+    /*!
+     *  This method reads the lines and functions from the executable's
+     *  DWARF debug information.
+     *
+     *  @param[in] executable is the open executable
+     *  @param[out] analysis holds the lines and functions read
+     */
+    void readDebug(
+      rld::files::object& executable,
+      ExecutableAnalysis& analysis
+    );
+
+    /*!
+     *  This method finds the bodies of the desired symbols using the
+     *  symbols in the .text section and hashes the bodies.
+     *
+     *  @param[in] executable is the open executable
+     *  @param[in] analysis is the analysis of the executable
+     */
+    void findDesiredBodies(
+      rld::files::object&       executable,
+      const ExecutableAnalysis& analysis
+    );
+
+    /*!
+     *  This method creates the address-to-line mapper and the coverage
+     *  maps of the desired symbols from the debug information.
+     *
+     *  @param[in] analysis is the analysis of the executable
+     */
+    void loadDebug( const ExecutableAnalysis& analysis );
+
     /*!
      *  This method creates a coverage map for the specified symbol.
      *
@@ -174,6 +410,31 @@ class DesiredSymbols;
      */
     rld::symbols::table symbols;
 
+    /*!
+     *  The analysis cache or null if there is none.
+     */
+    AnalysisCache* analysisCache;
+
+    /*!
+     *  The key of the executable in the analysis cache.
+     */
+    uint64_t analysisKey;
+
+    /*!
+     *  This is true if the executable has a .text section.
+     */
+    bool hasText;
+
+    /*!
+     *  The bodies of the desired symbols.
+     */
+    DesiredBodies desiredBodies;
+
+    /*!
+     *  The address ranges holding desired symbols.
+     */
+    DesiredRanges desiredRanges;
+
     /*!
      *  The address-to-line mapper for this executable.
      */
@@ -185,6 +446,35 @@ class DesiredSymbols;
     typedef std::map<std::string, CoverageMapBase *> CoverageMaps;
     CoverageMaps coverageMaps;
 
+    /*!
+     *  This structure is an entry in the address to coverage map index.
+     */
+    struct CoverageMapRange {
+      uint32_t         low;
+      uint32_t         high;
+      CoverageMapBase* map;
+    };
+
+    /*!
+     *  The address to coverage map index. The entries are ordered by
+     *  their high address in the same way as the symbol table. The high
+     *  addresses are also held in a separate contiguous table that is
+     *  searched.
+     */
+    std::vector<CoverageMapRange> coverageMapIndex;
+    std::vector<uint32_t>         coverageMapIndexHigh;
+
+    /*!
+     *  The index entry of the last successful lookup. Consecutive
+     *  addresses are usually in the same symbol.
+     */
+    size_t lastCoverageMapHit;
+
+    /*!
+     *  The starts of the instructions in the coverage maps.
+     */
+    InstructionIndex instructionIndex;
+
     /*!
      *  This member variable contains the name of a dynamic library
      *  associated with the executable.
@@ -109,15 +109,18 @@ namespace Coverage {
     const std::string& start
   )
   {
-    if ( set.find( start ) == set.end() ) {
+    std::lock_guard<std::mutex> lock( lookupLock );
+
+    auto explanation = set.find( start );
+    if ( explanation == set.end() ) {
       #if 0
         std::cerr << "Warning: Unable to find explanation for "
                   << start << std::endl;
       #endif
       return NULL;
     }
-    set[ start ].found = true;
-    return &set[ start ];
+    explanation->second.found = true;
+    return &explanation->second;
   }
 
   void Explanations::writeNotFound( const std::string& fileName )
@@ -8,6 +8,7 @@
 #define __EXPLANATIONS_H__
 
 #include <map>
+#include <mutex>
 #include <stdint.h>
 #include <string>
 #include <vector>
@@ -91,7 +92,8 @@ namespace Coverage {
 
     /*!
      *  This method returns the explanation associated with the
-     *  specified starting line number.
+     *  specified starting line number. It can be called by more than one
+     *  report at the same time.
      *
      *  @param[in] start specifies the starting line number for
      *             which to search
@@ -106,6 +108,13 @@ namespace Coverage {
      */
     void writeNotFound( const std::string& fileName );
 
+  private:
+
+    /*!
+     *  This member variable serialises marking explanations as found.
+     */
+    std::mutex lookupLock;
+
   };
 
 }
@@ -67,6 +67,10 @@ namespace Gcov {
 
       // construct source file name
       tempString3 = tempString3.replace( index, strlen( ".gcno" ), ".c" );
+
+      gcdaFileName = tempString;
+      textFileName = tempString2;
+      cFileName    = tempString3;
     }
 
     // Debug message
@@ -500,16 +504,123 @@ namespace Gcov {
              << std::endl << std::endl;
   }
 
-  void GcovData::writeGcovFile()
+  bool GcovData::writeGcovFile()
   {
-    //std::cerr << "Attempting to run gcov for: " << cFileName << std::endl;
-    std::ostringstream command;
-
-    command << "(  cd " << rld::path::dirname( cFileName )
-            << " && gcov " << rld::path::basename( cFileName )
-            << " &>> gcov.log)";
-    //std::cerr << "> " << command << std::endl;
-    system( command.str().c_str() );
+    sourceLineCounts_t sourceLines;
+    bool               status = true;
+
+    for ( const auto& function : functions ) {
+      function.getLineCounts( sourceLines );
+    }
+
+    for ( const auto& source : sourceLines ) {
+      if ( !writeGcovSourceFile( source.first, source.second ) ) {
+        status = false;
+      }
+    }
+
+    return status;
+  }
+
+  bool GcovData::writeGcovSourceFile(
+    const std::string&  sourceName,
+    const lineCounts_t& lines
+  )
+  {
+    std::string   directory = ".";
+    std::string   sourcePath = sourceName;
+    std::string   gcovFileName;
+    std::string   tempFileName;
+    std::ifstream sourceFile;
+    std::ofstream gcovFile;
+    std::string   text;
+    uint32_t      lineNumber = 0;
+
+    // The paths in the notes file are relative to the directory the
+    // object was built in, which is where the notes file is.
+    if ( cFileName.find( '/' ) != std::string::npos ) {
+      directory = rld::path::dirname( cFileName );
+    }
+    if ( sourcePath.empty() || sourcePath[ 0 ] != '/' ) {
+      rld::path::path_join( directory, sourceName, sourcePath );
+    }
+
+    rld::path::path_join(
+      directory,
+      rld::path::basename( sourceName ) + ".gcov",
+      gcovFileName
+    );
+
+    // A header can be in more than one notes file so write to a file of
+    // our own and rename it over any report already written.
+    tempFileName = gcovFileName + "." + rld::path::basename( gcnoFileName );
+
+    gcovFile.open( tempFileName );
+    if ( !gcovFile.is_open() ) {
+      std::cerr << "Unable to create " << tempFileName << std::endl;
+      return false;
+    }
+
+    gcovFile << std::setw( 9 ) << "-" << ':' << std::setw( 5 ) << 0
+             << ":Source:" << sourceName << '\n'
+             << std::setw( 9 ) << "-" << ':' << std::setw( 5 ) << 0
+             << ":Graph:" << rld::path::basename( gcnoFileName ) << '\n'
+             << std::setw( 9 ) << "-" << ':' << std::setw( 5 ) << 0
+             << ":Data:" << rld::path::basename( gcdaFileName ) << '\n'
+             << std::setw( 9 ) << "-" << ':' << std::setw( 5 ) << 0
+             << ":Runs:1" << '\n'
+             << std::setw( 9 ) << "-" << ':' << std::setw( 5 ) << 0
+             << ":Programs:1" << '\n';
+
+    sourceFile.open( sourcePath );
+    if ( !sourceFile.is_open() ) {
+      std::cerr << "Unable to open " << sourcePath << std::endl;
+    }
+
+    auto line = lines.begin();
+
+    // Each line of the source has its count, a line with code that was not
+    // run is marked with #####. The lines with counts after the end of the
+    // source are marked /*EOF*/ as gcov does.
+    while ( true ) {
+      bool haveText = sourceFile.is_open() && std::getline( sourceFile, text );
+
+      if ( !haveText && line == lines.end() ) {
+        break;
+      }
+
+      ++lineNumber;
+
+      if ( line != lines.end() && line->first == lineNumber ) {
+        if ( line->second == 0 ) {
+          gcovFile << std::setw( 9 ) << "#####";
+        } else {
+          gcovFile << std::setw( 9 ) << line->second;
+        }
+        ++line;
+      } else {
+        gcovFile << std::setw( 9 ) << "-";
+      }
+
+      gcovFile << ':' << std::setw( 5 ) << lineNumber << ':'
+               << ( haveText ? text : "/*EOF*/" ) << '\n';
+    }
+
+    gcovFile.close();
+    if ( gcovFile.fail() ) {
+      std::cerr << "Error while writing " << tempFileName << std::endl;
+      ::remove( tempFileName.c_str() );
+      return false;
+    }
+
+    if ( ::rename( tempFileName.c_str(), gcovFileName.c_str() ) != 0 ) {
+      std::cerr << "Unable to rename " << tempFileName << " to "
+                << gcovFileName << std::endl;
+      ::remove( tempFileName.c_str() );
+      return false;
+    }
+
+    return true;
   }
 
   bool GcovData::processCounters()
@@ -106,10 +106,15 @@ class DesiredSymbols;
     bool writeReportFile();
 
     /*!
-     *  This method runs gcov to generate report. This method should
-     *  be used only when gcno and gcda files are already generated.
+     *  This method writes the gcov text report of each source file with
+     *  lines in the *.gcno file. The report is named after the source file
+     *  with a .gcov extension and is written to the directory of the
+     *  *.gcno file in the same format gcov uses. This method should be
+     *  used only after the counters are processed.
+     *
+     *  @return Returns TRUE if the method succeeded and FALSE if it failed.
      */
-    void writeGcovFile();
+    bool writeGcovFile();
 
     /*!
      *  This method calculates values of counters for all functions
@@ -195,6 +200,19 @@ class DesiredSymbols;
      */
     void printGcnoFileInfo( std::ofstream& textFile );
 
+    /*!
+     *  This method writes the gcov text report of a source file.
+     *
+     *  @param[in] sourceName is the name of the source file in the *.gcno file
+     *  @param[in] lines are the execution counts of the source file's lines
+     *
+     *  @return Returns TRUE if the method succeeded and FALSE if it failed.
+     */
+    bool writeGcovSourceFile(
+      const std::string&  sourceName,
+      const lineCounts_t& lines
+    );
+
     /*!
      * This member variable contains the symbols to be analyzed
      */
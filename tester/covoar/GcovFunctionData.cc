@@ -389,6 +389,35 @@ namespace Gcov {
     textFile << std::endl;
   }
 
+  void GcovFunctionData::getLineCounts( sourceLineCounts_t& sourceLines ) const
+  {
+    for ( const auto& block : blocks ) {
+      const std::string& fileName =
+        block.sourceFileName.empty() ? sourceFileName : block.sourceFileName;
+
+      if ( block.lines.empty() ) {
+        continue;
+      }
+
+      lineCounts_t& lines = sourceLines[ fileName ];
+
+      for ( const auto line : block.lines ) {
+        // Line 0 is not a source line.
+        if ( line == 0 ) {
+          continue;
+        }
+
+        auto count = lines.find( line );
+
+        if ( count == lines.end() ) {
+          lines[ line ] = block.counter;
+        } else if ( block.counter > count->second ) {
+          count->second = block.counter;
+        }
+      }
+    }
+  }
+
   bool GcovFunctionData::processFunctionCounters() {
 
     uint32_t            baseAddress = 0;
@@ -9,6 +9,8 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <string>
 #include <fstream>
 #include <iomanip>
 #include "CoverageMapBase.h"
@@ -46,6 +48,12 @@ typedef std::list<gcov_arc_info>::iterator   arcs_iterator_t;
 typedef std::list<gcov_block_info>           blocks_t;
 typedef std::list<gcov_block_info>::iterator blocks_iterator_t;
 
+/* The execution count of each line keyed by line number */
+typedef std::map<uint32_t, uint64_t>         lineCounts_t;
+
+/* The line counts of each source file keyed by source file name */
+typedef std::map<std::string, lineCounts_t>  sourceLineCounts_t;
+
 class DesiredSymbols;
 
   /*! @class GcovFunctionData
@@ -232,6 +240,16 @@ class DesiredSymbols;
      */
     bool processFunctionCounters();
 
+    /*!
+     *  This method adds the execution counts of the lines of the function
+     *  to the line counts of the source files. The count of a line is the
+     *  highest count of the blocks on the line. This method should be used
+     *  only after the counters are processed.
+     *
+     *  @param[in] sourceLines are the line counts of the source files
+     */
+    void getLineCounts( sourceLineCounts_t& sourceLines ) const;
+
   private:
 
     uint32_t    id;
@@ -0,0 +1,141 @@
+/*! @file InstructionBenchmark.cc
+ *  @brief Instruction classification benchmark
+ *
+ *  This file contains a program which times the classification of the
+ *  instruction lines of an objdump file by a target's instruction table.
+ *  It prints the number of instructions, nops, nop bytes and conditional
+ *  branches found so a change to a target can be checked against the
+ *  counts before it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rld.h>
+
+#include "TargetBase.h"
+#include "TargetFactory.h"
+
+std::string progname;
+
+void usage()
+{
+  std::cerr << "Usage: "
+            << progname
+            << " -T target [-r repeat] objdump-file"
+            << std::endl;
+  exit( 1 );
+}
+
+int main(
+  int    argc,
+  char** argv
+)
+{
+  int                                 opt;
+  std::string                         target;
+  int                                 repeat = 1;
+  std::vector<std::string>            lines;
+  std::shared_ptr<Target::TargetBase> targetInfo;
+  size_t                              nops = 0;
+  size_t                              nopBytes = 0;
+  size_t                              branches = 0;
+  int                                 i;
+
+  progname = argv[0];
+
+  while ( (opt = getopt( argc, argv, "r:T:" ) ) != -1 ) {
+    switch ( opt ) {
+      case 'r': repeat = atoi( optarg ); break;
+      case 'T': target = optarg;         break;
+      default: usage();
+    }
+  }
+
+  if ( target.empty() || ( optind + 1 ) != argc || repeat < 1 ) {
+    usage();
+  }
+
+  try
+  {
+    std::ifstream dump( argv[optind] );
+    std::string   line;
+
+    if ( !dump.is_open() ) {
+      std::cerr << "Unable to open " << argv[optind] << std::endl;
+      return 1;
+    }
+
+    //
+    // Keep the instruction lines, which are an address, a colon, a tab,
+    // the encoding and a tab.
+    //
+    while ( std::getline( dump, line ) ) {
+      unsigned int address;
+      char         terminator1;
+      char         terminator2;
+
+      if (
+        ( sscanf(
+            line.c_str(), "%x%c\t%*[^\t]%c", &address, &terminator1, &terminator2
+          ) == 3 ) &&
+        ( terminator1 == ':' ) &&
+        ( terminator2 == '\t' )
+      ) {
+        lines.push_back( line );
+      }
+    }
+
+    targetInfo.reset( Target::TargetFactory( target ) );
+
+    auto start = std::chrono::steady_clock::now();
+
+    for ( i = 0; i < repeat; i++ ) {
+      nops = 0;
+      nopBytes = 0;
+      branches = 0;
+
+      for ( const std::string& l : lines ) {
+        Target::TargetBase::instructionClass_t instruction;
+
+        targetInfo->classifyLine( l, instruction );
+
+        if ( instruction.isNop ) {
+          nops++;
+          nopBytes += instruction.nopSize;
+        }
+        if ( instruction.isBranch ) {
+          branches++;
+        }
+      }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start
+    );
+
+    std::cout << "instructions : " << lines.size() << std::endl
+              << "nops         : " << nops << std::endl
+              << "nop bytes    : " << nopBytes << std::endl
+              << "branches     : " << branches << std::endl
+              << "time         : "
+              << ( elapsed.count() / repeat ) << " us per pass" << std::endl;
+  }
+  catch ( rld::error re )
+  {
+    std::cerr << "error: "
+              << re.where << ": " << re.what
+              << std::endl;
+    return 10;
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*! @file InstructionIndex.cc
+ *  @brief InstructionIndex Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  the index of instruction start addresses.
+ */
+
+#include <algorithm>
+
+#include "InstructionIndex.h"
+
+namespace Coverage {
+
+  InstructionIndex::InstructionIndex()
+  {
+  }
+
+  InstructionIndex::~InstructionIndex()
+  {
+  }
+
+  void InstructionIndex::add( uint32_t address )
+  {
+    starts.push_back( address );
+  }
+
+  void InstructionIndex::build()
+  {
+    // The addresses are mostly added in order so check before sorting.
+    if ( !std::is_sorted( starts.begin(), starts.end() ) ) {
+      std::sort( starts.begin(), starts.end() );
+    }
+    starts.erase( std::unique( starts.begin(), starts.end() ), starts.end() );
+  }
+
+  void InstructionIndex::clear()
+  {
+    starts.clear();
+  }
+
+  size_t InstructionIndex::size() const
+  {
+    return starts.size();
+  }
+
+  bool InstructionIndex::isStartOfInstruction( uint32_t address ) const
+  {
+    return std::binary_search( starts.begin(), starts.end(), address );
+  }
+
+  uint32_t InstructionIndex::getAddressAfter( uint32_t address ) const
+  {
+    std::vector<uint32_t>::const_iterator it =
+      std::lower_bound( starts.begin(), starts.end(), address );
+
+    if ( it == starts.end() || *it != address ) {
+      return 0;
+    }
+
+    ++it;
+    if ( it == starts.end() ) {
+      return 0;
+    }
+
+    return *it;
+  }
+
+  bool InstructionIndex::getLastStartInRange(
+    uint32_t  lowAddress,
+    uint32_t  highAddress,
+    uint32_t& start
+  ) const
+  {
+    std::vector<uint32_t>::const_iterator it =
+      std::upper_bound( starts.begin(), starts.end(), highAddress );
+
+    if ( it == starts.begin() ) {
+      return false;
+    }
+
+    --it;
+    if ( *it < lowAddress ) {
+      return false;
+    }
+
+    start = *it;
+    return true;
+  }
+
+}
@@ -0,0 +1,104 @@
+/*! @file InstructionIndex.h
+ *  @brief InstructionIndex Specification
+ *
+ *  This file contains the specification of the InstructionIndex class.
+ */
+
+#ifndef __INSTRUCTION_INDEX_H__
+#define __INSTRUCTION_INDEX_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace Coverage {
+
+  /*! @class InstructionIndex
+   *
+   *  This class holds the start addresses of the instructions of an
+   *  executable as a sorted array so the instruction before or after an
+   *  address is found with a binary search. The addresses are added in
+   *  any order and the index is built before it is searched.
+   */
+  class InstructionIndex {
+
+  public:
+
+    /*!
+     *  This method constructs an InstructionIndex instance.
+     */
+    InstructionIndex();
+
+    /*!
+     *  This method destructs an InstructionIndex instance.
+     */
+    virtual ~InstructionIndex();
+
+    /*!
+     *  This method adds the start address of an instruction.
+     *
+     *  @param[in] address specifies the start of the instruction
+     */
+    void add( uint32_t address );
+
+    /*!
+     *  This method sorts the addresses added and removes duplicates. It
+     *  must be called after adding addresses and before searching.
+     */
+    void build();
+
+    /*!
+     *  This method removes all addresses.
+     */
+    void clear();
+
+    /*!
+     *  This method returns the number of instructions in the index.
+     */
+    size_t size() const;
+
+    /*!
+     *  This method returns true if an instruction starts at the address.
+     *
+     *  @param[in] address specifies the address to check
+     */
+    bool isStartOfInstruction( uint32_t address ) const;
+
+    /*!
+     *  This method returns the start of the instruction after the
+     *  instruction that starts at the address.
+     *
+     *  @param[in] address specifies the start of an instruction
+     *
+     *  @return Returns the start of the next instruction or 0 if no
+     *          instruction starts at the address or it is the last one.
+     */
+    uint32_t getAddressAfter( uint32_t address ) const;
+
+    /*!
+     *  This method finds the highest instruction start in a range of
+     *  addresses.
+     *
+     *  @param[in] lowAddress specifies the low address of the range
+     *  @param[in] highAddress specifies the high address of the range
+     *  @param[out] start is set to the instruction start found
+     *
+     *  @return Returns TRUE if an instruction starts in the range and
+     *          FALSE otherwise.
+     */
+    bool getLastStartInRange(
+      uint32_t  lowAddress,
+      uint32_t  highAddress,
+      uint32_t& start
+    ) const;
+
+  private:
+
+    /*!
+     *  The instruction start addresses.
+     */
+    std::vector<uint32_t> starts;
+  };
+
+}
+#endif
@@ -0,0 +1,98 @@
+/*! @file MappedFile.cc
+ *  @brief MappedFile Implementation
+ *
+ *  This file contains the implementation of the functions supporting
+ *  a file mapped into memory.
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#ifndef __WIN32__
+#include <sys/mman.h>
+#endif
+
+#include "MappedFile.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+namespace Coverage {
+
+  MappedFile::MappedFile() :
+    data_m( nullptr ),
+    size_m( 0 )
+  {
+  }
+
+  MappedFile::~MappedFile()
+  {
+    close();
+  }
+
+  bool MappedFile::open( const std::string& path )
+  {
+    struct stat sb;
+    int         fd;
+
+    close();
+
+    fd = ::open( path.c_str(), O_RDONLY | O_BINARY );
+    if ( fd < 0 ) {
+      return false;
+    }
+
+    if ( ( ::fstat( fd, &sb ) != 0 ) || ( sb.st_size <= 0 ) ) {
+      ::close( fd );
+      return false;
+    }
+
+    size_m = sb.st_size;
+
+#ifdef __WIN32__
+    buffer_m.resize( size_m );
+    size_t have = 0;
+    while ( have < size_m ) {
+      int r = ::read( fd, buffer_m.data() + have, size_m - have );
+      if ( r <= 0 ) {
+        break;
+      }
+      have += r;
+    }
+    ::close( fd );
+    if ( have != size_m ) {
+      buffer_m.clear();
+      size_m = 0;
+      return false;
+    }
+    data_m = buffer_m.data();
+#else
+    void* m = ::mmap( nullptr, size_m, PROT_READ, MAP_PRIVATE, fd, 0 );
+    ::close( fd );
+    if ( m == MAP_FAILED ) {
+      size_m = 0;
+      return false;
+    }
+    data_m = static_cast<const uint8_t*>( m );
+#endif
+
+    return true;
+  }
+
+  void MappedFile::close()
+  {
+    if ( data_m != nullptr ) {
+#ifdef __WIN32__
+      buffer_m.clear();
+#else
+      ::munmap( const_cast<uint8_t*>( data_m ), size_m );
+#endif
+      data_m = nullptr;
+      size_m = 0;
+    }
+  }
+
+}
@@ -0,0 +1,85 @@
+/*! @file MappedFile.h
+ *  @brief MappedFile Specification
+ *
+ *  This file contains the specification of the MappedFile class.
+ */
+
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Coverage {
+
+  /*! @class MappedFile
+   *
+   *  This class maps a file into memory so its fixed layout records are
+   *  accessed in place. A host without mmap reads the file into memory.
+   */
+  class MappedFile {
+
+  public:
+
+    /*!
+     *  This method constructs a MappedFile instance.
+     */
+    MappedFile();
+
+    /*!
+     *  This method destructs a MappedFile instance unmapping the file.
+     */
+    ~MappedFile();
+
+    /*!
+     *  This method maps a file read only.
+     *
+     *  @param[in] path is the path of the file
+     *
+     *  @return Returns TRUE if the file is mapped, FALSE otherwise.
+     */
+    bool open( const std::string& path );
+
+    /*!
+     *  This method unmaps the file.
+     */
+    void close();
+
+    /*!
+     *  This method returns the file's data.
+     */
+    const uint8_t* data() const
+    {
+      return data_m;
+    }
+
+    /*!
+     *  This method returns the size of the file's data.
+     */
+    size_t size() const
+    {
+      return size_m;
+    }
+
+  private:
+
+    /*!
+     *  The mapped data.
+     */
+    const uint8_t* data_m;
+
+    /*!
+     *  The size of the mapped data.
+     */
+    size_t size_m;
+
+    /*!
+     *  The data read from a file on a host without mmap.
+     */
+    std::vector<uint8_t> buffer_m;
+  };
+
+}
+#endif
@@ -15,8 +15,15 @@
 #include <string>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
+#include <exception>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "ObjdumpProcessor.h"
+#include "AnalysisCache.h"
 #include "CoverageMap.h"
 #include "ExecutableInfo.h"
 #include "SymbolTable.h"
@@ -30,12 +37,19 @@
 namespace Coverage {
 
   void finalizeSymbol(
-    ExecutableInfo* const            executableInfo,
-    std::string&                     symbolName,
-    ObjdumpProcessor::objdumpLines_t instructions,
-    bool                             verbose,
-    DesiredSymbols&                  symbolsToAnalyze
+    ExecutableInfo* const               executableInfo,
+    std::string&                        symbolName,
+    ObjdumpProcessor::objdumpLines_t&   instructions,
+    ObjdumpProcessor::objdumpSymbols_t& symbols
   ) {
+    symbols.push_back( ObjdumpProcessor::objdumpSymbol_t() );
+
+    ObjdumpProcessor::objdumpSymbol_t& symbol = symbols.back();
+    std::ostringstream                 messages;
+
+    symbol.name  = symbolName;
+    symbol.found = false;
+
     // Find the symbol's coverage map.
     try {
       CoverageMapBase& coverageMap =
@@ -87,22 +101,14 @@ namespace Coverage {
       }
 
       if ( highAddress != computedHighAddress ) {
-        std::cerr << "Function's high address differs between DWARF and "
-                  << "objdump: " << symbolName << " (0x" << std::hex
-                  << highAddress << " and 0x"
-                  << computedHighAddress - 1 << ")" << std::dec << std::endl;
+        messages << "Function's high address differs between DWARF and "
+                 << "objdump: " << symbolName << " (0x" << std::hex
+                 << highAddress << " and 0x"
+                 << computedHighAddress - 1 << ")" << std::dec << std::endl;
 
         size = computedHighAddress - lowAddress;
       }
 
-      // If there are NOT already saved instructions, save them.
-      SymbolInformation* symbolInfo = symbolsToAnalyze.find( symbolName );
-      if ( symbolInfo->instructions.empty() ) {
-        symbolInfo->sourceFile   = executableInfo;
-        symbolInfo->baseAddress  = lowAddress;
-        symbolInfo->instructions = instructions;
-      }
-
       // Add the symbol to this executable's symbol table.
       SymbolTable* theSymbolTable = executableInfo->getSymbolTable();
       theSymbolTable->addSymbol(
@@ -114,22 +120,25 @@ namespace Coverage {
       // Mark the start of each instruction in the coverage map.
       for ( auto& instruction : instructions ) {
         coverageMap.setIsStartOfInstruction( instruction.address );
+        if ( instruction.isInstruction ) {
+          executableInfo->addInstruction( instruction.address );
+        }
       }
 
-      // Create a unified coverage map for the symbol.
-      symbolsToAnalyze.createCoverageMap(
-        executableInfo->getFileName().c_str(),
-        symbolName,
-        size,
-        sizeWithoutNops,
-        verbose
-      );
+      // Hold what the unified coverage map needs until it is committed.
+      symbol.found           = true;
+      symbol.lowAddress      = lowAddress;
+      symbol.size            = size;
+      symbol.sizeWithoutNops = sizeWithoutNops;
+      symbol.instructions    = std::move( instructions );
     } catch ( const ExecutableInfo::CoverageMapNotFoundError& e ) {
       // Allow execution to continue even if a coverage map could not be
       // found.
-      std::cerr << "Coverage map not found for symbol " << e.what()
-                << std::endl;
+      messages << "Coverage map not found for symbol " << e.what()
+               << std::endl;
     }
+
+    symbol.messages = messages.str();
   }
 
   ObjdumpProcessor::ObjdumpProcessor(
@@ -215,60 +224,80 @@ namespace Coverage {
     return targetInfo_m->isBranch( instruction );
   }
 
-  bool ObjdumpProcessor::isBranchLine( const std::string& line )
+  void ObjdumpProcessor::classifyInstruction( objdumpLine_t& lineInfo )
   {
     if ( !targetInfo_m ) {
       fprintf(
         stderr,
-        "ERROR: ObjdumpProcessor::isBranchLine - unknown architecture\n"
+        "ERROR: ObjdumpProcessor::classifyInstruction - unknown architecture\n"
       );
-      assert( 0 );
-      return false;
+      assert(0);
+      return;
     }
 
-    return  targetInfo_m->isBranchLine( line );
-  }
+    Target::TargetBase::instructionClass_t instruction;
 
-  bool ObjdumpProcessor::isNop(
-    const std::string& line,
-    int&               size
-  )
-  {
-    if ( !targetInfo_m ) {
-      fprintf(
-        stderr,
-        "ERROR: ObjdumpProcessor::isNop - unknown architecture\n"
-      );
-      assert(0);
-      return false;
-    }
+    targetInfo_m->classifyLine( lineInfo.line, instruction );
 
-    return targetInfo_m->isNopLine( line, size );
+    lineInfo.isNop    = instruction.isNop;
+    lineInfo.nopSize  = instruction.nopSize;
+    lineInfo.isBranch = instruction.isBranch;
   }
 
-  void ObjdumpProcessor::getFile(
+  bool ObjdumpProcessor::getFile(
     std::string             fileName,
-    rld::process::tempfile& objdumpFile,
-    rld::process::tempfile& err
+    rld::process::stream&   objdump,
+    rld::process::tempfile* dmp,
+    rld::process::tempfile& err,
+    uint32_t                lowAddress,
+    uint32_t                highAddress
   )
   {
-    rld::process::status        status;
     rld::process::arg_container args = {
       targetInfo_m->getObjdump(),
       "-Cda",
       "--section=.text",
-      "--source",
-      fileName
+      "--source"
     };
 
+    if ( highAddress != 0 ) {
+      std::ostringstream start;
+      std::ostringstream stop;
+      start << "--start-address=0x" << std::hex << lowAddress;
+      stop << "--stop-address=0x" << std::hex << highAddress;
+      args.push_back( start.str() );
+      args.push_back( stop.str() );
+    }
+
+    args.push_back( fileName );
+
     try
     {
-      status = rld::process::execute(
-        targetInfo_m->getObjdump(),
-        args,
-        objdumpFile.name(),
-        err.name()
-      );
+      objdump.open( args, err.name() );
+      if ( dmp != nullptr ) {
+        objdump.tee( *dmp );
+      }
+    } catch( rld::error& err )
+      {
+        std::cout << "Error while running " << targetInfo_m->getObjdump()
+                  << " on " << fileName << std::endl;
+        std::cout << err.what << " in " << err.where << std::endl;
+        return false;
+      }
+
+    return true;
+  }
+
+  bool ObjdumpProcessor::endFile(
+    std::string           fileName,
+    rld::process::stream& objdump
+  )
+  {
+    rld::process::status status;
+
+    try
+    {
+      status = objdump.wait();
       if (
         ( status.type != rld::process::status::normal ) ||
         ( status.code != 0 )
@@ -280,54 +309,49 @@ namespace Coverage {
         std::cout << "Error while running " << targetInfo_m->getObjdump()
                   << " on " << fileName << std::endl;
         std::cout << err.what << " in " << err.where << std::endl;
-        return;
+        return false;
       }
 
-    objdumpFile.open( true );
+    return true;
   }
 
-  uint32_t ObjdumpProcessor::getAddressAfter( uint32_t address )
+  uint32_t ObjdumpProcessor::getAddressAfter( uint32_t address ) const
   {
-    objdumpFile_t::iterator itr;
-
-    itr = find ( objdumpList.begin(), objdumpList.end(), address );
-    if ( itr == objdumpList.end() ) {
-      return 0;
-    }
-
-    itr++;
-    if ( itr == objdumpList.end() ) {
-      return 0;
-    }
-
-    return (*itr);
-
+    return addressTable.getAddressAfter( address );
   }
 
   void ObjdumpProcessor::loadAddressTable (
     ExecutableInfo* const   executableInformation,
-    rld::process::tempfile& objdumpFile,
+    rld::process::tempfile* dmp,
     rld::process::tempfile& err
   )
   {
-    int         items;
-    uint32_t    offset;
-    char        terminator;
-    std::string line;
-
-    // Obtain the objdump file.
+    int                  items;
+    uint32_t             offset;
+    char                 terminator;
+    std::string          line;
+    std::string          fileName;
+    rld::process::stream objdump;
+    bool                 running;
+
+    // Start the objdump.
     if ( !executableInformation->hasDynamicLibrary() ) {
-      getFile( executableInformation->getFileName(), objdumpFile, err );
+      fileName = executableInformation->getFileName();
     } else {
-      getFile( executableInformation->getLibraryName(), objdumpFile, err );
+      fileName = executableInformation->getLibraryName();
     }
 
-    // Process all lines from the objdump file.
+    running = getFile( fileName, objdump, dmp, err );
+
+    // Process all lines from the objdump as it runs.
     while ( true ) {
 
       // Get the line.
-      objdumpFile.read_line( line );
+      objdump.read_line( line );
       if ( line.empty() ) {
+        if ( running ) {
+          endFile( fileName, objdump );
+        }
         break;
       }
 
@@ -336,21 +360,264 @@ namespace Coverage {
 
       // If it looks like an instruction ...
       if ( ( items == 2 ) && ( terminator == ':' ) ) {
-        objdumpList.push_back(
+        addressTable.add(
           executableInformation->getLoadAddress() + offset
         );
       }
     }
+
+    addressTable.build();
+  }
+
+  /*
+   * The maximum number of objdumps run at the same time for an executable.
+   */
+  #define MAX_OBJDUMP_BATCHES 4
+
+  /*
+   * Split the desired ranges of an executable into batches. Each batch is
+   * disassembled by its own objdump. The largest gaps between the ranges
+   * separate the batches so the least code that is not desired is
+   * disassembled.
+   */
+  static ExecutableInfo::DesiredRanges batchRanges(
+    const ExecutableInfo::DesiredRanges& ranges
+  )
+  {
+    ExecutableInfo::DesiredRanges            batches;
+    std::vector<std::pair<uint32_t, size_t>> gaps;
+    std::vector<size_t>                      splits;
+
+    if ( ranges.size() <= MAX_OBJDUMP_BATCHES ) {
+      return ranges;
+    }
+
+    for ( size_t r = 1; r < ranges.size(); ++r ) {
+      gaps.push_back(
+        std::make_pair( ranges[ r ].low - ranges[ r - 1 ].high, r )
+      );
+    }
+
+    std::partial_sort(
+      gaps.begin(),
+      gaps.begin() + MAX_OBJDUMP_BATCHES - 1,
+      gaps.end(),
+      []( const std::pair<uint32_t, size_t>& a,
+          const std::pair<uint32_t, size_t>& b ) {
+        return
+          ( a.first > b.first ) ||
+          ( ( a.first == b.first ) && ( a.second < b.second ) );
+      }
+    );
+
+    for ( size_t g = 0; g < MAX_OBJDUMP_BATCHES - 1; ++g ) {
+      splits.push_back( gaps[ g ].second );
+    }
+
+    std::sort( splits.begin(), splits.end() );
+    splits.push_back( ranges.size() );
+
+    size_t first = 0;
+    for ( auto split : splits ) {
+      batches.push_back(
+        ExecutableInfo::DesiredRange{
+          ranges[ first ].low, ranges[ split - 1 ].high
+        }
+      );
+      first = split;
+    }
+
+    return batches;
   }
 
-  void ObjdumpProcessor::load(
+  /*
+   * Read the object dump of an executable one line at a time. If the
+   * executable's desired ranges are known each batch of ranges is dumped
+   * by an objdump and the objdumps run at the same time. The first batch
+   * is read as its objdump runs and the output of the other batches is
+   * held until it is needed. The lines are read in address order.
+   */
+  class ObjdumpReader {
+
+  public:
+
+    ObjdumpReader(
+      ObjdumpProcessor&       processor,
+      ExecutableInfo* const   executableInformation,
+      rld::process::tempfile* dmp,
+      rld::process::tempfile& err
+    ) : processor_m( processor ),
+        dmp_m( dmp ),
+        current( 0 ),
+        failed( false )
+    {
+      if ( !executableInformation->hasDynamicLibrary() ) {
+        fileName = executableInformation->getFileName();
+        batches = batchRanges( executableInformation->getDesiredRanges() );
+      } else {
+        fileName = executableInformation->getLibraryName();
+      }
+
+      if ( dmp_m != nullptr ) {
+        dmp_m->open( true );
+      }
+
+      // Start the background batches then the first batch.
+      outputs.resize( batches.size() );
+      for ( size_t b = 1; b < batches.size(); ++b ) {
+        outputs[ b ].thread = std::thread( [this, b]() { dumpBatch( b ); } );
+      }
+
+      if ( batches.empty() ) {
+        if ( !executableInformation->hasDynamicLibrary() ) {
+          // No desired symbols so there is nothing to dump.
+          running = false;
+        } else {
+          running = processor_m.getFile( fileName, objdump, nullptr, err );
+        }
+      } else {
+        running = processor_m.getFile(
+          fileName, objdump, nullptr, err, batches[ 0 ].low, batches[ 0 ].high
+        );
+      }
+    }
+
+    ~ObjdumpReader()
+    {
+      for ( auto& output : outputs ) {
+        if ( output.thread.joinable() ) {
+          output.thread.join();
+        }
+      }
+
+      if ( dmp_m != nullptr ) {
+        dmp_m->close();
+      }
+    }
+
+    /*
+     * Read a line. The line is empty at the end of the object dump.
+     */
+    void read_line( std::string& line )
+    {
+      line.clear();
+
+      while ( line.empty() ) {
+        if ( current == 0 ) {
+          objdump.read_line( line );
+          if ( line.empty() ) {
+            if ( running && !processor_m.endFile( fileName, objdump ) ) {
+              failed = true;
+            }
+            running = false;
+            current = 1;
+          }
+        } else if ( current < outputs.size() ) {
+          Output& output = outputs[ current ];
+
+          if ( output.thread.joinable() ) {
+            output.thread.join();
+            if ( output.error ) {
+              std::rethrow_exception( output.error );
+            }
+            if ( !output.ok ) {
+              failed = true;
+            }
+          }
+
+          if ( output.next < output.text.size() ) {
+            size_t end = output.text.find( '\n', output.next );
+            end = end == std::string::npos ? output.text.size() : end + 1;
+            line = output.text.substr( output.next, end - output.next );
+            output.next = end;
+          } else {
+            std::string().swap( output.text );
+            ++current;
+          }
+        } else {
+          break;
+        }
+      }
+
+      if ( dmp_m != nullptr && !line.empty() ) {
+        dmp_m->write( line );
+      }
+    }
+
+    /*
+     * Returns true if an objdump failed.
+     */
+    bool hasFailed() const
+    {
+      return failed;
+    }
+
+  private:
+
+    /*
+     * The output of a batch run in the background.
+     */
+    struct Output {
+      std::thread        thread;
+      std::string        text;
+      size_t             next = 0;
+      bool               ok = false;
+      std::exception_ptr error;
+    };
+
+    /*
+     * Dump a batch in the background holding the output.
+     */
+    void dumpBatch( size_t b )
+    {
+      Output& output = outputs[ b ];
+
+      try {
+        rld::process::tempfile err( ".err" );
+        rld::process::stream   batch;
+        std::string            line;
+
+        bool running = processor_m.getFile(
+          fileName, batch, nullptr, err, batches[ b ].low, batches[ b ].high
+        );
+
+        if ( running ) {
+          while ( true ) {
+            batch.read_line( line );
+            if ( line.empty() ) {
+              break;
+            }
+            output.text += line;
+          }
+
+          output.ok = processor_m.endFile( fileName, batch );
+        }
+      } catch ( ... ) {
+        output.error = std::current_exception();
+      }
+    }
+
+    ObjdumpProcessor&             processor_m;
+    rld::process::tempfile*       dmp_m;
+    std::string                   fileName;
+    ExecutableInfo::DesiredRanges batches;
+    std::vector<Output>           outputs;
+    rld::process::stream          objdump;
+    bool                          running;
+    size_t                        current;
+    bool                          failed;
+  };
+
+  bool ObjdumpProcessor::scan(
     ExecutableInfo* const   executableInformation,
-    rld::process::tempfile& objdumpFile,
+    rld::process::tempfile* dmp,
     rld::process::tempfile& err,
-    bool                    verbose
+    objdumpListings_t&      listings,
+    bool&                   endsInListing
   )
   {
     std::string    currentSymbol = "";
+    uint32_t       currentAddress = 0;
     uint32_t       instructionOffset;
     int            items;
     int            found;
@@ -368,38 +635,24 @@ namespace Coverage {
     std::string    jumpTableID = "";
     std::string    line = "";
 
-    // Obtain the objdump file.
-    if ( !executableInformation->hasDynamicLibrary() ) {
-      getFile( executableInformation->getFileName(), objdumpFile, err );
-    } else {
-      getFile( executableInformation->getLibraryName(), objdumpFile, err );
-    }
+    // Start the objdump.
+    ObjdumpReader objdump( *this, executableInformation, dmp, err );
 
     while ( true ) {
       // Get the line.
-      objdumpFile.read_line( line );
+      objdump.read_line( line );
       if ( line.empty() ) {
-        // If we are currently processing a symbol, finalize it.
+        // If we are currently processing a symbol, it ends the listings.
+        endsInListing = processSymbol;
         if ( processSymbol ) {
-          finalizeSymbol(
-            executableInformation,
-            currentSymbol,
-            theInstructions,
-            verbose,
-            symbolsToAnalyze_m
+          listings.push_back(
+            objdumpListing_t{
+              currentSymbol, currentAddress, std::move( theInstructions )
+            }
           );
-
-          std::cerr << "WARNING: ObjdumpProcessor::load - analysis of symbol "
-                    << currentSymbol << std::endl
-                    << "         may be incorrect.  It was the last symbol in "
-                    << executableInformation->getFileName() << std::endl
-                    << "         and the length of its last instruction"
-                    << " is assumed          to be one."
-                    << std::endl;
         }
 
-        objdumpFile.close();
-        break;
+        return !objdump.hasFailed();
       }
 
       // Remove any extra line break
@@ -444,12 +697,10 @@ namespace Coverage {
       if ( ( items == 3 ) && ( terminator1 == ':' ) ) {
         // If we are currently processing a symbol, finalize it.
         if ( processSymbol ) {
-          finalizeSymbol(
-            executableInformation,
-            currentSymbol,
-            theInstructions,
-            verbose,
-            symbolsToAnalyze_m
+          listings.push_back(
+            objdumpListing_t{
+              currentSymbol, currentAddress, std::move( theInstructions )
+            }
           );
         }
 
@@ -476,6 +727,7 @@ namespace Coverage {
         // See if the new symbol is one that we care about.
         if ( symbolsToAnalyze_m.isDesired( symbol ) ) {
           currentSymbol = symbol;
+          currentAddress = executableInformation->getLoadAddress() + offset;
           processSymbol = true;
           theInstructions.push_back( lineInfo );
         }
@@ -491,12 +743,10 @@ namespace Coverage {
       ) {
         // If we are currently processing a symbol, finalize it.
         if ( processSymbol ) {
-          finalizeSymbol(
-            executableInformation,
-            currentSymbol,
-            theInstructions,
-            verbose,
-            symbolsToAnalyze_m
+          listings.push_back(
+            objdumpListing_t{
+              currentSymbol, currentAddress, std::move( theInstructions )
+            }
           );
         }
 
@@ -523,8 +773,7 @@ namespace Coverage {
           lineInfo.address =
            executableInformation->getLoadAddress() + instructionOffset;
           lineInfo.isInstruction = true;
-          lineInfo.isNop         = isNop( line.c_str(), lineInfo.nopSize );
-          lineInfo.isBranch      = isBranchLine( line.c_str() );
+          classifyInstruction( lineInfo );
         }
 
         // Always save the line.
@@ -533,6 +782,271 @@ namespace Coverage {
     }
   }
 
+  /*
+   * Add a placeholder for a body that uses the listing of another
+   * executable. The body is parsed when the executable is committed.
+   */
+  static void addSharedBody(
+    const ExecutableInfo::DesiredBody&  body,
+    ObjdumpProcessor::objdumpSymbols_t& symbols
+  )
+  {
+    if ( body.owner == nullptr ) {
+      return;
+    }
+
+    symbols.push_back( ObjdumpProcessor::objdumpSymbol_t() );
+    symbols.back().found      = false;
+    symbols.back().lowAddress = body.low;
+    symbols.back().owner      = body.owner;
+    symbols.back().ownerLow   = body.ownerLow;
+  }
+
+  void ObjdumpProcessor::parse(
+    ExecutableInfo* const   executableInformation,
+    rld::process::tempfile* dmp,
+    rld::process::tempfile& err,
+    objdumpSymbols_t&       symbols
+  )
+  {
+    objdumpListings_t listings;
+    bool              endsInListing = false;
+    bool              ok = false;
+    bool              cached = false;
+    AnalysisCache*    cache = executableInformation->getAnalysisCache();
+    uint64_t          key = 0;
+
+    // The object dump of a dynamic library is not cached.
+    if ( executableInformation->hasDynamicLibrary() ) {
+      cache = nullptr;
+    }
+
+    if ( cache != nullptr ) {
+      key = cache->getKey(
+        executableInformation->getAnalysisKey(),
+        executableInformation->getDesiredRanges()
+      );
+      cached = ok = cache->load( key, listings, endsInListing );
+    }
+
+    if ( !cached ) {
+      ok = scan( executableInformation, dmp, err, listings, endsInListing );
+      if ( ok && cache != nullptr ) {
+        cache->save( key, listings, endsInListing );
+      }
+    }
+
+    // Parse the listings adding a placeholder for each body that uses the
+    // listing of another executable. A body that was not dumped can still
+    // have a listing as a dump ends just after the next symbol starts.
+    ExecutableInfo::DesiredBodies&          bodies =
+      executableInformation->getDesiredBodies();
+    ExecutableInfo::DesiredBodies::iterator body = bodies.begin();
+
+    for ( auto& listing : listings ) {
+      for ( ; body != bodies.end() && body->low < listing.address; ++body ) {
+        addSharedBody( *body, symbols );
+      }
+
+      if ( body != bodies.end() && body->low == listing.address ) {
+        ExecutableInfo::DesiredBody& listed = *body++;
+
+        if ( listed.owner != nullptr ) {
+          addSharedBody( listed, symbols );
+          continue;
+        }
+
+        if ( listed.shared && ok ) {
+          std::lock_guard<std::mutex> lock( sharedLock );
+
+          sharedListing_t& shared = sharedListings[
+            std::make_pair( executableInformation, listed.low )
+          ];
+          shared.listing = listing;
+          shared.present = true;
+        }
+      }
+
+      finalizeSymbol(
+        executableInformation,
+        listing.name,
+        listing.instructions,
+        symbols
+      );
+    }
+
+    for ( ; body != bodies.end(); ++body ) {
+      addSharedBody( *body, symbols );
+    }
+
+    if ( endsInListing ) {
+      std::ostringstream warning;
+      warning << "WARNING: ObjdumpProcessor::load - analysis of symbol "
+              << listings.back().name << std::endl
+              << "         may be incorrect.  It was the last symbol in "
+              << executableInformation->getFileName() << std::endl
+              << "         and the length of its last instruction"
+              << " is assumed          to be one."
+              << std::endl;
+
+      symbols.push_back( objdumpSymbol_t() );
+      symbols.back().found    = false;
+      symbols.back().messages = warning.str();
+    }
+
+    // Nothing from a failed objdump is added to the desired symbols.
+    if ( !ok ) {
+      symbols.clear();
+    }
+
+    executableInformation->buildCoverageMapIndex();
+  }
+
+  void ObjdumpProcessor::commit(
+    ExecutableInfo* const executableInformation,
+    objdumpSymbols_t&     symbols,
+    bool                  verbose
+  )
+  {
+    bool parsedShared = false;
+
+    // Parse the symbols that use the listing of another executable. The
+    // owner has been committed so its listing is present unless its
+    // objdump failed.
+    for ( auto symbol = symbols.begin(); symbol != symbols.end(); ) {
+      if ( symbol->owner == nullptr ) {
+        ++symbol;
+        continue;
+      }
+
+      objdumpListing_t listing;
+      bool             present = false;
+
+      {
+        std::lock_guard<std::mutex> lock( sharedLock );
+
+        sharedListings_t::iterator shared = sharedListings.find(
+          std::make_pair( symbol->owner, symbol->ownerLow )
+        );
+        if ( shared != sharedListings.end() ) {
+          present = shared->second.present;
+          if ( present ) {
+            listing = shared->second.listing;
+          }
+          if ( --shared->second.users == 0 ) {
+            sharedListings.erase( shared );
+          }
+        }
+      }
+
+      if ( present ) {
+        objdumpSymbols_t parsed;
+
+        finalizeSymbol(
+          executableInformation,
+          listing.name,
+          listing.instructions,
+          parsed
+        );
+        symbols.splice( symbol, parsed );
+        parsedShared = true;
+      }
+
+      symbol = symbols.erase( symbol );
+    }
+
+    if ( parsedShared ) {
+      executableInformation->buildCoverageMapIndex();
+    }
+
+    for ( auto& symbol : symbols ) {
+      std::cerr << symbol.messages;
+
+      if ( !symbol.found ) {
+        continue;
+      }
+
+      // If there are NOT already saved instructions, save them.
+      SymbolInformation* symbolInfo = symbolsToAnalyze_m.find( symbol.name );
+      if ( symbolInfo->instructions.empty() ) {
+        symbolInfo->sourceFile   = executableInformation;
+        symbolInfo->baseAddress  = symbol.lowAddress;
+        symbolInfo->instructions = std::move( symbol.instructions );
+      }
+
+      // Create a unified coverage map for the symbol.
+      symbolsToAnalyze_m.createCoverageMap(
+        executableInformation->getFileName().c_str(),
+        symbol.name,
+        symbol.size,
+        symbol.sizeWithoutNops,
+        verbose
+      );
+    }
+
+    symbols.clear();
+  }
+
+  void ObjdumpProcessor::shareBodies(
+    const std::vector<ExecutableInfo*>& executables
+  )
+  {
+    typedef std::tuple<uint64_t, uint32_t, uint32_t> bodyKey_t;
+    typedef std::pair<ExecutableInfo*, ExecutableInfo::DesiredBody*> owner_t;
+
+    std::map<bodyKey_t, owner_t> owners;
+
+    for ( auto exe : executables ) {
+      bool sharing = false;
+
+      if ( exe->hasDynamicLibrary() ) {
+        continue;
+      }
+
+      for ( auto& body : exe->getDesiredBodies() ) {
+        if ( !body.shareable ) {
+          continue;
+        }
+
+        // The listing text holds the addresses of the instructions and
+        // their targets so only a body at the same address is identical.
+        bodyKey_t key( body.hash, body.high - body.low, body.low );
+        auto      owner = owners.find( key );
+
+        if ( owner == owners.end() ) {
+          owners[ key ] = owner_t( exe, &body );
+          continue;
+        }
+
+        ExecutableInfo::DesiredBody& ownerBody = *owner->second.second;
+
+        body.owner       = owner->second.first;
+        body.ownerLow    = ownerBody.low;
+        ownerBody.shared = true;
+        sharedListings[ std::make_pair( body.owner, body.ownerLow ) ].users++;
+        sharing = true;
+      }
+
+      // The bodies using another executable's listing are not dumped.
+      if ( sharing ) {
+        exe->updateDesiredRanges();
+      }
+    }
+  }
+
+  void ObjdumpProcessor::load(
+    ExecutableInfo* const   executableInformation,
+    rld::process::tempfile* dmp,
+    rld::process::tempfile& err,
+    bool                    verbose
+  )
+  {
+    objdumpSymbols_t symbols;
+
+    parse( executableInformation, dmp, err, symbols );
+    commit( executableInformation, symbols, verbose );
+  }
+
   void ObjdumpProcessor::setTargetInfo(
     std::shared_ptr<Target::TargetBase>& targetInfo
   )
@@ -8,9 +8,14 @@
 #define __OBJDUMP_PROCESSOR_H__
 
 #include <list>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ExecutableInfo.h"
+#include "InstructionIndex.h"
 #include "TargetBase.h"
 #include "DesiredSymbols.h"
 
@@ -80,12 +85,99 @@ namespace Coverage {
      */
     typedef std::list<objdumpLine_t> objdumpLines_t;
 
+    /*!
+     *  This structure holds the object dump lines of a desired symbol as
+     *  they are read from the object dump of an executable.
+     */
+    struct objdumpListing_t {
+      /*!
+       *  This member variable contains the name of the symbol.
+       */
+      std::string name;
+
+      /*!
+       *  This member variable contains the address of the symbol.
+       */
+      uint32_t address;
+
+      /*!
+       *  This member variable contains the symbol's object dump lines.
+       */
+      objdumpLines_t instructions;
+    };
+
+    /*!
+     *  This object defines a list of the listings of the desired symbols
+     *  in the order they appear in the object dump.
+     */
+    typedef std::list<objdumpListing_t> objdumpListings_t;
+
+    /*!
+     *  This structure holds the result of parsing the object dump of a
+     *  desired symbol in an executable. It contains the information that
+     *  is added to the desired symbols when the executable is committed.
+     */
+    struct objdumpSymbol_t {
+      /*!
+       *  This member variable contains the name of the symbol.
+       */
+      std::string name;
+
+      /*!
+       *  This member variable is true if a coverage map was found for the
+       *  symbol in the executable.
+       */
+      bool found;
+
+      /*!
+       *  This member variable contains the low address of the symbol.
+       */
+      uint32_t lowAddress;
+
+      /*!
+       *  This member variable contains the size of the symbol including
+       *  any trailing nops.
+       */
+      uint32_t size;
+
+      /*!
+       *  This member variable contains the size of the symbol without any
+       *  trailing nops.
+       */
+      uint32_t sizeWithoutNops;
+
+      /*!
+       *  This member variable contains the symbol's object dump lines.
+       */
+      objdumpLines_t instructions;
+
+      /*!
+       *  This member variable contains the messages generated while
+       *  parsing the symbol. They are output when the symbol is committed
+       *  so the output does not depend on the order executables are parsed.
+       */
+      std::string messages;
+
+      /*!
+       *  This member variable points to the executable holding an
+       *  identical body if the symbol uses its listing. The symbol is
+       *  parsed from the listing when the executable is committed. It is
+       *  null if the symbol has been parsed.
+       */
+      const ExecutableInfo* owner;
+
+      /*!
+       *  This member variable contains the address of the identical body
+       *  in the owner.
+       */
+      uint32_t ownerLow;
+    };
 
     /*!
-     *  This object defines a list of instruction addresses
-     *  that will be extracted from the objdump file.
+     *  This object defines a list of the parsed desired symbols of an
+     *  executable in the order they appear in the object dump.
      */
-    typedef std::list<uint32_t> objdumpFile_t;
+    typedef std::list<objdumpSymbol_t> objdumpSymbols_t;
 
     /*!
      *  This method constructs an ObjdumpProcessor instance.
@@ -103,40 +195,108 @@ namespace Coverage {
     uint32_t determineLoadAddress( ExecutableInfo* theExecutable );
 
     /*!
-     *  This method fills a tempfile with the .text section of objdump
-     *  for the given file name.
+     *  This method starts an objdump of the .text section of the given
+     *  file. The output is read from the stream while objdump runs. If
+     *  dmp is not null the output is also copied to it. If the high
+     *  address is not 0 only the addresses from the low address up to the
+     *  high address are disassembled.
+     *
+     *  @return Returns TRUE if objdump was started, FALSE otherwise.
      */
-    void getFile(
+    bool getFile(
       std::string             fileName,
-      rld::process::tempfile& dmp,
-      rld::process::tempfile& err
+      rld::process::stream&   objdump,
+      rld::process::tempfile* dmp,
+      rld::process::tempfile& err,
+      uint32_t                lowAddress = 0,
+      uint32_t                highAddress = 0
+    );
+
+    /*!
+     *  This method waits for the objdump of the given file to finish.
+     *
+     *  @return Returns TRUE if objdump finished without an error, FALSE
+     *          otherwise.
+     */
+    bool endFile(
+      std::string           fileName,
+      rld::process::stream& objdump
     );
 
     /*!
-     *  This method fills the objdumpList list with all the
+     *  This method fills the address table with all the
      *  instruction addresses in the object dump file.
      */
     void loadAddressTable (
       ExecutableInfo* const   executableInformation,
-      rld::process::tempfile& dmp,
+      rld::process::tempfile* dmp,
       rld::process::tempfile& err
     );
 
+    /*!
+     *  This method generates and parses an object dump for the specified
+     *  executable. Only the executable's information is updated and the
+     *  desired symbols are not changed so more than one executable can be
+     *  parsed at the same time.
+     *
+     *  @param[in] executableInformation is the executable to parse
+     *  @param[in] dmp is a temporary file to copy the object dump to or null
+     *  @param[in] err is the temporary file to hold objdump's errors
+     *  @param[out] symbols is the list of parsed desired symbols
+     */
+    void parse(
+      ExecutableInfo* const   executableInformation,
+      rld::process::tempfile* dmp,
+      rld::process::tempfile& err,
+      objdumpSymbols_t&       symbols
+    );
+
+    /*!
+     *  This method finds the desired bodies that are identical and at the
+     *  same address in the executables. Only the first of the identical bodies in the order of
+     *  the executables is dumped and the others use its listing. It must be
+     *  called before the executables are parsed.
+     *
+     *  @param[in] executables are the executables in the order they are
+     *             committed
+     */
+    void shareBodies( const std::vector<ExecutableInfo*>& executables );
+
+    /*!
+     *  This method adds the parsed desired symbols of an executable to
+     *  the desired symbols. Executables must be committed one at a time
+     *  and in the same order for the results to be repeatable.
+     *
+     *  @param[in] executableInformation is the executable that was parsed
+     *  @param[in] symbols is the list of parsed desired symbols
+     *  @param[in] verbose is true to output verbose information
+     */
+    void commit(
+      ExecutableInfo* const executableInformation,
+      objdumpSymbols_t&     symbols,
+      bool                  verbose
+    );
+
     /*!
      *  This method generates and processes an object dump for
      *  the specified executable.
      */
     void load(
       ExecutableInfo* const   executableInformation,
-      rld::process::tempfile& dmp,
+      rld::process::tempfile* dmp,
       rld::process::tempfile& err,
       bool                    verbose
     );
 
     /*!
-     *  This method returns the next address in the objdumpList.
+     *  This method returns the address of the instruction after the
+     *  instruction at the address in the address table.
+     *
+     *  @param[in] address specifies the start of an instruction
+     *
+     *  @return Returns the next instruction's address or 0 if there is none
      */
-    uint32_t getAddressAfter( uint32_t address );
+    uint32_t getAddressAfter( uint32_t address ) const;
 
     /*!
      *  This method returns true if the instruction is
@@ -145,13 +305,6 @@ namespace Coverage {
      */
     bool IsBranch( const std::string& instruction );
 
-    /*!
-     *  This method returns true if the instruction from
-     *  the given line in the objdmp file is a branch instruction,
-     *  otherwise it returns false.
-     */
-    bool isBranchLine( const std::string& line );
-
     /*!
      * This method sets the targetInfo_m variable.
      *
@@ -162,24 +315,80 @@ namespace Coverage {
   private:
 
     /*!
-     *  This variable consists of a list of all instruction addresses
-     *  extracted from the obj dump file.
+     *  This method generates an object dump for the specified executable
+     *  and reads the listings of the desired symbols from it.
+     *
+     *  @param[in] executableInformation is the executable to dump
+     *  @param[in] dmp is a temporary file to copy the object dump to or null
+     *  @param[in] err is the temporary file to hold objdump's errors
+     *  @param[out] listings are the listings of the desired symbols
+     *  @param[out] endsInListing is true if the object dump ended in the
+     *              last listing
+     *
+     *  @return Returns TRUE if the object dump was read, FALSE otherwise.
      */
-    objdumpFile_t objdumpList;
+    bool scan(
+      ExecutableInfo* const   executableInformation,
+      rld::process::tempfile* dmp,
+      rld::process::tempfile& err,
+      objdumpListings_t&      listings,
+      bool&                   endsInListing
+    );
 
     /*!
-     *  This method determines whether the specified line is a
-     *  nop instruction.
-     *
-     *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
+     *  This variable holds the addresses of all instructions extracted
+     *  from the object dump file.
+     */
+    InstructionIndex addressTable;
+
+    /*!
+     *  This method sets the nop and branch information of an instruction
+     *  line using the target's instruction table.
      *
-     *  @return Returns TRUE if the instruction is a nop, FALSE otherwise.
+     *  @param[in,out] lineInfo is the instruction line to classify
      */
-    bool isNop(
-      const std::string& line,
-      int&               size
-    );
+    void classifyInstruction( objdumpLine_t& lineInfo );
+
+    /*!
+     *  This structure holds the listing of a body used by other
+     *  executables.
+     */
+    struct sharedListing_t {
+      /*!
+       *  This member variable contains the listing. It is present once the
+       *  owner has been parsed without an error.
+       */
+      objdumpListing_t listing;
+
+      /*!
+       *  This member variable is true if the listing is present.
+       */
+      bool present;
+
+      /*!
+       *  This member variable contains the number of bodies that are yet
+       *  to use the listing.
+       */
+      size_t users;
+    };
+
+    /*!
+     *  This object defines the shared listings indexed by the owner and
+     *  the address of the body in the owner.
+     */
+    typedef std::map<
+      std::pair<const ExecutableInfo*, uint32_t>, sharedListing_t
+    > sharedListings_t;
+
+    /*!
+     *  This member variable contains the listings of the shared bodies.
+     */
+    sharedListings_t sharedListings;
+
+    /*!
+     *  This member variable serializes access to the shared listings.
+     */
+    std::mutex sharedLock;
 
     /*!
      * This member variable contains the symbols to be analyzed
@@ -5,9 +5,13 @@
 #include <sys/types.h>
 #include <assert.h>
 
+#include <functional>
 #include <iomanip>
+#include <memory>
 #include <sstream>
 
+#include <rld-threads.h>
+
 #include "ReportsBase.h"
 #include "CoverageRanges.h"
 #include "DesiredSymbols.h"
@@ -23,6 +27,16 @@
 
 namespace Coverage {
 
+ReportFile::ReportFile() : buffer_m( 1024 * 1024 )
+{
+  rdbuf()->pubsetbuf( buffer_m.data(), buffer_m.size() );
+}
+
+ReportFile::~ReportFile()
+{
+  close();
+}
+
 ReportsBase::ReportsBase(
   time_t                  timestamp,
   const std::string&      symbolSetName,
@@ -40,6 +54,30 @@ ReportsBase::ReportsBase(
    symbolsToAnalyze_m( symbolsToAnalyze ),
    branchInfoAvailable_m( branchInfoAvailable )
 {
+  // Format the time once here. The reports are written by jobs that run at
+  // the same time and localtime() and asctime() return static buffers.
+  struct tm local;
+  char      date[ 32 ];
+  char      text[ 64 ];
+
+#ifdef _WIN32
+  localtime_s( &local, &timestamp_m );
+#else
+  localtime_r( &timestamp_m, &local );
+#endif
+  strftime( date, sizeof( date ), "%a %b", &local );
+  snprintf(
+    text,
+    sizeof( text ),
+    "%s%3d %.2d:%.2d:%.2d %d\n",
+    date,
+    local.tm_mday,
+    local.tm_hour,
+    local.tm_min,
+    local.tm_sec,
+    local.tm_year + 1900
+  );
+  dateTime_m = text;
 }
 
 ReportsBase::~ReportsBase()
@@ -199,7 +237,7 @@ std::string expand_tabs( const std::string& in ) {
  */
 void ReportsBase::WriteAnnotatedReport( const std::string& fileName )
 {
-  std::ofstream              aFile;
+  ReportFile                 aFile;
   Coverage::CoverageRanges*  theBranches;
   Coverage::CoverageRanges*  theRanges;
   Coverage::CoverageMapBase* theCoverageMap = NULL;
@@ -310,7 +348,7 @@ void ReportsBase::WriteAnnotatedReport( const std::string& fileName )
  */
 void ReportsBase::WriteBranchReport( const std::string& fileName )
 {
-  std::ofstream             report;
+  ReportFile                report;
   Coverage::CoverageRanges* theBranches;
   unsigned int              count;
   bool                      hasBranches = true;
@@ -361,10 +399,10 @@ void ReportsBase::WriteBranchReport( const std::string& fileName )
  */
 void ReportsBase::WriteCoverageReport( const std::string& fileName )
 {
-  std::ofstream             report;
+  ReportFile                report;
   Coverage::CoverageRanges* theRanges;
   unsigned int              count;
-  std::ofstream             NoRangeFile;
+  ReportFile                NoRangeFile;
   std::string               NoRangeName;
 
   // Open special file that captures NoRange informaiton
@@ -416,7 +454,7 @@ void ReportsBase::WriteCoverageReport( const std::string& fileName )
  */
 void ReportsBase::WriteSizeReport( const std::string& fileName )
 {
-  std::ofstream             report;
+  ReportFile                report;
   Coverage::CoverageRanges* theRanges;
   unsigned int              count;
 
@@ -453,7 +491,7 @@ void ReportsBase::WriteSymbolSummaryReport(
   const DesiredSymbols& symbolsToAnalyze
 )
 {
-  std::ofstream report;
+  ReportFile    report;
   unsigned int  count;
 
   // Open the report file.
@@ -494,7 +532,7 @@ void  ReportsBase::WriteSummaryReport(
   double                     percentageBranches;
   Coverage::CoverageMapBase* theCoverageMap;
   uint32_t                   totalBytes = 0;
-  std::ofstream              report;
+  ReportFile                 report;
 
   // Open the report file.
   OpenFile( fileName, symbolSetName, report, outputDirectory );
@@ -539,42 +577,42 @@ void  ReportsBase::WriteSummaryReport(
     (double) symbolsToAnalyze.getNumberBranchesFound( symbolSetName ) * 2;
   percentageBranches *= 100.0;
 
-  report << "Bytes Analyzed                   : " << totalBytes << std::endl
-         << "Bytes Not Executed               : " << notExecuted << std::endl
+  report << "Bytes Analyzed                   : " << totalBytes << '\n'
+         << "Bytes Not Executed               : " << notExecuted << '\n'
          << "Percentage Executed              : "
          << std::fixed << std::setprecision( 2 ) << std::setw( 5 )
-         << 100.0 - percentage << std::endl
-         << "Percentage Not Executed          : " << percentage << std::endl
+         << 100.0 - percentage << '\n'
+         << "Percentage Not Executed          : " << percentage << '\n'
          << "Unreferenced Symbols             : "
          << symbolsToAnalyze.getNumberUnreferencedSymbols( symbolSetName )
-         << std::endl << "Uncovered ranges found           : "
+         << '\n' << "Uncovered ranges found           : "
          << symbolsToAnalyze.getNumberUncoveredRanges( symbolSetName )
-         << std::endl << std::endl;
+         << '\n' << '\n';
 
   if (
     ( symbolsToAnalyze.getNumberBranchesFound( symbolSetName ) == 0 ) ||
     ( branchInfoAvailable == false )
   ) {
-    report << "No branch information available" << std::endl;
+    report << "No branch information available" << '\n';
   } else {
     report << "Total conditional branches found : "
            << symbolsToAnalyze.getNumberBranchesFound( symbolSetName )
-           << std::endl << "Total branch paths found         : "
+           << '\n' << "Total branch paths found         : "
            << symbolsToAnalyze.getNumberBranchesFound( symbolSetName ) * 2
-           << std::endl << "Uncovered branch paths found     : "
+           << '\n' << "Uncovered branch paths found     : "
            << symbolsToAnalyze.getNumberBranchesAlwaysTaken( symbolSetName ) +
               symbolsToAnalyze.getNumberBranchesNeverTaken( symbolSetName ) +
             ( symbolsToAnalyze.getNumberBranchesNotExecuted( symbolSetName ) * 2 )
-           << std::endl << "   "
+           << '\n' << "   "
            << symbolsToAnalyze.getNumberBranchesAlwaysTaken( symbolSetName )
-           << " branches always taken" << std::endl << "   "
+           << " branches always taken" << '\n' << "   "
            << symbolsToAnalyze.getNumberBranchesNeverTaken( symbolSetName )
-           << " branches never taken" << std::endl << "   "
+           << " branches never taken" << '\n' << "   "
            << symbolsToAnalyze.getNumberBranchesNotExecuted( symbolSetName ) * 2
-           << " branch paths not executed" << std::endl
+           << " branch paths not executed" << '\n'
            << "Percentage branch paths covered  : "
            << std::fixed << std::setprecision( 2 ) << std::setw( 4 )
-           << 100.0 - percentageBranches << std::endl;
+           << 100.0 - percentageBranches << '\n';
 
   }
 
@@ -582,92 +620,145 @@ void  ReportsBase::WriteSummaryReport(
 }
 
 void GenerateReports(
-  const std::string&              symbolSetName,
   Coverage::Explanations&         allExplanations,
   bool                            verbose,
   const std::string&              projectName,
   const std::string&              outputDirectory,
   const Coverage::DesiredSymbols& symbolsToAnalyze,
-  bool                            branchInfoAvailable
+  bool                            branchInfoAvailable,
+  unsigned int                    jobs
 )
 {
   using reportList_ptr = std::unique_ptr<ReportsBase>;
-  using reportList = std::vector<reportList_ptr>;
+  using reportMaker = std::function<reportList_ptr( const std::string& )>;
+  using reportWriter = std::function<void( ReportsBase&, const std::string& )>;
 
-  reportList             reports;
-  std::string            reportName;
-  time_t                 timestamp;
+  struct reportKind {
+    std::string  name;
+    reportWriter write;
+  };
 
+  // A task without a report writes the summary of the symbol set.
+  struct reportTask {
+    std::string        symbolSetName;
+    const reportMaker* maker;
+    const reportKind*  kind;
+  };
 
-  timestamp = time( NULL ); /* get current cal time */
-  reports.emplace_back(
-    new ReportsText(
-      timestamp,
-      symbolSetName,
-      allExplanations,
-      projectName,
-      outputDirectory,
-      symbolsToAnalyze,
-      branchInfoAvailable
-    )
-  );
-  reports.emplace_back(
-    new ReportsHtml(
-      timestamp,
-      symbolSetName,
-      allExplanations,
-      projectName,
-      outputDirectory,
-      symbolsToAnalyze,
-      branchInfoAvailable
-    )
-  );
+  time_t                   timestamp;
+  std::vector<reportTask>  tasks;
+  std::vector<std::string> reportNames;
 
-  for ( auto& report: reports ) {
+  timestamp = time( NULL ); /* get current cal time */
 
-    reportName = "index" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
+  const std::vector<reportMaker> makers = {
+    [&]( const std::string& symbolSetName ) {
+      return reportList_ptr(
+        new ReportsText(
+          timestamp,
+          symbolSetName,
+          allExplanations,
+          projectName,
+          outputDirectory,
+          symbolsToAnalyze,
+          branchInfoAvailable
+        )
+      );
+    },
+    [&]( const std::string& symbolSetName ) {
+      return reportList_ptr(
+        new ReportsHtml(
+          timestamp,
+          symbolSetName,
+          allExplanations,
+          projectName,
+          outputDirectory,
+          symbolsToAnalyze,
+          branchInfoAvailable
+        )
+      );
     }
-    report->WriteIndex( reportName );
+  };
 
-    reportName = "annotated" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
+  const std::vector<reportKind> kinds = {
+    {
+      "index",
+      []( ReportsBase& report, const std::string& reportName ) {
+        report.WriteIndex( reportName );
+      }
+    },
+    {
+      "annotated",
+      []( ReportsBase& report, const std::string& reportName ) {
+        report.WriteAnnotatedReport( reportName );
+      }
+    },
+    {
+      "branch",
+      []( ReportsBase& report, const std::string& reportName ) {
+        report.WriteBranchReport( reportName );
+      }
+    },
+    {
+      "uncovered",
+      []( ReportsBase& report, const std::string& reportName ) {
+        report.WriteCoverageReport( reportName );
+      }
+    },
+    {
+      "sizes",
+      []( ReportsBase& report, const std::string& reportName ) {
+        report.WriteSizeReport( reportName );
+      }
+    },
+    {
+      "symbolSummary",
+      [&]( ReportsBase& report, const std::string& reportName ) {
+        report.WriteSymbolSummaryReport( reportName, symbolsToAnalyze );
+      }
     }
-    report->WriteAnnotatedReport( reportName );
+  };
 
-    reportName = "branch" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
+  for ( const auto& setName : symbolsToAnalyze.getSetNames() ) {
+    for ( const auto& maker : makers ) {
+      for ( const auto& kind : kinds ) {
+        tasks.push_back( reportTask{ setName, &maker, &kind } );
+      }
     }
-    report->WriteBranchReport( reportName );
+    tasks.push_back( reportTask{ setName, nullptr, nullptr } );
+  }
 
-    reportName = "uncovered" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
-    }
-    report->WriteCoverageReport( reportName );
+  reportNames.resize( tasks.size() );
+
+  // Each task has its own report so the tasks only share the symbols and
+  // the explanations. The reports are named in the task order.
+  rld::threads::parallel_for(
+    tasks.size(),
+    jobs,
+    [&]( size_t t ) {
+      const reportTask& task = tasks[ t ];
+
+      if ( task.maker == nullptr ) {
+        ReportsBase::WriteSummaryReport(
+          "summary.txt",
+          task.symbolSetName,
+          outputDirectory,
+          symbolsToAnalyze,
+          branchInfoAvailable
+        );
+        return;
+      }
 
-    reportName = "sizes" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
-    }
-    report->WriteSizeReport( reportName );
+      reportList_ptr report = ( *task.maker )( task.symbolSetName );
 
-    reportName = "symbolSummary" + report->ReportExtension();
-    if ( verbose ) {
-      std::cerr << "Generate " << reportName << std::endl;
+      reportNames[ t ] = task.kind->name + report->ReportExtension();
+      task.kind->write( *report, reportNames[ t ] );
+    },
+    [&]( size_t t ) {
+      if ( verbose && !reportNames[ t ].empty() ) {
+        std::cerr << "Generate " << reportNames[ t ] << std::endl;
+      }
     }
-    report->WriteSymbolSummaryReport( reportName, symbolsToAnalyze );
-  }
-
-  ReportsBase::WriteSummaryReport(
-    "summary.txt",
-    symbolSetName,
-    outputDirectory,
-    symbolsToAnalyze,
-    branchInfoAvailable
   );
 }
 
@@ -13,12 +13,35 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include <time.h>
 #include "DesiredSymbols.h"
 #include "Explanations.h"
 
 namespace Coverage {
 
+/*!
+ *   This class is a report file. The report is written through a large
+ *   buffer so the file is written in large blocks.
+ */
+class ReportFile : public std::ofstream {
+
+  public:
+    ReportFile();
+
+    /*!
+     *  The file is closed before the buffer is released.
+     */
+    ~ReportFile();
+
+  private:
+
+    /*!
+     *  This member variable contains the buffer of the file.
+     */
+    std::vector<char> buffer_m;
+};
+
 /*!
  *   This class contains the base information to create a report
  *   set.  The report set may be text based, html based or some
@@ -135,6 +158,12 @@ class ReportsBase {
      */
     time_t timestamp_m;
 
+    /*!
+     *  This member variable contains the timestamp formatted as asctime()
+     *  does for the report headers.
+     */
+    std::string dateTime_m;
+
     /*!
      *  This member variable contains the explanations to report on.
      */
@@ -428,25 +457,26 @@ class ReportsBase {
 };
 
 /*!
- *  This method iterates over all report set types and generates
- *  all reports.
+ *  This method iterates over all symbol sets and report set types and
+ *  generates all reports. Each report is written by a task and the tasks
+ *  run at the same time up to the number of jobs.
  *
- *  @param[in] symbolSetName is the name of the symbol set to report on.
  *  @param[in] allExplanations is the explanations to report on.
  *  @param[in] verbose specifies whether to be verbose with output
  *  @param[in] projectName specifies the name of the project
  *  @param[in] outputDirectory specifies the directory for the output
  *  @param[in] symbolsToAnalyze the symbols to be analyzed
  *  @param[in] branchInfoAvailable tells if branch info is available
+ *  @param[in] jobs specifies the number of reports written at once
  */
 void GenerateReports(
-  const std::string&              symbolSetName,
   Coverage::Explanations&         allExplanations,
   bool                            verbose,
   const std::string&              projectName,
   const std::string&              outputDirectory,
   const Coverage::DesiredSymbols& symbolsToAnalyze,
-  bool                            branchInfoAvailable
+  bool                            branchInfoAvailable,
+  unsigned int                    jobs
 );
 
 }
@@ -41,7 +41,7 @@ ReportsText::~ReportsText()
 void ReportsText::AnnotatedStart( std::ofstream& aFile )
 {
   aFile << "========================================"
-        << "=======================================" << std::endl;
+        << "=======================================" << '\n';
 }
 
 void ReportsText::AnnotatedEnd( std::ofstream& aFile )
@@ -55,7 +55,7 @@ void ReportsText::PutAnnotatedLine(
   uint32_t             id
 )
 {
-  aFile << line << std::endl;
+  aFile << line << '\n';
 }
 
 bool ReportsText::PutNoBranchInfo( std::ofstream& report )
@@ -64,9 +64,9 @@ bool ReportsText::PutNoBranchInfo( std::ofstream& report )
     branchInfoAvailable_m &&
     symbolsToAnalyze_m.getNumberBranchesFound( symbolSetName_m ) != 0
   ) {
-    report << "All branch paths taken." << std::endl;
+    report << "All branch paths taken." << '\n';
   } else {
-    report << "No branch information found." << std::endl;
+    report << "No branch information found." << '\n';
   }
 
   return true;
@@ -84,46 +84,46 @@ bool ReportsText::PutBranchEntry(
   const Coverage::Explanation* explanation;
 
   // Add an entry to the report
-  report << "============================================" << std::endl
+  report << "============================================" << '\n'
          << "Symbol        : " << symbolName
-         << std::hex << " (0x" << symbolInfo.baseAddress << ")" << std::endl
+         << std::hex << " (0x" << symbolInfo.baseAddress << ")" << '\n'
          << "Line          : " << range.lowSourceLine
-         << " (0x" << range.lowAddress << ")" << std::endl
+         << " (0x" << range.lowAddress << ")" << '\n'
          << "Size in Bytes : " << range.highAddress - range.lowAddress + 1
-         << std::dec << std::endl;
+         << std::dec << '\n';
 
   if (
     range.reason ==
     Coverage::CoverageRanges::UNCOVERED_REASON_BRANCH_ALWAYS_TAKEN
   ) {
     report << "Reason        : ALWAYS TAKEN"
-           << std::endl << std::endl;
+           << '\n' << '\n';
   } else if (
     range.reason ==
     Coverage::CoverageRanges::UNCOVERED_REASON_BRANCH_NEVER_TAKEN
   ) {
     report << "Reason        : NEVER TAKEN"
-           << std::endl << std::endl;
+           << '\n' << '\n';
   }
 
   // See if an explanation is available
   explanation = allExplanations_m.lookupExplanation( range.lowSourceLine );
 
   if ( !explanation ) {
-    report << "Classification: NONE" << std::endl << std::endl
-           << "Explanation:" << std::endl
-           << "No Explanation" << std::endl;
+    report << "Classification: NONE" << '\n' << '\n'
+           << "Explanation:" << '\n'
+           << "No Explanation" << '\n';
   } else {
     report << "Classification: " << explanation->classification
-           << std::endl << std::endl
-           << "Explanation:" << std::endl;
+           << '\n' << '\n'
+           << "Explanation:" << '\n';
 
     for ( unsigned int i=0; i < explanation->explanation.size(); i++ ) {
-      report << explanation->explanation[i] << std::endl;
+      report << explanation->explanation[i] << '\n';
     }
   }
 
-  report << "============================================" << std::endl;
+  report << "============================================" << '\n';
 
   return true;
 }
@@ -135,19 +135,19 @@ void ReportsText::putCoverageNoRange(
   const std::string& symbol
 )
 {
-  report << "============================================" << std::endl
-         << "Symbol        : " << symbol << std::endl << std::endl
-         << "          *** NEVER REFERENCED ***" << std::endl << std::endl
+  report << "============================================" << '\n'
+         << "Symbol        : " << symbol << '\n' << '\n'
+         << "          *** NEVER REFERENCED ***" << '\n' << '\n'
          << "This symbol was never referenced by an analyzed executable."
-         << std::endl
+         << '\n'
          << "Therefore there is no size or disassembly for this symbol."
-         << std::endl
+         << '\n'
          << "This could be due to symbol misspelling or lack of a test for"
-         << std::endl
-         << "this symbol." << std::endl
-         << "============================================" << std::endl;
+         << '\n'
+         << "this symbol." << '\n'
+         << "============================================" << '\n';
 
-  noRangeFile << symbol << std::endl;
+  noRangeFile << symbol << '\n';
 }
 
 bool ReportsText::PutCoverageLine(
@@ -162,37 +162,37 @@ bool ReportsText::PutCoverageLine(
 
   rtems::utils::ostream_guard oldState( report );
 
-  report << "============================================" << std::endl
-         << "Index                : " << range.id << std::endl
+  report << "============================================" << '\n'
+         << "Index                : " << range.id << '\n'
          << "Symbol               : " << symbolName
-         << std::hex << " (0x" << symbolInfo.baseAddress << ")" << std::endl
+         << std::hex << " (0x" << symbolInfo.baseAddress << ")" << '\n'
          << "Starting Line        : " << range.lowSourceLine
-         << " (0x" << range.lowAddress << ")" << std::endl
+         << " (0x" << range.lowAddress << ")" << '\n'
          << "Ending Line          : " << range.highSourceLine
-         << " (0x" << range.highAddress << ")" << std::endl
+         << " (0x" << range.highAddress << ")" << '\n'
          << std::dec
          << "Size in Bytes        : "
-         << range.highAddress - range.lowAddress + 1 << std::endl
+         << range.highAddress - range.lowAddress + 1 << '\n'
          << "Size in Instructions : " << range.instructionCount
-         << std::endl << std::endl;
+         << '\n' << '\n';
 
   explanation = allExplanations_m.lookupExplanation( range.lowSourceLine );
 
   if ( !explanation ) {
-    report << "Classification: NONE" << std::endl << std::endl
-           << "Explanation:" << std::endl
-           << "No Explanation" << std::endl;
+    report << "Classification: NONE" << '\n' << '\n'
+           << "Explanation:" << '\n'
+           << "No Explanation" << '\n';
   } else {
-    report << "Classification: " << explanation->classification << std::endl
-           << std::endl
-           << "Explanation:" << std::endl;
+    report << "Classification: " << explanation->classification << '\n'
+           << '\n'
+           << "Explanation:" << '\n';
 
     for ( unsigned int i=0; i < explanation->explanation.size(); i++) {
-      report << explanation->explanation[i] << std::endl;
+      report << explanation->explanation[i] << '\n';
     }
   }
 
-  report << "============================================" << std::endl;
+  report << "============================================" << '\n';
 
   return true;
 }
@@ -206,7 +206,7 @@ bool  ReportsText::PutSizeLine(
 {
   report << range.highAddress - range.lowAddress + 1 << '\t'
          << symbolName << '\t'
-         << range.lowSourceLine << std::endl;
+         << range.lowSourceLine << '\n';
 
   return true;
 }
@@ -224,18 +224,18 @@ bool  ReportsText::PutSymbolSummaryLine(
   rtems::utils::ostream_guard old_state( report );
 
   if ( symbolInfo.stats.sizeInBytes == 0 ) {
-    report << "============================================" << std::endl
-           << "Symbol                            : " << symbolName << std::endl
+    report << "============================================" << '\n'
+           << "Symbol                            : " << symbolName << '\n'
            << "          *** NEVER REFERENCED ***"
-           << std::endl << std::endl
+           << '\n' << '\n'
            << "This symbol was never referenced by an analyzed executable."
-           << std::endl
+           << '\n'
            << "Therefore there is no size or disassembly for this symbol."
-           << std::endl
+           << '\n'
            << "This could be due to symbol misspelling or lack of a test for"
-           << std::endl
-           << "this symbol." << std::endl
-           << "============================================" << std::endl;
+           << '\n'
+           << "this symbol." << '\n'
+           << "============================================" << '\n';
   } else {
     if ( symbolInfo.stats.sizeInInstructions == 0 ) {
       uncoveredInstructions = 0;
@@ -252,28 +252,28 @@ bool  ReportsText::PutSymbolSummaryLine(
                        symbolInfo.stats.sizeInBytes;
     }
 
-    report << "============================================" << std::endl
+    report << "============================================" << '\n'
            << "Symbol                            : "
-           << symbolName << std::endl
+           << symbolName << '\n'
            << "Total Size in Bytes               : "
-           << symbolInfo.stats.sizeInBytes << std::endl
+           << symbolInfo.stats.sizeInBytes << '\n'
            << "Total Size in Instructions        : "
-           << symbolInfo.stats.sizeInInstructions << std::endl
+           << symbolInfo.stats.sizeInInstructions << '\n'
            << "Total number Branches             : "
            << symbolInfo.stats.branchesNotExecuted +
               symbolInfo.stats.branchesExecuted
-           << std::endl
+           << '\n'
            << "Total Always Taken                : "
-           << symbolInfo.stats.branchesAlwaysTaken << std::endl
+           << symbolInfo.stats.branchesAlwaysTaken << '\n'
            << "Total Never Taken                 : "
-           << symbolInfo.stats.branchesNeverTaken << std::endl
+           << symbolInfo.stats.branchesNeverTaken << '\n'
            << std::fixed << std::setprecision( 2 )
            << "Percentage Uncovered Instructions : "
-           << uncoveredInstructions << std::endl
+           << uncoveredInstructions << '\n'
            << "Percentage Uncovered Bytes        : "
-           << uncoveredBytes << std::endl;
+           << uncoveredBytes << '\n';
 
-  report << "============================================" << std::endl;
+  report << "============================================" << '\n';
   }
 
   return true;
@@ -110,6 +110,11 @@ namespace Coverage {
     return "";
   }
 
+  const SymbolTable::contents_t& SymbolTable::getContents( void ) const
+  {
+    return contents;
+  }
+
   void SymbolTable::dumpSymbolTable( void )
   {
     symbolInfo           symbolTable;
@@ -35,6 +35,17 @@ namespace Coverage {
    typedef std::list< symbolInfo_t > symbolInfo;
    typedef std::list< symbolInfo_t >::iterator  symbolInfoIterator_t;
 
+    /*!
+     *  This map associates the end address of a symbol's address
+     *  range with the symbol's address range definition.
+     */
+    typedef struct {
+       uint32_t    low;
+       uint32_t    high;
+       std::string symbol;
+    } symbol_entry_t;
+    typedef std::map< uint32_t, symbol_entry_t > contents_t;
+
     /*!
      *  This method constructs a SymbolTable instance.
      */
@@ -93,6 +104,14 @@ namespace Coverage {
       uint32_t address
     );
 
+    /*!
+     *  This method returns the address ranges of the symbols ordered
+     *  by the end address of each range.
+     *
+     *  @return Returns the symbol address ranges
+     */
+    const contents_t& getContents( void ) const;
+
     /*!
      *  This method prints SymbolTable content to stdout
      *
@@ -102,15 +121,8 @@ namespace Coverage {
   private:
 
     /*!
-     *  This map associates the end address of a symbol's address
-     *  range with the symbol's address range definition.
+     *  The symbol address ranges keyed by end address.
      */
-    typedef struct {
-       uint32_t    low;
-       uint32_t    high;
-       std::string symbol;
-    } symbol_entry_t;
-    typedef std::map< uint32_t, symbol_entry_t > contents_t;
     contents_t contents;
 
     /*!
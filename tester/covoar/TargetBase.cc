@@ -5,9 +5,12 @@
  *  functions supporting target unique functionallity.
  */
 
-#include <algorithm>
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
 
 #include <rld.h>
 
@@ -19,7 +22,9 @@ namespace Target {
   TargetBase::TargetBase(
     std::string targetName
   ):
-    targetName_m( targetName )
+    targetName_m( targetName ),
+    mnemonics_m( 64, -1 ),
+    conditionalBranches_m( 0 )
   {
     int i;
     std::string front = "";
@@ -60,71 +65,211 @@ namespace Target {
     return targetName_m;
   }
 
-  bool TargetBase::isBranch( const std::string& instruction )
+  /*
+   * The FNV-1a hash of a mnemonic.
+   */
+  static uint32_t hashMnemonic( const char* mnemonic, size_t length )
   {
-    std::list <std::string>::iterator i;
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < length; ++i) {
+      hash ^= (uint8_t) mnemonic[i];
+      hash *= 16777619U;
+    }
+    return hash;
+  }
+
+  void TargetBase::addInstruction( const instruction_t& instruction )
+  {
+    int first = findInstruction(
+      instruction.mnemonic.c_str(),
+      instruction.mnemonic.length()
+    );
+
+    instructions_m.push_back( instruction );
+    instructions_m.back().next = -1;
+
+    int index = instructions_m.size() - 1;
+
+    if (first >= 0) {
+      while (instructions_m[first].next >= 0)
+        first = instructions_m[first].next;
+      instructions_m[first].next = index;
+      return;
+    }
+
+    // Keep the table at most half full so a miss ends quickly.
+    if ((instructions_m.size() * 2) > mnemonics_m.size()) {
+      std::vector<int> old( mnemonics_m.size() * 2, -1 );
+      old.swap( mnemonics_m );
+      for (int i : old) {
+        if (i >= 0) {
+          const std::string& m = instructions_m[i].mnemonic;
+          size_t mask = mnemonics_m.size() - 1;
+          size_t slot = hashMnemonic( m.c_str(), m.length() ) & mask;
+          while (mnemonics_m[slot] >= 0)
+            slot = (slot + 1) & mask;
+          mnemonics_m[slot] = i;
+        }
+      }
+    }
+
+    size_t mask = mnemonics_m.size() - 1;
+    size_t slot =
+      hashMnemonic( instruction.mnemonic.c_str(), instruction.mnemonic.length() )
+      & mask;
+    while (mnemonics_m[slot] >= 0)
+      slot = (slot + 1) & mask;
+    mnemonics_m[slot] = index;
+  }
 
-    if (conditionalBranchInstructions.empty()) {
+  int TargetBase::findInstruction( const char* mnemonic, size_t length ) const
+  {
+    size_t mask = mnemonics_m.size() - 1;
+    size_t slot = hashMnemonic( mnemonic, length ) & mask;
+
+    while (mnemonics_m[slot] >= 0) {
+      const std::string& m = instructions_m[mnemonics_m[slot]].mnemonic;
+      if (m.length() == length && ::memcmp( m.c_str(), mnemonic, length ) == 0)
+        return mnemonics_m[slot];
+      slot = (slot + 1) & mask;
+    }
+
+    return -1;
+  }
+
+  void TargetBase::addConditionalBranch( const char* mnemonic )
+  {
+    for (int i = findInstruction( mnemonic, ::strlen( mnemonic ) );
+         i >= 0;
+         i = instructions_m[i].next) {
+      if (instructions_m[i].isBranch)
+        return;
+    }
+
+    addInstruction(
+      instruction_t{ mnemonic, "", true, true, false, 0, -1 }
+    );
+    conditionalBranches_m++;
+  }
+
+  void TargetBase::addNop( const char* mnemonic, const char* operands, int size )
+  {
+    addInstruction(
+      instruction_t{
+        mnemonic,
+        operands == NULL ? "" : operands,
+        operands == NULL,
+        false,
+        true,
+        size,
+        -1
+      }
+    );
+  }
+
+  bool TargetBase::isBranch( const std::string& instruction ) const
+  {
+    if (conditionalBranches_m == 0) {
       throw rld::error(
         "DETERMINE BRANCH INSTRUCTIONS FOR THIS ARCHITECTURE! -- fix me",
         "TargetBase::isBranch"
       );
     }
 
-    i = find(
-      conditionalBranchInstructions.begin(),
-      conditionalBranchInstructions.end(),
-      instruction.c_str()
-    );
-    if ( i  == conditionalBranchInstructions.end() )
-      return false;
+    for (int i = findInstruction( instruction.c_str(), instruction.length() );
+         i >= 0;
+         i = instructions_m[i].next) {
+      if (instructions_m[i].isBranch)
+        return true;
+    }
 
-    return true;
+    return false;
   }
 
-  bool TargetBase::isBranchLine(
-    const std::string& line
-  )
+  bool TargetBase::classifyLine(
+    const std::string&  line,
+    instructionClass_t& instruction
+  ) const
   {
     #define WARNING_PT1 \
-        "WARNING: TargetBase::isBranchLine - ("
+        "WARNING: TargetBase::classifyLine - ("
     #define WARNING_PT2 \
         ") Unable to find instruction in: "
-    const char *ch;
-    char instruction[120];
-    int  result;
+    const char* ch = line.c_str();
+    const char* mnemonic;
+    const char* operands;
+    const char* end;
+    size_t      encodingDigits = 0;
 
+    instruction.isNop    = false;
+    instruction.nopSize  = 0;
+    instruction.isBranch = false;
 
-    ch = &(line[0]);
+    if (conditionalBranches_m == 0) {
+      throw rld::error(
+        "DETERMINE BRANCH INSTRUCTIONS FOR THIS ARCHITECTURE! -- fix me",
+        "TargetBase::classifyLine"
+      );
+    }
 
-    // Increment to the first tab in the line
-    while ((*ch != '\t') && (*ch != '\0')) {
+    // The line is the address, a tab, the encoding, a tab and then the
+    // mnemonic and operands. Increment to the first tab in the line.
+    while ((*ch != '\t') && (*ch != '\0'))
       ch++;
-    }
     if (*ch != '\t') {
       std::cerr << WARNING_PT1 << 1 << WARNING_PT2 << line << std::endl;
       return false;
     }
     ch++;
 
-    // Increment to the second tab in the line
-    while ((*ch != '\t') && (*ch != '\0'))
+    // Count the hex digits of the encoding up to the second tab.
+    while ((*ch != '\t') && (*ch != '\0')) {
+      if (::isxdigit( (unsigned char) *ch ))
+        encodingDigits++;
       ch++;
+    }
     if (*ch != '\t') {
       std::cerr << WARNING_PT1 << 2 << WARNING_PT2 << line << std::endl;
       return false;
     }
     ch++;
 
-    // Grab the instruction which is the next word in the buffer
-    // after the second tab.
-    result = sscanf( ch, "%s", instruction );
-    if (result != 1) {
-        std::cerr << WARNING_PT1 << 3 << WARNING_PT2 << line << std::endl;
-        return false;
+    // The mnemonic is the next word after the second tab.
+    while (::isspace( (unsigned char) *ch ))
+      ch++;
+    mnemonic = ch;
+    while ((*ch != '\0') && !::isspace( (unsigned char) *ch ))
+      ch++;
+    if (ch == mnemonic) {
+      std::cerr << WARNING_PT1 << 3 << WARNING_PT2 << line << std::endl;
+      return false;
+    }
+    end = ch;
+
+    // The operands are the rest of the line.
+    while (::isspace( (unsigned char) *ch ))
+      ch++;
+    operands = ch;
+
+    for (int i = findInstruction( mnemonic, end - mnemonic );
+         i >= 0;
+         i = instructions_m[i].next) {
+      const instruction_t& entry = instructions_m[i];
+      if (entry.isBranch) {
+        instruction.isBranch = true;
+      } else if (
+        !instruction.isNop &&
+        (entry.anyOperands || entry.operands == operands)
+      ) {
+        instruction.isNop = true;
+        if (entry.nopSize == 0)
+          instruction.nopSize = encodingDigits / 2;
+        else
+          instruction.nopSize = entry.nopSize;
+      }
     }
 
-    return isBranch( instruction );
+    return true;
   }
 
   uint8_t TargetBase::qemuTakenBit()
@@ -7,8 +7,8 @@
 #ifndef __TARGETBASE_H__
 #define __TARGETBASE_H__
 
-#include <list>
 #include <string>
+#include <vector>
 #include <stdint.h>
 
 namespace Target {
@@ -66,39 +66,49 @@ namespace Target {
     const std::string& getTarget() const;
 
     /*!
-     *  This method determines whether the specified line from a
-     *  objdump file is a nop instruction.
-     *
-     *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
-     *
-     *  @return Returns TRUE if the instruction is a nop, FALSE otherwise.
+     *  This type is the classification of an instruction.
      */
-    virtual bool isNopLine(
-      const std::string& line,
-      int&               size
-    ) = 0;
+    struct instructionClass_t {
+      /*!
+       *  This member variable is TRUE if the instruction is a nop.
+       */
+      bool isNop;
+
+      /*!
+       *  This member variable contains the size in bytes of the nop.
+       */
+      int nopSize;
 
+      /*!
+       *  This member variable is TRUE if the instruction is a
+       *  conditional branch.
+       */
+      bool isBranch;
+    };
 
     /*!
-     *  This method determins if the objdump line contains a
-     *  branch instruction.
+     *  This method classifies the instruction of an objdump instruction
+     *  line. The line is split into the encoding, mnemonic and operands
+     *  once and the mnemonic is looked up in the target's instruction
+     *  table. The mnemonic and the operands of a nop must match the table
+     *  exactly, see addNop().
      *
      *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
+     *  @param[out] instruction is set to the instruction's classification
      *
-     *  @return Returns TRUE if the instruction is a branch, FALSE otherwise.
+     *  @return Returns TRUE if the line holds an instruction, FALSE
+     *          otherwise.
      */
-    bool isBranchLine(
-      const std::string& line
-    );
-
+    bool classifyLine(
+      const std::string&  line,
+      instructionClass_t& instruction
+    ) const;
 
     /*!
-     *  This method determines if the specified line from an
-     *  objdump file is a branch instruction.
+     *  This method determines if the specified instruction is a
+     *  conditional branch instruction.
      */
-    bool isBranch( const std::string& instruction );
+    bool isBranch( const std::string& instruction ) const;
 
     /*!
      *  This method returns the bit set by Qemu in the trace record
@@ -120,13 +130,75 @@ namespace Target {
     std::string    targetName_m;
 
     /*!
-     * This member variable is an array of all conditional branch instructions
-     * for this target.
+     *  This method adds a conditional branch instruction of the target.
+     *
+     *  @param[in] mnemonic specifies the instruction's mnemonic
      */
-    std::list <std::string> conditionalBranchInstructions;
+    void addConditionalBranch( const char* mnemonic );
+
+    /*!
+     *  This method adds a nop instruction of the target. A nop can be an
+     *  instruction the toolchain pads code with or data placed in the
+     *  code.
+     *
+     *  A line is a nop only if its mnemonic is exactly @a mnemonic and,
+     *  if @a operands is not NULL, its operands are exactly @a operands.
+     *  Other mnemonics ending in the nop's, such as c.nop or fnop, are not
+     *  nops unless they are added too.
+     *
+     *  @param[in] mnemonic specifies the instruction's mnemonic
+     *  @param[in] operands specifies the operands the instruction must
+     *             have or NULL for any operands
+     *  @param[in] size specifies the size in bytes of the nop or 0 if it is
+     *             the size of the instruction's encoding
+     */
+    void addNop( const char* mnemonic, const char* operands, int size );
 
   private:
 
+    /*!
+     *  This type is an entry of the instruction table. The entries with
+     *  the same mnemonic are linked in the order they were added.
+     */
+    struct instruction_t {
+      std::string mnemonic;
+      std::string operands;
+      bool        anyOperands;
+      bool        isBranch;
+      bool        isNop;
+      int         nopSize;
+      int         next;
+    };
+
+    /*!
+     *  This method adds an entry to the instruction table.
+     */
+    void addInstruction( const instruction_t& instruction );
+
+    /*!
+     *  This method returns the index of the first entry of the mnemonic
+     *  or -1 if the mnemonic is not in the instruction table.
+     */
+    int findInstruction( const char* mnemonic, size_t length ) const;
+
+    /*!
+     *  This member variable contains the instruction table entries.
+     */
+    std::vector<instruction_t> instructions_m;
+
+    /*!
+     *  This member variable is an open addressed hash table of the first
+     *  entry of each mnemonic. Its size is a power of two and an empty
+     *  slot is -1.
+     */
+    std::vector<int> mnemonics_m;
+
+    /*!
+     *  This member variable contains the number of conditional branch
+     *  instructions of the target.
+     */
+    size_t conditionalBranches_m;
+
     /*!
      * This member variable contains the name of the host program
      * which reports the source line for the specified program address.
@@ -32,27 +32,6 @@ namespace Target {
      */
     virtual ~Target_aarch64();
 
-    /*!
-     *  This method determines whether the specified line from a
-     *  objdump file is a nop instruction.
-     *
-     *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
-     *
-     *  @return Returns TRUE if the instruction is a nop, FALSE otherwise.
-     */
-    virtual bool isNopLine(
-      const std::string& line,
-      int&               size
-    ) override;
-
-    /*!
-     *  This method determines if the specified line from an
-     *  objdump file is a branch instruction.
-     */
-    bool isBranch(
-      const std::string& instruction
-    );
 
     /* Documentation inherited from base class */
     uint8_t qemuTakenBit() override;
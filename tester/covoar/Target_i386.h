@@ -33,19 +33,6 @@ namespace Target {
      */
     virtual ~Target_i386();
 
-    /*!
-     *  This method determines whether the specified line from a
-     *  objdump file is a nop instruction.
-     *
-     *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
-     *
-     *  @return Returns TRUE if the instruction is a nop, FALSE otherwise.
-     */
-    bool isNopLine(
-      const std::string& line,
-      int&               size
-    );
 
     /* Documentation inherited from base class */
     virtual uint8_t qemuTakenBit(void);
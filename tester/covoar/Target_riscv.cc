@@ -43,37 +43,25 @@ namespace Target {
   Target_riscv::Target_riscv( std::string targetName ):
     TargetBase( targetName )
   {
-    conditionalBranchInstructions.push_back("beqz");
-    conditionalBranchInstructions.push_back("bnez");
-    conditionalBranchInstructions.push_back("blez");
-    conditionalBranchInstructions.push_back("bgez");
-    conditionalBranchInstructions.push_back("bltz");
-    conditionalBranchInstructions.push_back("bgt");
-    conditionalBranchInstructions.push_back("bgtz");
-    conditionalBranchInstructions.push_back("ble");
-    conditionalBranchInstructions.push_back("bgtu");
-    conditionalBranchInstructions.push_back("bleu");
+    addConditionalBranch("beqz");
+    addConditionalBranch("bnez");
+    addConditionalBranch("blez");
+    addConditionalBranch("bgez");
+    addConditionalBranch("bltz");
+    addConditionalBranch("bgt");
+    addConditionalBranch("bgtz");
+    addConditionalBranch("ble");
+    addConditionalBranch("bgtu");
+    addConditionalBranch("bleu");
 
-    conditionalBranchInstructions.sort();
+    addNop("nop", "", 4);
+    addNop("c.nop", "", 2);
    }
 
   Target_riscv::~Target_riscv()
   {
   }
 
-  bool Target_riscv::isNopLine(
-    const std::string& line,
-    int&               size
-    )
-  {
-    if ( line.substr( line.length() - 3 ) == "nop" ) {
-        size = 4;
-        return true;
-    }
-
-  return false;
-  }
-
   TargetBase *Target_riscv_Constructor(
     std::string        targetName
     )
@@ -58,30 +58,7 @@ namespace Target {
 
   virtual ~Target_riscv();
 
-  /*!
-   *  This method determines nop instruction.
-   *
-   *  @param[in] line contains the object dump line to check
-   *  @param[out] size is set to the size in bytes of the nop
-   *
-   *  @return Returns True if the instruction is nop, False otherwise.
-   */
-  bool isNopLine(
-    const std::string& line,
-    int&               size
-  );
 
-  /*!
-   *  This method determines if it's a branch instruction
-   *
-   *  @param[in] instruction
-   *
-   *  @return Returns True if the instruction is a branch instruction, False otherwise.
-   */
-
-  bool isBranch(
-    const std::string& instruction
-  );
 
   private:
 
@@ -15,74 +15,51 @@ namespace Target {
   Target_sparc::Target_sparc( std::string targetName ):
     TargetBase( targetName )
   {
-    conditionalBranchInstructions.push_back("bn");
-    conditionalBranchInstructions.push_back("bn,a");
-    conditionalBranchInstructions.push_back("be");
-    conditionalBranchInstructions.push_back("be,a");
-    conditionalBranchInstructions.push_back("ble");
-    conditionalBranchInstructions.push_back("ble,a");
-    conditionalBranchInstructions.push_back("bl");
-    conditionalBranchInstructions.push_back("bl,a");
-    conditionalBranchInstructions.push_back("bleu");
-    conditionalBranchInstructions.push_back("bleu,a");
-    conditionalBranchInstructions.push_back("bcs");
-    conditionalBranchInstructions.push_back("bcs,a");
-    conditionalBranchInstructions.push_back("bneg");
-    conditionalBranchInstructions.push_back("bneg,a");
-    conditionalBranchInstructions.push_back("bvs");
-    conditionalBranchInstructions.push_back("bvs,a");
-    conditionalBranchInstructions.push_back("ba");
-    conditionalBranchInstructions.push_back("ba,a");
-    conditionalBranchInstructions.push_back("bne");
-    conditionalBranchInstructions.push_back("bne,a");
-    conditionalBranchInstructions.push_back("bg");
-    conditionalBranchInstructions.push_back("bg,a");
-    conditionalBranchInstructions.push_back("bge");
-    conditionalBranchInstructions.push_back("bge,a");
-    conditionalBranchInstructions.push_back("bgu");
-    conditionalBranchInstructions.push_back("bgu,a");
-    conditionalBranchInstructions.push_back("bcc");
-    conditionalBranchInstructions.push_back("bcc,a");
-    conditionalBranchInstructions.push_back("bpos");
-    conditionalBranchInstructions.push_back("bpos,a");
-    conditionalBranchInstructions.push_back("bvc");
-    conditionalBranchInstructions.push_back("bvc,a");
+    addConditionalBranch("bn");
+    addConditionalBranch("bn,a");
+    addConditionalBranch("be");
+    addConditionalBranch("be,a");
+    addConditionalBranch("ble");
+    addConditionalBranch("ble,a");
+    addConditionalBranch("bl");
+    addConditionalBranch("bl,a");
+    addConditionalBranch("bleu");
+    addConditionalBranch("bleu,a");
+    addConditionalBranch("bcs");
+    addConditionalBranch("bcs,a");
+    addConditionalBranch("bneg");
+    addConditionalBranch("bneg,a");
+    addConditionalBranch("bvs");
+    addConditionalBranch("bvs,a");
+    addConditionalBranch("ba");
+    addConditionalBranch("ba,a");
+    addConditionalBranch("bne");
+    addConditionalBranch("bne,a");
+    addConditionalBranch("bg");
+    addConditionalBranch("bg,a");
+    addConditionalBranch("bge");
+    addConditionalBranch("bge,a");
+    addConditionalBranch("bgu");
+    addConditionalBranch("bgu,a");
+    addConditionalBranch("bcc");
+    addConditionalBranch("bcc,a");
+    addConditionalBranch("bpos");
+    addConditionalBranch("bpos,a");
+    addConditionalBranch("bvc");
+    addConditionalBranch("bvc,a");
 
-    conditionalBranchInstructions.sort();
-  }
-
-  Target_sparc::~Target_sparc()
-  {
-  }
-
-  bool Target_sparc::isNopLine(
-    const std::string& line,
-    int&               size
-  )
-  {
-    size_t stringLen = line.length();
-
-    if ( line.substr( stringLen - 3 ) == "nop" ) {
-      size = 4;
-      return true;
-    }
-
-    if ( line.substr( stringLen - 7 ) == "unknown" ) {
-      size = 4;
-      return true;
-    }
+    addNop("nop", "", 4);
+    addNop("unknown", "", 4);
     #define GNU_LD_FILLS_ALIGNMENT_WITH_RTS
     #if defined(GNU_LD_FILLS_ALIGNMENT_WITH_RTS)
       // Until binutils 2.20, binutils would fill with rts not nop
-    if ( line.substr( stringLen - 3 ) == "rts" ) {
-        size = 4;
-        return true;
-      }
+      addNop("rts", "", 4);
     #endif
-
-    return false;
   }
 
+  Target_sparc::~Target_sparc()
+  {
+  }
 
   TargetBase *Target_sparc_Constructor(
     std::string          targetName
@@ -33,27 +33,7 @@ namespace Target {
      */
     virtual ~Target_sparc();
 
-    /*!
-     *  This method determines whether the specified line from a
-     *  objdump file is a nop instruction.
-     *
-     *  @param[in] line contains the object dump line to check
-     *  @param[out] size is set to the size in bytes of the nop
-     *
-     *  @return Returns TRUE if the instruction is a nop, FALSE otherwise.
-     */
-    bool isNopLine(
-      const std::string& line,
-      int&               size
-    );
 
-    /*!
-     *  This method determines if the specified line from an
-     *  objdump file is a branch instruction.
-     */
-    bool isBranch(
-      const std::string& instruction
-    );
 
   private:
 
@@ -92,21 +92,8 @@ int main(
   std::string                         dynamicLibrary;
   int                                 ec = 0;
   std::shared_ptr<Target::TargetBase> targetInfo;
-  rld::process::tempfile              *objdumpFile;
   rld::process::tempfile              *err;
 
-  try
-  {
-    objdumpFile = new rld::process::tempfile( ".dmp" );
-  }
-  catch ( rld::error re )
-  {
-    std::cerr << "Failed to make .dmp tempfile " << std::endl;
-    ec = 10;
-
-    return ec;
-  }
-
   try
   {
     err = new rld::process::tempfile( ".err" );
@@ -170,6 +157,8 @@ int main(
     return ec;
   }
 
+  trace.targetInfo_m = targetInfo;
+
   Coverage::ObjdumpProcessor objdumpProcessor( symbolsToAnalyze, targetInfo );
 
   if ( !dynamicLibrary.empty() ) {
@@ -219,7 +208,7 @@ int main(
 
   try
   {
-    objdumpProcessor.loadAddressTable( executableInfo, *objdumpFile, *err );
+    objdumpProcessor.loadAddressTable( executableInfo, nullptr, *err );
     log.processFile( logname.c_str(), objdumpProcessor );
     trace.writeFile( tracefile.c_str(), &log, verbose );
   }
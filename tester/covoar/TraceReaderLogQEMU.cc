@@ -36,12 +36,10 @@
  */
 
 #include <stdio.h>
-#include <stdlib.h>
-#include <sys/stat.h>
 #include <string.h>
 
 #include <iostream>
-#include <fstream>
+#include <vector>
 
 #include "qemu-log.h"
 #include "TraceReaderBase.h"
@@ -51,27 +49,263 @@
 
 #include "rld-process.h"
 
-bool ReadUntilFound( std::ifstream& file, const char* line )
-{
-  char   discardBuff[100] = {};
-  size_t len = strlen( line );
+/*
+ * Reads a log file a line at a time through a large buffer. A line is
+ * returned in place in the buffer so it is not copied. A line longer than
+ * the buffer grows the buffer.
+ */
+class LogLineScanner {
+
+public:
+
+  LogLineScanner() :
+    file( nullptr ),
+    buffer( 1024 * 1024 ),
+    start( 0 ),
+    level( 0 ),
+    eof( false ),
+    again( false ),
+    line( nullptr ),
+    size( 0 )
+  {
+  }
 
-  if ( len > sizeof( discardBuff ) ) {
-    std::cerr << "ReadUntilFound(): parameter 'line' is too long" << std::endl;
-    return false;
+  ~LogLineScanner()
+  {
+    if ( file != nullptr ) {
+      ::fclose( file );
+    }
+  }
+
+  bool open( const std::string& name )
+  {
+    file = ::fopen( name.c_str(), "rb" );
+    return file != nullptr;
+  }
+
+  /*
+   * Returns true if the file has no data.
+   */
+  bool empty()
+  {
+    return !fill();
   }
 
-  do {
-    file.read( discardBuff, sizeof( discardBuff ) - 2 );
-    if ( file.fail() ) {
+  /*
+   * Returns the next line without the line terminator. The line is valid
+   * until the next call.
+   */
+  bool next( const char*& text, size_t& length )
+  {
+    if ( again ) {
+      again = false;
+    } else {
+      const char* eol = nullptr;
+
+      while ( true ) {
+        eol = static_cast<const char*>(
+          ::memchr( &buffer[ start ], '\n', level - start )
+        );
+        if ( eol != nullptr || !fill() ) {
+          break;
+        }
+      }
+
+      if ( eol == nullptr && start == level ) {
+        return false;
+      }
+
+      line = &buffer[ start ];
+      if ( eol == nullptr ) {
+        size = level - start;
+        start = level;
+      } else {
+        size = eol - line;
+        start += size + 1;
+      }
+
+      if ( size > 0 && line[ size - 1 ] == '\r' ) {
+        --size;
+      }
+    }
+
+    text = line;
+    length = size;
+    return true;
+  }
+
+  /*
+   * Returns the last line again on the next call to next().
+   */
+  void unget()
+  {
+    again = true;
+  }
+
+private:
+
+  /*
+   * Moves the unread data to the start of the buffer and reads more data
+   * after it. Returns false if there is no more data.
+   */
+  bool fill()
+  {
+    if ( eof ) {
+      return false;
+    }
+
+    if ( start > 0 ) {
+      ::memmove( &buffer[ 0 ], &buffer[ start ], level - start );
+      level -= start;
+      start = 0;
+    }
+
+    if ( level == buffer.size() ) {
+      buffer.resize( buffer.size() * 2 );
+    }
+
+    size_t got = ::fread( &buffer[ level ], 1, buffer.size() - level, file );
+    if ( got == 0 ) {
+      eof = true;
       return false;
     }
 
-    if ( strncmp( discardBuff, line, len ) == 0 ) {
+    level += got;
+    return true;
+  }
+
+  FILE*             file;
+  std::vector<char> buffer;
+  size_t            start;
+  size_t            level;
+  bool              eof;
+  bool              again;
+  const char*       line;
+  size_t            size;
+};
+
+/*
+ * Returns true if the line starts with the key.
+ */
+static bool StartsWith( const char* line, size_t length, const char* key )
+{
+  size_t len = ::strlen( key );
+  return ( length >= len ) && ( ::strncmp( line, key, len ) == 0 );
+}
+
+/*
+ * Reads lines until one starts with the key.
+ */
+static bool ReadUntilFound( LogLineScanner& log, const char* key )
+{
+  const char* line;
+  size_t      length;
+
+  while ( log.next( line, length ) ) {
+    if ( StartsWith( line, length, key ) ) {
       return true;
     }
+  }
 
-  } while( true );
+  return false;
+}
+
+static bool IsSpace( char c )
+{
+  return c == ' ' || c == '\t';
+}
+
+/*
+ * Parses an instruction line of an IN: block. The line is the address in
+ * hex, a ':', the instruction and its data, for example:
+ *
+ *   0x40001000:  sethi  %hi(0x40012000), %g1
+ *
+ * The data is the first word after the instruction.
+ */
+static bool ParseInstruction(
+  const char*          line,
+  size_t               length,
+  QEMU_LOG_IN_Block_t& block
+)
+{
+  const char*   p = line;
+  const char*   end = line + length;
+  unsigned long address = 0;
+  int           digits = 0;
+
+  while ( p < end && IsSpace( *p ) ) {
+    ++p;
+  }
+
+  if ( ( end - p ) > 2 && p[ 0 ] == '0' && ( p[ 1 ] == 'x' || p[ 1 ] == 'X' ) ) {
+    p += 2;
+  }
+
+  for ( ; p < end; ++p, ++digits ) {
+    char c = *p;
+    int  v;
+
+    if ( c >= '0' && c <= '9' ) {
+      v = c - '0';
+    } else if ( c >= 'a' && c <= 'f' ) {
+      v = c - 'a' + 10;
+    } else if ( c >= 'A' && c <= 'F' ) {
+      v = c - 'A' + 10;
+    } else {
+      break;
+    }
+    address = ( address << 4 ) | v;
+  }
+
+  if ( digits == 0 || p == end || *p != ':' ) {
+    return false;
+  }
+  ++p;
+
+  while ( p < end && IsSpace( *p ) ) {
+    ++p;
+  }
+  const char* instruction = p;
+  while ( p < end && !IsSpace( *p ) ) {
+    ++p;
+  }
+  if ( p == instruction ) {
+    return false;
+  }
+  block.instruction.assign( instruction, p - instruction );
+
+  while ( p < end && IsSpace( *p ) ) {
+    ++p;
+  }
+  const char* data = p;
+  while ( p < end && !IsSpace( *p ) ) {
+    ++p;
+  }
+  block.data.assign( data, p - data );
+
+  block.address = address;
+  return true;
+}
+
+/*
+ * Reads the next line as an instruction line.
+ */
+static bool ReadInstruction( LogLineScanner& log, QEMU_LOG_IN_Block_t& block )
+{
+  const char* line;
+  size_t      length;
+
+  if ( !log.next( line, length ) ) {
+    return false;
+  }
+
+  if ( !ParseInstruction( line, length, block ) ) {
+    log.unget();
+    return false;
+  }
+
+  return true;
 }
 
 namespace Trace {
@@ -94,36 +328,21 @@ namespace Trace {
     QEMU_LOG_IN_Block_t last          = { 0, "", "" };
     QEMU_LOG_IN_Block_t nextExecuted  = { 0, "", "" };
     uint32_t            nextlogical;
-    int                 status;
-    std::ifstream       logFile;
-    int                 result;
-    int                 fileSize;
-    char                ignore;
+    LogLineScanner      logFile;
 
     //
-    // Verify that the log file has a non-zero size.
+    // Open the log file and verify that it has a non-zero size.
     //
-    logFile.open( file, std::ifstream::in | std::ifstream::binary );
-    if ( !logFile.is_open() ) {
+    if ( !logFile.open( file ) ) {
       std::cerr << "Unable to open " << file << std::endl;
       return false;
     }
 
-    logFile.seekg( 0, std::ios::end );
-    fileSize = logFile.tellg();
-
-    if ( fileSize == 0 ) {
+    if ( logFile.empty() ) {
       std::cerr << file << " is 0 bytes long" << std::endl;
       return false;
     }
 
-    logFile.close();
-
-    //
-    // Open the coverage file and discard the header.
-    //
-    logFile.open( file );
-
     //
     //  Discard Header section
     //
@@ -144,12 +363,7 @@ namespace Trace {
     //
     //  Read First Start Address
     //
-    logFile >> std::hex >> first.address >> std::dec
-            >> ignore
-            >> first.instruction
-            >> first.data;
-
-    if ( logFile.fail() ) {
+    if ( !ReadInstruction( logFile, first ) ) {
       std::cerr << "Error Unable to Read Initial First Block" << std::endl;
       done = true;
     }
@@ -158,28 +372,18 @@ namespace Trace {
 
       last = first;
 
-      // Read until we get to the last instruction in the block.
-      do {
-        logFile >> std::hex >> last.address >> std::dec
-                >> ignore
-                >> last.instruction
-                >> last.data;
-      } while( !logFile.fail() );
+      // Read until we get to the last instruction in the block. The line
+      // that ends the block is searched for the next IN: block.
+      while ( ReadInstruction( logFile, last ) ) {
+      }
 
       nextlogical = objdumpProcessor.getAddressAfter( last.address );
 
       if ( !ReadUntilFound( logFile, QEMU_LOG_IN_KEY ) ) {
         done = true;
         nextExecuted = last;
-      } else {
-        logFile >> std::hex >> nextExecuted.address >> std::dec
-                >> ignore
-                >> nextExecuted.instruction
-                >> nextExecuted.data;
-
-        if ( logFile.fail() ) {
-          std::cerr << "Error Unable to Read First Block" << std::endl;
-        }
+      } else if ( !ReadInstruction( logFile, nextExecuted ) ) {
+        std::cerr << "Error Unable to Read First Block" << std::endl;
       }
 
       // If the nextlogical was not found we are throwing away
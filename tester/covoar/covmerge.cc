@@ -5,18 +5,24 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
-#include <netdb.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <unistd.h>
 #include <errno.h>
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rld.h>
+#include <rld-threads.h>
+
 #include "CoverageFactory.h"
-#include "CoverageMap.h"
-#include "CoverageRanges.h"
-#include "Explanations.h"
-#include "ObjdumpProcessor.h"
-#include "Reports.h"
+#include "CoverageMapBase.h"
+#include "DesiredSymbols.h"
+#include "ExecutableInfo.h"
+#include "TargetFactory.h"
 
 /*
  *  Variables to control global behavior
@@ -24,38 +30,13 @@
 int verbose = 0;
 Coverage::CoverageFormats_t coverageFormat;
 char *mergedCoverageFile = NULL;
-char *branchReportFile = NULL;
-char *coverageReportFile = NULL;
-char *sizeReportFile = NULL;
 uint32_t lowAddress  = 0xffffffff;
 uint32_t highAddress = 0xffffffff;
+unsigned int jobs = 1;
 
 char *target = NULL;
-char *executable = NULL;
-char *explanations = NULL;
-char *noExplanations = NULL;
 char *progname;
 
-/*
- *  Global variables for the program
- */
-Coverage::CoverageMapBase    *CoverageMap      = NULL;
-Coverage::CoverageReaderBase *CoverageReader   = NULL;
-Coverage::CoverageWriterBase *CoverageWriter   = NULL;
-Coverage::ObjdumpProcessor   *ObjdumpProcessor = NULL;
-Coverage::CoverageRanges     *Ranges           = NULL;
-Coverage::Explanations       *Explanations     = NULL;
-
-int  BranchesAlwaysTaken = 0;
-bool BranchesFound = false;
-int  BranchesNeverTaken = 0;
-int  UncoveredRanges = 0;
-
-/*
- *  Set of addresses we need source line number for
- */
-std::list<uint32_t> AddressesNeedingSourceLine;
-
 /*
  *  Convert string to int with status out
  */
@@ -96,18 +77,15 @@ void usage()
 {
   fprintf(
     stderr,
-    "Usage: %s [-v] [-t] [-m file] -T TARGET [-e EXECUTABLE]-l ADDRESS -h ADDRESS coverage1... coverageN\n"
+    "Usage: %s [-v] [-j JOBS] [-m file] -T TARGET -f FORMAT -l ADDRESS -h ADDRESS coverage1... coverageN\n"
     "\n"
     "  -l low address   - low address of range to merge\n"
-    "  -l high address  - high address of range to merge\n"
+    "  -h high address  - high address of range to merge\n"
     "  -f format        - coverage files are in <format> "
                      "(RTEMS, TSIM or Skyeye)\n"
+    "  -j JOBS          - number of coverage files to read at once\n"
     "  -m FILE          - optional merged coverage file to write\n"
-    "  -r REPORT        - optional coverage report to write\n"
-    "  -s REPORT        - optional size report to write\n"
     "  -T TARGET        - target name\n"
-    "  -e EXECUTABLE    - name of executable to get symbols from\n"
-    "  -E EXPLANATIONS  - name of file with explanations\n"
     "  -v               - verbose at initialization\n"
     "\n",
     progname
@@ -115,134 +93,29 @@ void usage()
 }
 
 /*
- *  Look over the coverage map and compute uncovered ranges and branches
- */
-void ComputeUncovered(void)
-{
-  uint32_t a, la, ha;
-  std::list<Coverage::CoverageRange>::iterator it;
-
-  a = lowAddress;
-  while (a < highAddress) {
-
-    /*
-     *  Find all the unexecuted addresses and add them to the range.
-     */
-    if (!CoverageMap->wasExecuted( a )) {
-      la = a;
-      for (ha=a+1; ha<=highAddress && !CoverageMap->wasExecuted(ha); ha++)
-        ;
-      ha--;
-
-      UncoveredRanges++;
-      Ranges->add( la, ha );
-      AddressesNeedingSourceLine.push_back( la );
-      AddressesNeedingSourceLine.push_back( ha );
-      a = ha + 1;
-    }
-
-    else if (CoverageMap->isBranch( a )) {
-      BranchesFound = true;
-      la = a;
-      for (ha=a+1;
-           ha<=highAddress && !CoverageMap->isStartOfInstruction(ha);
-           ha++)
-        ;
-      ha--;
-
-      if (CoverageMap->wasAlwaysTaken( la )) {
-        BranchesAlwaysTaken++;
-        AddressesNeedingSourceLine.push_back( la );
-      }
-      else if (CoverageMap->wasNeverTaken( la )) {
-        BranchesNeverTaken++;
-        AddressesNeedingSourceLine.push_back( la );
-      }
-      a = ha + 1;
-    }
-    else
-      a++;
-  }
-}
-
-/*
- *  Find source lines for addresses
+ *  Add the execution and branch counts of one coverage map of the
+ *  address range to another.
  */
-void FindSourceForAddresses(void)
+void MergeCoverageMap(
+  Coverage::CoverageMapBase*       destination,
+  const Coverage::CoverageMapBase* source
+)
 {
-  FILE                          *tmpfile;
-  std::list<uint32_t>::iterator  it;
-
-  /*
-   *  Write a temporary file with ranges
-   */
-  if ( verbose )
-    fprintf( stderr, "Writing ranges.tmp input to addr2line\n" );
-
-  tmpfile = fopen( "ranges.tmp", "w" );
-  if ( !tmpfile ) {
-    fprintf( stderr, "Unable to open %s\n\n", "ranges.tmp" );
-    exit(-1);
-  }
-
-  for (it =  AddressesNeedingSourceLine.begin() ;
-       it != AddressesNeedingSourceLine.end() ;
-       it++ ) {
-    fprintf(tmpfile, "0x%08x\n", *it);
-  }
-
-  fclose( tmpfile );
-
-  /*
-   *  Generate a file with the addr2line mapping
-   */
-  if ( verbose )
-    fprintf( stderr, "Running addr2line\n" );
+  uint64_t a;
 
-  {
-    char command[512];
-    sprintf(
-      command,
-      "%s -e %s <%s | dos2unix >%s",
-      Tools->getAddr2line(),
-      executable,
-      "ranges.tmp",
-      "ranges01.tmp"
-    );
-    if ( system( command ) ) {
-      fprintf( stderr, "addr2line command (%s) failed\n", command );
-      exit( -1 );
-    }
-  }
-
-  /*
-   *  Go back over the ranges, read the addr2line output, and correlate it.
-   */
-  if ( verbose )
-    fprintf( stderr, "Merging addr2line output into range\n" );
-
-  tmpfile = fopen( "ranges01.tmp", "r" );
-  if ( !tmpfile ) {
-    fprintf( stderr, "Unable to open %s\n\n", "ranges01.tmp" );
-    exit(-1);
-  }
-
-  for (it =  AddressesNeedingSourceLine.begin() ;
-       it != AddressesNeedingSourceLine.end() ;
-       it++ ) {
-    char buffer[512];
-    char *cStatus;
+  for ( a = lowAddress; a <= highAddress; a++ ) {
+    uint32_t count = source->getWasExecuted( a );
+    if ( count != 0 )
+      destination->sumWasExecuted( a, count );
 
-    cStatus = fgets( buffer, 512, tmpfile );
-    if ( cStatus == NULL ) {
-      fprintf( stderr, "Out of sync in addr2line output\n" );
-      exit( -1 );
-    }
-    buffer[ strlen(buffer) - 1] = '\0';
+    count = source->getWasTaken( a );
+    if ( count != 0 )
+      destination->sumWasTaken( a, count );
 
-    CoverageMap->setSourceLine( *it, std::string( buffer ) );
+    count = source->getWasNotTaken( a );
+    if ( count != 0 )
+      destination->sumWasNotTaken( a, count );
   }
-  fclose( tmpfile );
 }
 
 #define PrintableString(_s) \
@@ -254,26 +127,27 @@ int main(
 )
 {
   int opt;
-  int i;
   char *format = NULL;
-  Target::TargetBase* targetInfo;
+  char *end;
 
   progname = argv[0];
 
-  while ((opt = getopt(argc, argv, "b:e:E:f:h:l:m:r:s:T:v")) != -1) {
+  while ((opt = getopt(argc, argv, "f:h:j:l:m:T:v")) != -1) {
     switch (opt) {
-      case 'b': branchReportFile   = optarg;  break;
-      case 'e': executable         = optarg;  break;
-      case 'E': explanations       = optarg;  break;
       case 'm': mergedCoverageFile = optarg;  break;
-      case 'r': coverageReportFile = optarg;  break;
-      case 's': sizeReportFile     = optarg;  break;
       case 'T': target             = optarg;  break;
       case 'v': verbose            = 1;       break;
       case 'f':
-        coverageFormat = Coverage::CoverageFormatToEnum(optarg);
         format = optarg;
         break;
+      case 'j':
+        jobs = strtoul( optarg, &end, 10 );
+        if ( *end != '\0' || jobs == 0 ) {
+          fprintf( stderr, "Jobs is not a positive number\n" );
+          usage();
+          exit(-1);
+        }
+        break;
       case 'l':
         if ( ! stringToUint32( optarg, 16, &lowAddress ) ) {
           fprintf( stderr, "Low address is not a hexadecimal number\n" );
@@ -295,11 +169,11 @@ int main(
   }
   if ( verbose ) {
     fprintf( stderr, "verbose         : %d\n", verbose );
-    fprintf( stderr, "Coverage Format : %s\n", format );
+    fprintf( stderr, "Coverage Format : %s\n", PrintableString(format) );
     fprintf( stderr, "low address     : 0x%08x\n", lowAddress );
     fprintf( stderr, "high address    : 0x%08x\n", highAddress );
     fprintf( stderr, "Target          : %s\n", PrintableString(target) );
-    fprintf( stderr, "executable      : %s\n", PrintableString(executable) );
+    fprintf( stderr, "jobs            : %u\n", jobs );
     fprintf( stderr, "merged coverage : %s\n",
              PrintableString(mergedCoverageFile) );
     fprintf( stderr, "\n" );
@@ -344,201 +218,151 @@ int main(
     exit(-1);
   }
 
-  /*
-   *  Create toolnames based on target
-   */
-  targetInfo = Target::TargetFactory( target );
-
-  /*
-   *  Create a ranges set
-   */
-  Ranges = new Coverage::CoverageRanges();
-  Explanations = new Coverage::Explanations();
-
-  Explanations->load( explanations );
+  try
+  {
+    std::shared_ptr<Target::TargetBase> targetInfo;
+    Coverage::DesiredSymbols            symbolsToAnalyze;
+    std::vector<std::string>            coverageFiles( argv + optind, argv + argc );
+    size_t                              groups;
+    size_t                              step;
 
-  /*
-   * Create coverage map
-   */
-  CoverageMap = new Coverage::CoverageMap( lowAddress, highAddress );
-  if ( !CoverageMap ) {
-    fprintf( stderr, "Unable to create coverage map.\n\n" );
-    exit(-1);
-  }
+    coverageFormat = Coverage::CoverageFormatToEnum( format );
 
-  /*
-   * Create input
-   */
-  CoverageReader = Coverage::CreateCoverageReader(coverageFormat);
-  if ( !CoverageReader ) {
-    fprintf( stderr, "Unable to create coverage file reader.\n\n" );
-    exit(-1);
-  }
+    /*
+     * QEMU traces need the instructions of an executable so only the
+     * bitmap formats can be merged.
+     */
+    if ( coverageFormat == Coverage::COVERAGE_FORMAT_QEMU ) {
+      fprintf( stderr, "coverage format must be RTEMS, TSIM or Skyeye.\n\n" );
+      usage();
+      exit(-1);
+    }
 
-  CoverageReader.setTargetInfo( targetInfo );
+    /*
+     *  Create toolnames based on target
+     */
+    targetInfo.reset( Target::TargetFactory( target ) );
 
-  /*
-   * Create the objdump processor
-   */
-  ObjdumpProcessor = new Coverage::ObjdumpProcessor();
+    /*
+     * Split the coverage files into a group for each job. Each group is
+     * read by its own reader into its own coverage map of the range so the
+     * groups can be read at the same time.
+     */
+    groups = std::max(
+      std::min( (size_t) jobs, coverageFiles.size() ), (size_t) 1
+    );
 
-  ObjdumpProcessor->setTargetInfo( targetInfo );
+    std::vector<std::unique_ptr<Coverage::ExecutableInfo>>     ranges( groups );
+    std::vector<std::unique_ptr<Coverage::CoverageReaderBase>> readers( groups );
 
-  /*
-   * Create writer
-   *
-   * NOTE: We ALWAYS write the merged coverage in RTEMS format.
-   */
-  CoverageWriter = Coverage::CreateCoverageWriter(
-    Coverage::COVERAGE_FORMAT_RTEMS
-  );
-  if ( !CoverageWriter ) {
-    fprintf( stderr, "Unable to create coverage file writer.\n\n" );
-    exit(-1);
-  }
+    for ( size_t g = 0; g < groups; g++ ) {
+      ranges[g].reset(
+        new Coverage::ExecutableInfo(
+          "merge", lowAddress, highAddress, symbolsToAnalyze
+        )
+      );
+      readers[g].reset( Coverage::CreateCoverageReader( coverageFormat ) );
+      readers[g]->targetInfo_m = targetInfo;
+    }
 
-  /*
-   * Add in the objdump before reading the coverage information.  We may
-   * want to take advantage of the information line where instructions
-   * begin.
-   */
-  if ( executable ) {
+    /*
+     * Now get to some real work
+     */
     if ( verbose )
-      fprintf( stderr, "Reading objdump of %s\n", executable );
-    ObjdumpProcessor->initialize( executable, CoverageMap );
-  }
+      fprintf( stderr, "Processing coverage files\n" );
 
-  /*
-   * Now get to some real work
-   */
-  if ( verbose )
-    fprintf( stderr, "Processing coverage files\n" );
-  for ( i=optind ; i < argc ; i++ ) {
-    //fprintf( stderr, "Processing %s\n", argv[i] );
-    CoverageReader->ProcessFile( argv[i], CoverageMap );
-  }
+    rld::threads::parallel_for(
+      groups,
+      jobs,
+      [&]( size_t g ) {
+        size_t first = ( coverageFiles.size() * g ) / groups;
+        size_t last = ( coverageFiles.size() * ( g + 1 ) ) / groups;
 
-  /*
-   * Now to write some output
-   */
-  if ( mergedCoverageFile ) {
-    if ( verbose )
-      fprintf(
-        stderr,
-        "Writing merged coverage file (%s)\n",
-        mergedCoverageFile
-      );
-    CoverageWriter->writeFile(
-      mergedCoverageFile,
-      CoverageMap,
-      lowAddress,
-      highAddress
+        for ( size_t f = first; f < last; f++ ) {
+          readers[g]->processFile( coverageFiles[f], ranges[g].get() );
+        }
+      }
     );
-  }
-
-  /*
-   *  Marks nops as executed when they are surrounded by executed instructions.
-   */
-  ObjdumpProcessor->markNopsAsExecuted( CoverageMap );
-
-  /*
-   * Iterate over the coverage map and determine the uncovered
-   * ranges and branches.
-   */
-  ComputeUncovered();
-
-  /*
-   *  Look up the source file and line number for the addresses
-   *  of interest.
-   */
-  FindSourceForAddresses();
-
-  /*
-   *  Generate report of ranges not executed
-   */
-  if ( coverageReportFile ) {
-    if ( verbose )
-      fprintf( stderr, "Writing coverage report (%s)\n", coverageReportFile );
-    WriteCoverageReport( coverageReportFile );
 
     /*
-     *  Let the user know how many cases there were
+     * Merge the coverage maps of the groups in pairs until the first one
+     * holds all of the coverage.
      */
-    printf( "%d uncovered ranges found\n", UncoveredRanges );
-  }
+    for ( step = 1; step < groups; step *= 2 ) {
+      rld::threads::parallel_for(
+        ( groups + ( 2 * step ) - 1 ) / ( 2 * step ),
+        jobs,
+        [&]( size_t p ) {
+          size_t g = p * 2 * step;
+
+          if ( g + step < groups ) {
+            MergeCoverageMap(
+              ranges[g]->getCoverageMap( lowAddress ),
+              ranges[g + step]->getCoverageMap( lowAddress )
+            );
+          }
+        }
+      );
+    }
 
-  /*
-   *  Generate report of branches taken/not taken
-   */
-  if ( branchReportFile ) {
-    if ( verbose )
-      fprintf( stderr, "Writing branch report (%s)\n", branchReportFile );
-    WriteBranchReport( branchReportFile, lowAddress, highAddress );
+    Coverage::CoverageMapBase* coverageMap =
+      ranges[0]->getCoverageMap( lowAddress );
 
     /*
-     *  Let the user know how many branch cases were found
+     * Now to write some output
+     *
+     * NOTE: We ALWAYS write the merged coverage in RTEMS format.
      */
-    if (!BranchesFound)
-      printf( "No branch information found\n" );
-    else {
-      printf(
-        "%d uncovered branches found\n",
-        BranchesAlwaysTaken + BranchesNeverTaken
-      );
-      printf(
-        "   %d branches always taken\n", BranchesAlwaysTaken
+    if ( mergedCoverageFile ) {
+      std::unique_ptr<Coverage::CoverageWriterBase> coverageWriter(
+        Coverage::CreateCoverageWriter( Coverage::COVERAGE_FORMAT_RTEMS )
       );
-      printf(
-        "   %d branches never taken\n", BranchesNeverTaken
+
+      if ( verbose )
+        fprintf(
+          stderr,
+          "Writing merged coverage file (%s)\n",
+          mergedCoverageFile
+        );
+      coverageWriter->writeFile(
+        mergedCoverageFile,
+        coverageMap,
+        lowAddress,
+        highAddress
       );
     }
-  }
 
-  /*
-   *  Simple formatted report of size of ranges
-   */
-  if ( sizeReportFile ) {
-    if ( verbose )
-      fprintf( stderr, "Writing size report (%s)\n", sizeReportFile );
-    WriteSizeReport( sizeReportFile );
-  }
-
-  /*
-   *  Generate annotated assembly file
-   */
-  if ( verbose )
-    fprintf( stderr, "Writing annotated report (%s)\n", "annotated.txt" );
-  WriteAnnotatedReport( "annotated.txt", lowAddress, highAddress );
-
-  /*
-   * write explanations that were not found
-   */
-  std::string str = explanations;
-  str = str + ".NotFound";
-  if ( verbose )
-    fprintf( stderr, "Writing Not Found Report (%s)\n", str.c_str() );
-  Explanations->writeNotFound(str.c_str());
-
-  /*
-   * Calculate coverage percentage
-   */
-  {
-    uint32_t a;
-    uint32_t notExecuted = 0;
-    double   percentage;
+    /*
+     * Calculate coverage percentage
+     */
+    {
+      uint32_t a;
+      uint32_t notExecuted = 0;
+      double   percentage;
+
+      for ( a=lowAddress ; a < highAddress ; a++ ) {
+        if ( !coverageMap->wasExecuted( a ) )
+          notExecuted++;
+      }
 
-    for ( a=lowAddress ; a < highAddress ; a++ ) {
-      if ( !CoverageMap->wasExecuted( a ) )
-        notExecuted++;
+      percentage = (double) notExecuted;
+      percentage /= (double) (highAddress - lowAddress);
+      percentage *= 100.0;
+      printf( "Bytes Analyzed          : %d\n", highAddress - lowAddress );
+      printf( "Bytes Not Executed      : %d\n", notExecuted );
+      printf( "Percentage Executed     : %5.4g\n", 100.0 - percentage  );
+      printf( "Percentage Not Executed : %5.4g\n", percentage  );
     }
-
-    percentage = (double) notExecuted;
-    percentage /= (double) (highAddress - lowAddress);
-    percentage *= 100.0;
-    printf( "Bytes Analyzed          : %d\n", highAddress - lowAddress );
-    printf( "Bytes Not Executed      : %d\n", notExecuted );
-    printf( "Percentage Executed     : %5.4g\n", 100.0 - percentage  );
-    printf( "Percentage Not Executed : %5.4g\n", percentage  );
+  }
+  catch ( rld::error re )
+  {
+    fprintf(
+      stderr,
+      "error: %s: %s\n",
+      re.where.c_str(),
+      re.what.c_str()
+    );
+    return 10;
   }
 
   return 0;
@@ -5,6 +5,7 @@
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <getopt.h>
 #include <limits.h>
 #include <signal.h>
 #include <stdio.h>
@@ -15,10 +16,15 @@
 #include <unistd.h>
 
 #include <list>
+#include <memory>
+#include <vector>
 
 #include <rld.h>
 #include <rld-process.h>
+#include <rld-threads.h>
 
+#include "AnalysisCache.h"
+#include "CoverageDatabase.h"
 #include "CoverageFactory.h"
 #include "CoverageMap.h"
 #include "DesiredSymbols.h"
@@ -39,8 +45,6 @@
   #define kill( p,s ) raise( s )
 #endif
 
-#define MAX_LINE_LENGTH 512
-
 typedef std::list<std::string>               CoverageNames;
 typedef std::list<Coverage::ExecutableInfo*> Executables;
 typedef std::string                          OptionError;
@@ -162,10 +166,13 @@ static void createBuildPath(
 void usage( const std::string& progname )
 {
   std::cerr << "Usage: " << progname
-            << " [-v] -T TARGET -f FORMAT [-E EXPLANATIONS] -1 EXECUTABLE coverage1 ... coverageN" << std::endl
+            << " [-v] [-j JOBS] [-k CACHE_DIR] [-D DATABASE] -T TARGET -f FORMAT [-E EXPLANATIONS] -1 EXECUTABLE coverage1 ... coverageN" << std::endl
+            << "--OR--" << std::endl
+            << "Usage: " << progname
+            << " [-v] [-j JOBS] [-k CACHE_DIR] [-D DATABASE] -T TARGET -f FORMAT [-E EXPLANATIONS] -e EXE_EXTENSION -c COVERAGEFILE_EXTENSION EXECUTABLE1 ... EXECUTABLE2" << std::endl
             << "--OR--" << std::endl
             << "Usage: " << progname
-            << " [-v] -T TARGET -f FORMAT [-E EXPLANATIONS] -e EXE_EXTENSION -c COVERAGEFILE_EXTENSION EXECUTABLE1 ... EXECUTABLE2" << std::endl
+            << " [-v] [-j JOBS] [-k CACHE_DIR] -R -D DATABASE -T TARGET [-E EXPLANATIONS]" << std::endl
             << std::endl
             << "  -v                        - verbose at initialization" << std::endl
             << "  -T TARGET                 - target name" << std::endl
@@ -180,6 +187,10 @@ void usage( const std::string& progname )
             << "  -C ConfigurationFileName  - name of configuration file" << std::endl
             << "  -O Output_Directory       - name of output directory (default=." << std::endl
             << "  -d debug                  - disable cleaning of tempfile" << std::endl
+            << "  -j JOBS                   - number of executables to process at once" << std::endl
+            << "  -k, --cache CACHE_DIR     - directory of the analysis cache" << std::endl
+            << "  -D, --db DATABASE         - coverage database to add the coverage to" << std::endl
+            << "  -R, --report              - report the coverage database without coverage files" << std::endl
             << std::endl;
 }
 
@@ -200,14 +211,16 @@ int covoar( int argc, char** argv )
   std::string                   format = "QEMU";
   std::ifstream                 gcnosFile;
   std::string                   singleExecutable;
-  rld::process::tempfile        objdumpFile( ".dmp" );
-  rld::process::tempfile        err( ".err" );
   rld::process::tempfile        syms( ".syms" );
   bool                          debug = false;
+  unsigned int                  jobs = 1;
+  std::string                   cacheDirectory;
+  std::string                   databaseFile;
+  bool                          reportDatabase = false;
+  char*                         end;
   std::string                   symbolSet;
   std::string                   option;
   int                           opt;
-  char                          inputBuffer[MAX_LINE_LENGTH];
   Coverage::Explanations        allExplanations;
   bool                          verbose = false;
   std::string                   dynamicLibrary;
@@ -220,7 +233,18 @@ int covoar( int argc, char** argv )
   // Process command line options.
   //
 
-  while ( (opt = getopt( argc, argv, "1:L:e:c:g:E:f:s:S:T:O:p:vd" )) != -1 ) {
+  static struct option long_opts[] = {
+    { "cache",  required_argument, NULL, 'k' },
+    { "db",     required_argument, NULL, 'D' },
+    { "report", no_argument,       NULL, 'R' },
+    { NULL,     0,                 NULL, 0 }
+  };
+
+  while (
+    (opt = getopt_long(
+      argc, argv, "1:L:e:c:g:E:f:s:S:T:O:p:j:k:D:Rvd", long_opts, NULL
+    )) != -1
+  ) {
     switch ( opt ) {
       case '1': singleExecutable    = optarg; break;
       case 'L': dynamicLibrary      = optarg; break;
@@ -236,6 +260,15 @@ int covoar( int argc, char** argv )
                 rld::verbose_inc ();          break;
       case 'p': projectName         = optarg; break;
       case 'd': debug               = true;   break;
+      case 'k': cacheDirectory      = optarg; break;
+      case 'D': databaseFile        = optarg; break;
+      case 'R': reportDatabase      = true;   break;
+      case 'j':
+        jobs = ::strtoul( optarg, &end, 10 );
+        if ( *end != '\0' || jobs == 0 ) {
+          throw OptionError( "jobs -j" );
+        }
+        break;
       default: /* '?' */
         throw OptionError( "unknown option" );
     }
@@ -266,6 +299,22 @@ int covoar( int argc, char** argv )
     throw OptionError( "project name -p" );
   }
 
+  /*
+   * A report of the coverage database only needs the database.
+   */
+  if ( reportDatabase ) {
+    if ( databaseFile.empty() ) {
+      throw OptionError( "coverage database -D" );
+    }
+
+    if ( !singleExecutable.empty() || ( optind < argc ) ) {
+      throw rld::error(
+        "No executables or coverage files are reported with -R",
+        "covoar"
+      );
+    }
+  }
+
   //
   // Find the top of the BSP's build tree and if we have found the top
   // check the executable is under the same path and BSP.
@@ -321,14 +370,24 @@ int covoar( int argc, char** argv )
 
   Coverage::ObjdumpProcessor objdumpProcessor( symbolsToAnalyze, targetInfo );
 
+  // Create the analysis cache if a directory was specified.
+  std::unique_ptr<Coverage::AnalysisCache> analysisCache;
+  if ( !cacheDirectory.empty() ) {
+    analysisCache.reset(
+      new Coverage::AnalysisCache( cacheDirectory, buildTarget )
+    );
+  }
+
   //
   // Read symbol configuration file and load needed symbols.
   //
-  symbolsToAnalyze.load( symbolSet, buildTarget, buildBSP, verbose );
+  symbolsToAnalyze.load( symbolSet, buildTarget, buildBSP, verbose, jobs );
 
   // If a single executable was specified, process the remaining
   // arguments as coverage file names.
-  if ( !singleExecutable.empty() ) {
+  if ( reportDatabase ) {
+    // Only the executables of the coverage database are analyzed.
+  } else if ( !singleExecutable.empty() ) {
     // Ensure that the executable is readable.
     if ( !FileIsReadable( singleExecutable ) ) {
       std::cerr << "warning: Unable to read executable: " << singleExecutable
@@ -352,14 +411,16 @@ int covoar( int argc, char** argv )
             singleExecutable.c_str(),
             dynamicLibrary,
             verbose,
-            symbolsToAnalyze
+            symbolsToAnalyze,
+            analysisCache.get()
           );
         } else {
           executableInfo = new Coverage::ExecutableInfo(
             singleExecutable.c_str(),
             "",
             verbose,
-            symbolsToAnalyze
+            symbolsToAnalyze,
+            analysisCache.get()
           );
         }
 
@@ -386,7 +447,8 @@ int covoar( int argc, char** argv )
             argv[i],
             "",
             verbose,
-            symbolsToAnalyze
+            symbolsToAnalyze,
+            analysisCache.get()
           );
           executablesToAnalyze.push_back( executableInfo );
           coverageFileNames.push_back( coverageFileName );
@@ -395,11 +457,6 @@ int covoar( int argc, char** argv )
     }
   }
 
-  // Ensure that there is at least one executable to process.
-  if ( executablesToAnalyze.empty() ) {
-    throw rld::error( "No information to analyze", "covoar" );
-  }
-
   // The executablesToAnalyze and coverageFileNames containers need
   // to be the name size of some of the code below breaks. Lets
   // check and make sure.
@@ -410,6 +467,59 @@ int covoar( int argc, char** argv )
     );
   }
 
+  // The symbols held in the coverage database which are not in the
+  // executables of this run are analyzed from the executables they were
+  // added from so all the symbols of the database are reported. These
+  // executables have no coverage file. The database is only read here and
+  // a report keeps it locked against updates until its counts are added.
+  std::unique_ptr<Coverage::CoverageDatabase> reportedDatabase;
+
+  if (
+    !databaseFile.empty() &&
+    dynamicLibrary.empty() &&
+    ( reportDatabase || FileIsReadable( databaseFile ) )
+  ) {
+    std::unique_ptr<Coverage::CoverageDatabase> database(
+      new Coverage::CoverageDatabase( databaseFile, buildTarget, true )
+    );
+    std::vector<std::string> missing;
+
+    database->getExecutables(
+      symbolsToAnalyze,
+      std::vector<Coverage::ExecutableInfo*>(
+        executablesToAnalyze.begin(),
+        executablesToAnalyze.end()
+      ),
+      missing
+    );
+
+    for ( const auto& exe : missing ) {
+      if ( !FileIsReadable( exe ) ) {
+        std::cerr << "warning: Unable to read executable: " << exe
+                  << std::endl;
+      } else {
+        executablesToAnalyze.push_back(
+          new Coverage::ExecutableInfo(
+            exe.c_str(),
+            "",
+            verbose,
+            symbolsToAnalyze,
+            analysisCache.get()
+          )
+        );
+      }
+    }
+
+    if ( reportDatabase ) {
+      reportedDatabase = std::move( database );
+    }
+  }
+
+  // Ensure that there is at least one executable to process.
+  if ( executablesToAnalyze.empty() ) {
+    throw rld::error( "No information to analyze", "covoar" );
+  }
+
   if ( verbose ) {
     std::cerr << "Analyzing " << symbolsToAnalyze.allSymbols().size()
               << " symbols" << std::endl;
@@ -420,56 +530,144 @@ int covoar( int argc, char** argv )
     allExplanations.load( explanations.c_str() );
   }
 
-  // Create coverage map reader.
+  // Check a coverage map reader can be created for the format.
   coverageFormat = Coverage::CoverageFormatToEnum( format );
   coverageReader = Coverage::CreateCoverageReader( coverageFormat );
   if ( !coverageReader ) {
     throw rld::error( "Unable to create coverage file reader", "covoar" );
   }
 
-  coverageReader->targetInfo_m = targetInfo;
+  delete coverageReader;
+
+  // The executables are processed by up to the number of jobs at once. The
+  // results are added to the desired symbols in the executable order so the
+  // output does not depend on the number of jobs.
+  std::vector<Coverage::ExecutableInfo*> executables(
+    executablesToAnalyze.begin(),
+    executablesToAnalyze.end()
+  );
+  std::vector<std::string> coverageFiles(
+    coverageFileNames.begin(),
+    coverageFileNames.end()
+  );
+  std::vector<Coverage::ObjdumpProcessor::objdumpSymbols_t> objdumpSymbols(
+    executables.size()
+  );
+
+  // Executables linked with the same objects hold identical code. Each
+  // identical body is only dumped for the first executable holding it.
+  objdumpProcessor.shareBodies( executables );
 
   // Prepare each executable for analysis.
-  for ( auto& exe : executablesToAnalyze ) {
-    if ( verbose ) {
-      std::cerr << "Extracting information from: " << exe->getFileName()
-                << std::endl;
-    }
+  rld::threads::parallel_for(
+    executables.size(),
+    jobs,
+    [&]( size_t e ) {
+      Coverage::ExecutableInfo* exe = executables[e];
+      rld::process::tempfile    err( ".err", debug );
+
+      // If a dynamic library was specified, determine the load address.
+      if ( !dynamicLibrary.empty() ) {
+        exe->setLoadAddress( objdumpProcessor.determineLoadAddress( exe ) );
+      }
 
-    // If a dynamic library was specified, determine the load address.
-    if ( !dynamicLibrary.empty() ) {
-      exe->setLoadAddress( objdumpProcessor.determineLoadAddress( exe ) );
-    }
+      // Load the objdump for the symbols in this executable. In debug mode
+      // the objdump output is also kept in a file.
+      if ( debug ) {
+        rld::process::tempfile objdumpFile( ".dmp", true );
+        objdumpProcessor.parse( exe, &objdumpFile, err, objdumpSymbols[e] );
+      } else {
+        objdumpProcessor.parse( exe, nullptr, err, objdumpSymbols[e] );
+      }
+    },
+    [&]( size_t e ) {
+      if ( verbose ) {
+        std::cerr << "Extracting information from: "
+                  << executables[e]->getFileName() << std::endl;
+      }
 
-    // Load the objdump for the symbols in this executable.
-    objdumpProcessor.load( exe, objdumpFile, err, verbose );
-  }
+      objdumpProcessor.commit( executables[e], objdumpSymbols[e], verbose );
+    }
+  );
 
   //
   // Analyze the coverage data.
   //
 
-  // Process each executable/coverage file pair.
-  Executables::iterator eitr = executablesToAnalyze.begin();
-  for ( const auto& cname : coverageFileNames ) {
-    Coverage::ExecutableInfo* exe = *eitr;
+  // Process each executable/coverage file pair. Each job has its own reader.
+  // The executables of the coverage database follow the pairs.
+  std::vector<std::unique_ptr<Coverage::CoverageReaderBase>> readers(
+    coverageFiles.size()
+  );
+
+  rld::threads::parallel_for(
+    coverageFiles.size(),
+    jobs,
+    [&]( size_t e ) {
+      readers[e].reset( Coverage::CreateCoverageReader( coverageFormat ) );
+      readers[e]->targetInfo_m = targetInfo;
+
+      // Process its coverage file.
+      readers[e]->processFile( coverageFiles[e].c_str(), executables[e] );
+    },
+    [&]( size_t e ) {
+      Coverage::ExecutableInfo* exe = executables[e];
+      if ( verbose ) {
+        std::cerr << "Processing coverage file " << coverageFiles[e]
+                  << " for executable " << exe->getFileName()
+                  << std::endl;
+      }
+
+      // Merge each symbols coverage map into a unified coverage map.
+      exe->mergeCoverage();
+
+      if ( readers[e]->getBranchInfoAvailable() ) {
+        branchInfoAvailable = true;
+      }
+
+      readers[e].reset();
+
+      // DEBUG Print ExecutableInfo content
+      //exe->dumpExecutableInfo();
+    }
+  );
+
+  // The executables of the coverage database have no coverage of their own
+  // but the instructions of their symbols are merged.
+  for ( size_t e = coverageFiles.size(); e < executables.size(); ++e ) {
+    executables[e]->mergeCoverage();
+  }
+
+  // Add the coverage of the earlier runs held in the coverage database and
+  // save the totals back to it. A report only adds the coverage.
+  if ( reportedDatabase ) {
+    if ( reportedDatabase->addTo( symbolsToAnalyze, verbose ) ) {
+      branchInfoAvailable = true;
+    }
+
     if ( verbose ) {
-      std::cerr << "Processing coverage file " << cname
-                << " for executable " << exe->getFileName()
+      std::cerr << "Coverage database " << databaseFile << " holds "
+                << reportedDatabase->getRuns() << " coverage files"
                 << std::endl;
     }
 
-    // Process its coverage file.
-    coverageReader->processFile( cname.c_str(), exe );
+    reportedDatabase.reset();
+  } else if ( !databaseFile.empty() ) {
+    Coverage::CoverageDatabase database( databaseFile, buildTarget );
 
-    // Merge each symbols coverage map into a unified coverage map.
-    exe->mergeCoverage();
+    if ( database.addTo( symbolsToAnalyze, verbose ) ) {
+      branchInfoAvailable = true;
+    }
 
-    // DEBUG Print ExecutableInfo content
-    //exe->dumpExecutableInfo();
+    database.save(
+      symbolsToAnalyze,
+      branchInfoAvailable,
+      coverageFiles.size()
+    );
 
-    if ( singleExecutable.empty() ) {
-      eitr++;
+    if ( verbose ) {
+      std::cerr << "Coverage database " << databaseFile << " holds "
+                << database.getRuns() << " coverage files" << std::endl;
     }
   }
 
@@ -493,23 +691,34 @@ int covoar( int argc, char** argv )
     if ( !gcnosFile ) {
       std::cerr << "Unable to open " << gcnosFileName << std::endl;
     } else {
-      while ( gcnosFile >> inputBuffer ) {
-        Gcov::GcovData gcovFile( symbolsToAnalyze );
-        //gcovFile = new Gcov::GcovData( symbolsToAnalyze );
-        gcnoFileName = inputBuffer;
+      std::vector<std::string> gcnoFileNames;
 
-        if ( verbose ) {
-          std::cerr << "Processing file: " << gcnoFileName << std::endl;
-        }
+      while ( gcnosFile >> gcnoFileName ) {
+        gcnoFileNames.push_back( gcnoFileName );
+      }
 
-        if ( gcovFile.readGcnoFile( gcnoFileName ) ) {
-          // Those need to be in this order
-          gcovFile.processCounters();
-          gcovFile.writeReportFile();
-          gcovFile.writeGcdaFile();
-          gcovFile.writeGcovFile();
+      // Each notes file is independent so they are processed by up to the
+      // number of jobs at once.
+      rld::threads::parallel_for(
+        gcnoFileNames.size(),
+        jobs,
+        [&]( size_t g ) {
+          Gcov::GcovData gcovFile( symbolsToAnalyze );
+
+          if ( gcovFile.readGcnoFile( gcnoFileNames[ g ] ) ) {
+            // Those need to be in this order
+            gcovFile.processCounters();
+            gcovFile.writeReportFile();
+            gcovFile.writeGcdaFile();
+            gcovFile.writeGcovFile();
+          }
+        },
+        [&]( size_t g ) {
+          if ( verbose ) {
+            std::cerr << "Processing file: " << gcnoFileNames[ g ] << std::endl;
+          }
         }
-      }
+      );
 
       gcnosFile.close();
     }
@@ -520,14 +729,14 @@ int covoar( int argc, char** argv )
     std::cerr << "Computing uncovered ranges and branches" << std::endl;
   }
 
-  symbolsToAnalyze.computeUncovered( verbose );
+  symbolsToAnalyze.computeUncovered( verbose, jobs );
 
   // Calculate remainder of statistics.
   if ( verbose ) {
     std::cerr << "Calculate statistics" << std::endl;
   }
 
-  symbolsToAnalyze.calculateStatistics();
+  symbolsToAnalyze.calculateStatistics( jobs );
 
   // Look up the source lines for any uncovered ranges and branches.
   if ( verbose ) {
@@ -544,19 +753,15 @@ int covoar( int argc, char** argv )
     std::cerr << "Generate Reports" << std::endl;
   }
 
-  for ( const auto& setName : symbolsToAnalyze.getSetNames() ) {
-    branchInfoAvailable = coverageReader->getBranchInfoAvailable();
-
-    Coverage::GenerateReports(
-      setName,
-      allExplanations,
-      verbose,
-      projectName,
-      outputDirectory,
-      symbolsToAnalyze,
-      branchInfoAvailable
-    );
-  }
+  Coverage::GenerateReports(
+    allExplanations,
+    verbose,
+    projectName,
+    outputDirectory,
+    symbolsToAnalyze,
+    branchInfoAvailable,
+    jobs
+  );
 
   // Write explanations that were not found.
   if ( !explanations.empty() ) {
@@ -572,10 +777,6 @@ int covoar( int argc, char** argv )
 
   //Leave tempfiles around if debug flag (-d) is enabled.
   if ( debug ) {
-    objdumpFile.override( "objdump_file" );
-    objdumpFile.keep();
-    err.override( "objdump_exec_log" );
-    err.keep();
     syms.override( "symbols_list" );
     syms.keep();
   }